@@ -37,49 +37,24 @@ www.navitia.io
 namespace navitia {
 namespace autocomplete {
 
-static void compute_score_poi(georef::GeoRef& georef) {
-    for (auto it = georef.fl_poi.word_quality_list.begin(); it != georef.fl_poi.word_quality_list.end(); ++it) {
-        for (navitia::georef::Admin* admin : georef.pois[it->first]->admin_list) {
-            if (admin->level == 8) {
-                it->second.score = georef.fl_admin.word_quality_list.at(admin->idx).score;
-            }
-        }
-    }
-}
-
-static void compute_score_way(georef::GeoRef& georef) {
-    // The scocre of each admin(level 8) is attributed to all its ways
-    for (auto it = georef.fl_way.word_quality_list.begin(); it != georef.fl_way.word_quality_list.end(); ++it) {
-        for (navitia::georef::Admin* admin : georef.ways[it->first]->admin_list) {
-            if (admin->level == 8) {
-                it->second.score = georef.fl_admin.word_quality_list.at(admin->idx).score;
-            }
+int admin_list_score(const std::vector<georef::Admin*>& admins, const type::PT_Data& pt_data) {
+    for (const auto* admin : admins) {
+        if (admin->level == 8) {
+            const auto it = pt_data.admin_autocomplete_scores.find(admin->idx);
+            return it == pt_data.admin_autocomplete_scores.end() ? 0 : it->second;
         }
     }
+    return 0;
 }
 
-static void compute_score_stop_point(type::PT_Data& pt_data, georef::GeoRef& georef) {
+static void compute_score_stop_point(type::PT_Data& pt_data) {
     // The scocre of each admin(level 8) is attributed to all its stop_points
-    for (auto it = pt_data.stop_point_autocomplete.word_quality_list.begin();
-         it != pt_data.stop_point_autocomplete.word_quality_list.end(); ++it) {
-        for (navitia::georef::Admin* admin : pt_data.stop_points[it->first]->admin_list) {
-            if (admin->level == 8) {
-                it->second.score = georef.fl_admin.word_quality_list.at(admin->idx).score;
-            }
-        }
-    }
-}
-
-static size_t admin_score(const std::vector<navitia::georef::Admin*>& admins, const georef::GeoRef& georef) {
-    for (const auto* admin : admins) {
-        if (admin->level == 8) {
-            return georef.fl_admin.word_quality_list.at(admin->idx).score;
-        }
+    for (auto& it : pt_data.stop_point_autocomplete.word_quality_list) {
+        it.second.score = admin_list_score(pt_data.stop_points[it.first]->admin_list, pt_data);
     }
-    return 0;
 }
 
-static void compute_score_stop_area(type::PT_Data& pt_data, const georef::GeoRef& georef) {
+static void compute_score_stop_area(type::PT_Data& pt_data) {
     // The scocre of each admin(level 8) is attributed to all its stop_areas also
     // Find the stop-point count in all stop_areas and keep the highest;
     size_t max_score = 0;
@@ -91,7 +66,7 @@ static void compute_score_stop_area(type::PT_Data& pt_data, const georef::GeoRef
     // Ajust the score of each stop_area from 0 to 100 using maximum score (max_score)
     if (max_score > 0) {
         for (auto& it : pt_data.stop_area_autocomplete.word_quality_list) {
-            const size_t ad_score = admin_score(pt_data.stop_areas[it.first]->admin_list, georef);
+            const size_t ad_score = admin_list_score(pt_data.stop_areas[it.first]->admin_list, pt_data);
             it.second.score = ad_score + (pt_data.stop_areas[it.first]->stop_point_list.size() * 100) / max_score;
         }
     }
@@ -108,53 +83,54 @@ static void compute_score_stop_area(type::PT_Data& pt_data, const georef::GeoRef
  Pouzioux   1                   11
  Pampa      0                   7
 */
-static void compute_score_admin(type::PT_Data& pt_data, georef::GeoRef& georef) {
+static void compute_score_admin(type::PT_Data& pt_data, const georef::GeoRef& georef) {
+    auto& scores = pt_data.admin_autocomplete_scores;
+    scores.clear();
+    for (const auto& it : georef.fl_admin.word_quality_list) {
+        scores[it.first] = 0;
+    }
     // For each stop_point increase the score of it's admin(level 8) by 1.
     for (navitia::georef::Way* way : georef.ways) {
         for (navitia::georef::Admin* admin : way->admin_list) {
             if (admin->level == 8) {
-                georef.fl_admin.word_quality_list.at(admin->idx).score++;
+                scores.at(admin->idx)++;
             }
         }
     }
     std::set<navitia::georef::Admin*> without_way_admins;
     for (auto admin : georef.admins) {
-        if (admin->level == 8 && georef.fl_admin.word_quality_list.at(admin->idx).score == 0) {
+        if (admin->level == 8 && scores.at(admin->idx) == 0) {
             without_way_admins.insert(admin);
         }
     }
     for (navitia::type::StopPoint* sp : pt_data.stop_points) {
         for (navitia::georef::Admin* admin : sp->admin_list) {
             if (admin->level == 8 && without_way_admins.count(admin) > 0) {
-                georef.fl_admin.word_quality_list.at(admin->idx).score++;
+                scores.at(admin->idx)++;
             }
         }
     }
 
     // Ajust the score of each admin using natural logarithm as : log(n+2)*10
-    for (auto& it : georef.fl_admin.word_quality_list) {
-        it.second.score = log(it.second.score + 2) * 10;
+    for (auto& it : scores) {
+        it.second = log(it.second + 2) * 10;
     }
 }
 
 template <typename T>
-void Autocomplete<T>::compute_score(type::PT_Data& pt_data, georef::GeoRef& georef, const type::Type_e type) {
+void Autocomplete<T>::compute_score(type::PT_Data& pt_data,
+                                    const georef::GeoRef& georef,
+                                    const type::Type_e type) const {
     switch (type) {
         case type::Type_e::StopArea:
-            compute_score_stop_area(pt_data, georef);
+            compute_score_stop_area(pt_data);
             break;
         case type::Type_e::StopPoint:
-            compute_score_stop_point(pt_data, georef);
+            compute_score_stop_point(pt_data);
             break;
         case type::Type_e::Admin:
             compute_score_admin(pt_data, georef);
             break;
-        case type::Type_e::Way:
-            compute_score_way(georef);
-            break;
-        case type::Type_e::POI:
-            compute_score_poi(georef);
-            break;
         default:
             break;
     }
@@ -42,6 +42,7 @@ www.navitia.io
 #include <boost/serialization/map.hpp>
 
 #include <algorithm>
+#include <functional>
 #include <boost/regex.hpp>
 #include <map>
 #include <unordered_map>
@@ -62,6 +63,10 @@ struct Compare {
 
 std::pair<size_t, size_t> longest_common_substring(const std::string&, const std::string&);
 
+/// absolute score of an object in these admins: the score of its admin of level 8 (see
+/// PT_Data::admin_autocomplete_scores). Computed at lookup for the ways and the pois, far too many to be stored
+int admin_list_score(const std::vector<georef::Admin*>& admins, const type::PT_Data& pt_data);
+
 using autocomplete_map = std::map<std::string, std::string, Compare>;
 /** Map de type Autocomplete
  *
@@ -72,6 +77,9 @@ using autocomplete_map = std::map<std::string, std::string, Compare>;
  */
 template <class T>
 struct Autocomplete {
+    /// absolute score of an element, when it is not the one stored in the autocomplete
+    using Scores = std::function<int(T)>;
+
     /// struct that contains the position of the word in the autocomplete and the number of match
     struct fl_quality {
         T idx = 0;
@@ -221,7 +229,9 @@ struct Autocomplete {
     }
 
     // Méthode pour calculer le score de chaque élément par son admin.
-    void compute_score(type::PT_Data& pt_data, georef::GeoRef& georef, const type::Type_e type);
+    // The scores of the admins are written in the pt_data (see PT_Data::admin_autocomplete_scores), the ones of the
+    // ways and the pois are computed at lookup (see admin_list_score)
+    void compute_score(type::PT_Data& pt_data, const georef::GeoRef& georef, const type::Type_e type) const;
     // Méthodes premettant de retrouver nos éléments
     /** Définit un fonctor permettant de parcourir notre structure un peu particulière */
     struct comp {
@@ -333,9 +343,12 @@ struct Autocomplete {
      * the scores are compared lexicographicaly
      * @param str: string to search
      * @param position: element to score
+     * @param scores: absolute scores of the elements when they are not stored in the autocomplete
      */
-    std::tuple<int, size_t, int> compute_result_scores(const std::string& str, T position) const {
-        auto global_score = word_quality_list.at(position).score;
+    std::tuple<int, size_t, int> compute_result_scores(const std::string& str,
+                                                       T position,
+                                                       const Scores& scores = nullptr) const {
+        auto global_score = score(position, scores);
 
         const auto& indexed_str = indexed_string.at(position);
         auto lcs_and_pos = longest_common_substring(strip_accents_and_lower(str), indexed_str);
@@ -350,7 +363,8 @@ struct Autocomplete {
     std::vector<fl_quality> find_complete(const std::string& str,
                                           size_t nbmax,
                                           std::function<bool(T)> keep_element,
-                                          const std::set<std::string>& ghostwords) const {
+                                          const std::set<std::string>& ghostwords,
+                                          const Scores& scores = nullptr) const {
         auto vec = tokenize(str, ghostwords);
         int wordLength = 0;
         fl_quality quality;
@@ -367,7 +381,7 @@ struct Autocomplete {
                 quality.idx = i;
                 quality.nb_found = word_quality_list.at(quality.idx).word_count;
                 quality.word_len = wordLength;
-                quality.scores = this->compute_result_scores(str, quality.idx);
+                quality.scores = this->compute_result_scores(str, quality.idx, scores);
 
                 quality.quality = 100;
                 vec_quality.push_back(quality);
@@ -390,7 +404,8 @@ struct Autocomplete {
                                                       const int word_weight,
                                                       size_t nbmax,
                                                       std::function<bool(T)> keep_element,
-                                                      const std::set<std::string>& ghostwords) const {
+                                                      const std::set<std::string>& ghostwords,
+                                                      const Scores& scores = nullptr) const {
         // Map temporaire pour garder les patterns trouvé:
         std::unordered_map<T, fl_quality> fl_result;
 
@@ -427,7 +442,7 @@ struct Autocomplete {
             int max_score = 0;
             for (auto ir : index_result) {
                 if (keep_element(ir)) {
-                    max_score = word_quality_list.at(ir).score > max_score ? word_quality_list.at(ir).score : max_score;
+                    max_score = std::max(max_score, score(ir, scores));
                 }
             }
 
@@ -438,8 +453,8 @@ struct Autocomplete {
                     quality.idx = pair.first;
                     quality.nb_found = pair.second.nb_found;
                     quality.word_len = wordLength;
-                    quality.scores = this->compute_result_scores(str, quality.idx);
-                    quality.quality = calc_quality_pattern(quality, word_weight, max_score, pattern_count);
+                    quality.scores = this->compute_result_scores(str, quality.idx, scores);
+                    quality.quality = calc_quality_pattern(quality, word_weight, max_score, pattern_count, scores);
                     vec_quality.push_back(quality);
                 }
             }
@@ -455,7 +470,11 @@ struct Autocomplete {
         }
     }
 
-    int calc_quality_pattern(const fl_quality& ql, int wordweight, int max_score, int patt_count) const {
+    int calc_quality_pattern(const fl_quality& ql,
+                             int wordweight,
+                             int max_score,
+                             int patt_count,
+                             const Scores& scores = nullptr) const {
         int result = 100;
 
         // Qualité sur le nombres des mot trouvé
@@ -465,10 +484,18 @@ struct Autocomplete {
         result -= abs(word_quality_list.at(ql.idx).word_distance - ql.word_len);  // Coeff de la distance = 1
 
         // Qualité sur le score
-        result -= (max_score - word_quality_list.at(ql.idx).score) / 10;
+        result -= (max_score - score(ql.idx, scores)) / 10;
         return result;
     }
 
+    /// absolute score of an element, taken from scores when they are given
+    int score(T position, const Scores& scores) const {
+        if (!scores) {
+            return word_quality_list.at(position).score;
+        }
+        return scores(position);
+    }
+
     int words_length(std::set<std::string>& words) const {
         int distance = 0;
         auto vec = words.begin();
@@ -171,8 +171,8 @@ static void update_quality(std::vector<Autocomplete<nt::idx_t>::fl_quality>& ac_
 
 static std::unordered_set<std::string> get_main_stop_areas(const navitia::type::Data& d) {
     std::unordered_set<std::string> result;
-    for (const auto& admin : d.geo_ref->admins) {
-        for (const auto& sa : admin->main_stop_areas) {
+    for (const auto& admin_stop_areas : d.pt_data->admin_main_stop_areas) {
+        for (const auto& sa : admin_stop_areas.second) {
             result.insert(sa->uri);
         }
     }
@@ -188,6 +188,17 @@ static std::vector<Autocomplete<nt::idx_t>::fl_quality> complete(const type::Dat
                                                                  float main_stop_area_weight_factor) {
     // TODO Refacto this ...
     std::vector<Autocomplete<nt::idx_t>::fl_quality> result;
+    // the scores of the georef objects depend on the stop points of the data, they are not in the georef
+    const auto admin_scores = [&d](const nt::idx_t idx) {
+        const auto it = d.pt_data->admin_autocomplete_scores.find(idx);
+        return it == d.pt_data->admin_autocomplete_scores.end() ? 0 : it->second;
+    };
+    const auto way_scores = [&d](const nt::idx_t idx) {
+        return admin_list_score(d.geo_ref->ways[idx]->admin_list, *d.pt_data);
+    };
+    const auto poi_scores = [&d](const nt::idx_t idx) {
+        return admin_list_score(d.geo_ref->pois[idx]->admin_list, *d.pt_data);
+    };
     switch (type) {
         case nt::Type_e::StopArea:
             if (search_type == 0) {
@@ -220,25 +231,25 @@ static std::vector<Autocomplete<nt::idx_t>::fl_quality> complete(const type::Dat
         case nt::Type_e::Admin:
             if (search_type == 0) {
                 result = d.geo_ref->fl_admin.find_complete(q, nbmax, valid_admin_ptr(d.geo_ref->admins, admin_ptr),
-                                                           d.geo_ref->ghostwords);
+                                                           d.geo_ref->ghostwords, admin_scores);
             } else {
-                result = d.geo_ref->fl_admin.find_partial_with_pattern(q, d.geo_ref->word_weight, nbmax,
-                                                                       valid_admin_ptr(d.geo_ref->admins, admin_ptr),
-                                                                       d.geo_ref->ghostwords);
+                result = d.geo_ref->fl_admin.find_partial_with_pattern(
+                    q, d.geo_ref->word_weight, nbmax, valid_admin_ptr(d.geo_ref->admins, admin_ptr),
+                    d.geo_ref->ghostwords, admin_scores);
             }
             break;
         case nt::Type_e::Address:
             result = d.geo_ref->find_ways(q, nbmax, search_type, valid_admin_ptr(d.geo_ref->ways, admin_ptr),
-                                          d.geo_ref->ghostwords);
+                                          d.geo_ref->ghostwords, way_scores);
             break;
         case nt::Type_e::POI:
             if (search_type == 0) {
                 result = d.geo_ref->fl_poi.find_complete(q, nbmax, valid_admin_ptr(d.geo_ref->pois, admin_ptr),
-                                                         d.geo_ref->ghostwords);
+                                                         d.geo_ref->ghostwords, poi_scores);
             } else {
-                result = d.geo_ref->fl_poi.find_partial_with_pattern(q, d.geo_ref->word_weight, nbmax,
-                                                                     valid_admin_ptr(d.geo_ref->pois, admin_ptr),
-                                                                     d.geo_ref->ghostwords);
+                result = d.geo_ref->fl_poi.find_partial_with_pattern(
+                    q, d.geo_ref->word_weight, nbmax, valid_admin_ptr(d.geo_ref->pois, admin_ptr),
+                    d.geo_ref->ghostwords, poi_scores);
             }
             break;
         case nt::Type_e::Network:
@@ -629,7 +629,7 @@ BOOST_AUTO_TEST_CASE(autocomplete_main_stop_area_test) {
     ad->postal_codes.push_back("29000");
     ad->idx = 0;
     b.data->geo_ref->admins.push_back(ad);
-    ad->main_stop_areas.push_back(b.data->pt_data->stop_areas_map["Luther King"]);
+    b.data->pt_data->admin_main_stop_areas[ad->idx].push_back(b.data->pt_data->stop_areas_map["Luther King"]);
     b.manage_admin();
     b.build_autocomplete();
 
@@ -1152,7 +1152,7 @@ BOOST_AUTO_TEST_CASE(autocomplete_functional_test_SA_temp_test) {
         b.data->pt_data->stop_area_autocomplete.word_quality_list.at(idx).score = score;
     };
 
-    b.data->geo_ref->fl_admin.word_quality_list.at(0).score = 50;
+    b.data->pt_data->admin_autocomplete_scores.at(0) = 50;
     set_sa_score("Santec", 10);
     set_sa_score("Ar Santé Les Fontaines Nantes", 7);
     set_sa_score("Santenay-Haut Nantes", 35);
@@ -1805,6 +1805,42 @@ BOOST_AUTO_TEST_CASE(autocomplete_admin_filtering_tests) {
     BOOST_CHECK_EQUAL(resp.places(1).uri(), "bob");
 }
 
+// the georef can be shared by data having other stop points, the scores of its admins are computed for each data
+BOOST_AUTO_TEST_CASE(autocomplete_admin_score_with_shared_georef_test) {
+    ed::builder b("20140614");
+
+    Admin* bobville = new Admin;
+    bobville->name = "BobVille";
+    bobville->uri = "BobVille";
+    bobville->level = 8;
+    bobville->idx = 0;
+    b.data->geo_ref->admins.push_back(bobville);
+
+    b.sa("bob", 0, 0);
+    b.sa("bobette", 0, 0);
+    b.sa("bobby", 0, 0);
+    b.manage_admin();
+    b.data->pt_data->sort_and_index();
+    b.build_autocomplete();
+    // log(3 + 2) * 10
+    BOOST_CHECK_EQUAL(b.data->pt_data->admin_autocomplete_scores.at(0), 16);
+
+    ed::builder b_shared("20140614");
+    b_shared.data->geo_ref = b.data->geo_ref;
+    b_shared.data->geo_ref_shared = true;
+    b_shared.sa("bob", 0, 0);
+    b_shared.manage_admin();
+    b_shared.data->pt_data->sort_and_index();
+    b_shared.data->build_autocomplete_partial();
+    // log(1 + 2) * 10
+    BOOST_CHECK_EQUAL(b_shared.data->pt_data->admin_autocomplete_scores.at(0), 10);
+    BOOST_CHECK_EQUAL(b_shared.data->pt_data->stop_point_autocomplete.word_quality_list.at(0).score, 10);
+
+    // the scores of the first data don't change
+    BOOST_CHECK_EQUAL(b.data->pt_data->admin_autocomplete_scores.at(0), 16);
+    BOOST_CHECK_EQUAL(b.data->pt_data->stop_point_autocomplete.word_quality_list.at(0).score, 16);
+}
+
 BOOST_AUTO_TEST_CASE(test_ways) {
     int nbmax = 10;
     std::set<std::string> ghostwords{"de", "la"};
@@ -103,5 +103,27 @@ navitia::type::GeographicalCoord ConvCoord::convert_to(navitia::type::Geographic
     return coord;
 }
 
+void ConvCoord::convert_to(std::vector<navitia::type::GeographicalCoord>& coords) const {
+    if (this->origin.definition == this->destination.definition || coords.empty()) {
+        return;
+    }
+    // proj wants the x and the y in separate arrays
+    std::vector<double> x, y;
+    x.reserve(coords.size());
+    y.reserve(coords.size());
+    const double origin_factor = this->origin.is_degree ? DEG_TO_RAD : 1.;
+    for (const auto& coord : coords) {
+        x.push_back(coord.lon() * origin_factor);
+        y.push_back(coord.lat() * origin_factor);
+    }
+    pj_transform(this->origin.proj_pj, this->destination.proj_pj, long(coords.size()), 1, x.data(), y.data(),
+                 nullptr);
+    const double destination_factor = this->destination.is_degree ? RAD_TO_DEG : 1.;
+    for (size_t i = 0; i < coords.size(); ++i) {
+        coords[i].set_lon(x[i] * destination_factor);
+        coords[i].set_lat(y[i] * destination_factor);
+    }
+}
+
 }  // namespace connectors
 }  // namespace ed
@@ -32,6 +32,8 @@ www.navitia.io
 #include <proj_api.h>
 #include "type/geographical_coord.h"
 
+#include <vector>
+
 namespace ed {
 namespace connectors {
 
@@ -56,6 +58,10 @@ struct ConvCoord {
     ConvCoord(Projection origin, Projection destination = Projection())
         : origin(std::move(origin)), destination(std::move(destination)) {}
     navitia::type::GeographicalCoord convert_to(navitia::type::GeographicalCoord coord) const;
+    // converts the coords in place, in one call to proj
+    // the projections mustn't be shared between threads, each thread converting a part of the coords needs its own
+    // copy of the ConvCoord
+    void convert_to(std::vector<navitia::type::GeographicalCoord>& coords) const;
 };
 
 }  // namespace connectors
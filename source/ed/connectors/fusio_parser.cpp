@@ -441,7 +441,14 @@ void StopTimeFusioHandler::init(Data& data) {
 }
 
 void StopTimeFusioHandler::handle_line(Data& data, const csv_row& row, bool is_first_line) {
-    auto stop_times = StopTimeGtfsHandler::handle_line(data, row, is_first_line);
+    handle_resolved_line(data, row, resolve_line(row), is_first_line);
+}
+
+void StopTimeFusioHandler::handle_resolved_line(Data& data,
+                                                const csv_row& row,
+                                                const ResolvedLine& resolved,
+                                                bool is_first_line) {
+    auto stop_times = StopTimeGtfsHandler::handle_resolved_line(data, row, resolved, is_first_line);
     // gtfs can return many stoptimes for one line because of DST periods
     if (stop_times.empty()) {
         return;
@@ -1925,7 +1932,7 @@ void FusioParser::parse_files(Data& data, const std::string& beginning_date) {
     parse<TripPropertiesFusioHandler>(data, "trip_properties.txt");
     parse<OdtConditionsFusioHandler>(data, "odt_conditions.txt");
     parse<TripsFusioHandler>(data, "trips.txt", true);
-    parse<StopTimeFusioHandler>(data, "stop_times.txt", true);
+    parse_in_parallel<StopTimeFusioHandler>(data, "stop_times.txt", true);
     parse<FrequenciesGtfsHandler>(data, "frequencies.txt");
     parse<ObjectCodesFusioHandler>(data, "object_codes.txt");
     parse<grid_calendar::GridCalendarFusioHandler>(data, "grid_calendars.txt");
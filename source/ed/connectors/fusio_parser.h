@@ -130,6 +130,7 @@ struct StopTimeFusioHandler : public StopTimeGtfsHandler {
     int desc_c, itl_c, date_time_estimated_c, id_c, headsign_c, boarding_duration_c, alighting_duration_c;
     bool is_stop_time_precision;
     void init(Data&);
+    void handle_resolved_line(Data& data, const csv_row& line, const ResolvedLine& resolved, bool is_first_line);
     void handle_line(Data& data, const csv_row& line, bool is_first_line);
 };
 
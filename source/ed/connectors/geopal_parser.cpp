@@ -85,7 +85,8 @@ void GeopalParser::fill() {
 ed::types::Node* GeopalParser::add_node(const navitia::type::GeographicalCoord& coord, const std::string& uri) {
     ed::types::Node* node = new ed::types::Node;
     node->id = this->data.nodes.size() + 1;
-    node->coord = this->conv_coord.convert_to(coord);
+    // converted with all the other nodes at the end of fill_ways_edges
+    node->coord = coord;
     this->data.nodes[uri] = node;
     return node;
 }
@@ -412,6 +413,18 @@ void GeopalParser::fill_ways_edges() {
             }
         }
     }
+
+    // the coords of the nodes are converted all at once
+    std::vector<navitia::type::GeographicalCoord> coords;
+    coords.reserve(this->data.nodes.size());
+    for (const auto& uri_node : this->data.nodes) {
+        coords.push_back(uri_node.second->coord);
+    }
+    this->conv_coord.convert_to(coords);
+    auto coord_it = coords.begin();
+    for (auto& uri_node : this->data.nodes) {
+        uri_node.second->coord = *coord_it++;
+    }
 }
 
 }  // namespace connectors
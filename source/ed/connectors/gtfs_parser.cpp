@@ -1039,43 +1039,61 @@ void StopTimeGtfsHandler::finish(Data& data) {
     LOG4CPLUS_INFO(logger, "Nb stop times: " << data.stops.size());
 }
 
-static int to_utc(const std::string& local_time, int utc_offset) {
-    int local = time_to_int(local_time);
+static int to_utc(int local, int utc_offset) {
     if (local != std::numeric_limits<int>::min()) {
         local -= utc_offset;
     }
     return local;
 }
 
-std::vector<nm::StopTime*> StopTimeGtfsHandler::handle_line(Data& data, const csv_row& row, bool) {
-    auto stop_it = gtfs_data.stop_point_map.find(row[stop_c]);
-    if (stop_it == gtfs_data.stop_point_map.end()) {
+static int to_utc(const std::string& local_time, int utc_offset) {
+    return to_utc(time_to_int(local_time), utc_offset);
+}
+
+StopTimeGtfsHandler::ResolvedLine StopTimeGtfsHandler::resolve_line(const csv_row& row) const {
+    ResolvedLine resolved;
+    resolved.stop_point = find_or_default(row[stop_c], gtfs_data.stop_point_map);
+    resolved.vj_begin = gtfs_data.tz.vj_by_name.lower_bound(row[trip_c]);
+    resolved.vj_end = gtfs_data.tz.vj_by_name.upper_bound(row[trip_c]);
+    resolved.local_arrival_time = time_to_int(row[arrival_c]);
+    resolved.local_departure_time = time_to_int(row[departure_c]);
+    return resolved;
+}
+
+std::vector<nm::StopTime*> StopTimeGtfsHandler::handle_line(Data& data, const csv_row& row, bool is_first_line) {
+    return handle_resolved_line(data, row, resolve_line(row), is_first_line);
+}
+
+std::vector<nm::StopTime*> StopTimeGtfsHandler::handle_resolved_line(Data& data,
+                                                                     const csv_row& row,
+                                                                     const ResolvedLine& resolved,
+                                                                     bool) {
+    if (!resolved.stop_point) {
         LOG4CPLUS_WARN(logger, "Impossible to find the stop_point " + row[stop_c] + "!");
         return {};
     }
 
-    auto vj_it = gtfs_data.tz.vj_by_name.lower_bound(row[trip_c]);
-    if (vj_it == gtfs_data.tz.vj_by_name.end()) {
+    if (resolved.vj_begin == gtfs_data.tz.vj_by_name.end()) {
         LOG4CPLUS_WARN(logger, "Impossible to find the vehicle_journey '" << row[trip_c] << "'");
         return {};
     }
     std::vector<nm::StopTime*> stop_times;
 
     // the validity pattern may have been split because of DST, so we need to create one vj for each
-    for (auto vj_end_it = gtfs_data.tz.vj_by_name.upper_bound(row[trip_c]); vj_it != vj_end_it; ++vj_it) {
+    for (auto vj_it = resolved.vj_begin; vj_it != resolved.vj_end; ++vj_it) {
         nm::StopTime* stop_time = new nm::StopTime();
 
         // we need to convert the stop times in UTC
         int utc_offset = data.tz_wrapper.tz_handler.get_utc_offset(*vj_it->second->validity_pattern);
 
-        stop_time->arrival_time = to_utc(row[arrival_c], utc_offset);
-        stop_time->departure_time = to_utc(row[departure_c], utc_offset);
+        stop_time->arrival_time = to_utc(resolved.local_arrival_time, utc_offset);
+        stop_time->departure_time = to_utc(resolved.local_departure_time, utc_offset);
 
         // GTFS don't handle boarding / alighting duration, assuming 0
         stop_time->alighting_time = stop_time->arrival_time;
         stop_time->boarding_time = stop_time->departure_time;
 
-        stop_time->stop_point = stop_it->second;
+        stop_time->stop_point = resolved.stop_point;
         stop_time->order = boost::lexical_cast<unsigned int>(row[stop_seq_c]);
         stop_time->vehicle_journey = vj_it->second;
 
@@ -1454,7 +1472,7 @@ void GtfsParser::parse_files(Data& data, const std::string& beginning_date) {
     split_validity_pattern_over_dst(data, gtfs_data);
 
     parse<TripsGtfsHandler>(data, "trips.txt", true);
-    parse<StopTimeGtfsHandler>(data, "stop_times.txt", true);
+    parse_in_parallel<StopTimeGtfsHandler>(data, "stop_times.txt", true);
     parse<FrequenciesGtfsHandler>(data, "frequencies.txt");
 }
 
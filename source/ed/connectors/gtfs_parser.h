@@ -32,6 +32,8 @@ www.navitia.io
 #include "ed/data.h"
 #include <boost/unordered_map.hpp>
 #include <queue>
+#include <future>
+#include <thread>
 #include "utils/csv.h"
 #include "utils/logger.h"
 #include "utils/functions.h"
@@ -168,6 +170,18 @@ public:
         : csv(ss, ',', true), fail_if_no_file(fail), handler(gdata, csv) {}
 
     bool fill(Data& data);
+
+    /**
+     * Same as fill, for the handlers that can split their work in 2 methods:
+     * - resolve_line(const csv_row&) const: reads a line without modifying anything, run on nb_threads threads
+     * - handle_resolved_line(Data&, const csv_row&, const resolved&, bool is_first_line): called at each line,
+     *   in the order of the file
+     * The file is read by chunks, the next chunk being read while the current one is resolved.
+     */
+    bool fill(Data& data, size_t nb_threads);
+
+private:
+    bool check_file_and_headers();
 };
 
 /**
@@ -315,9 +329,23 @@ struct StopTimeGtfsHandler : public GenericHandler {
     StopTimeGtfsHandler(GtfsData& gdata, CsvReader& reader) : GenericHandler(gdata, reader) {}
     int trip_c, arrival_c, departure_c, stop_c, stop_seq_c, pickup_c, drop_off_c;
 
+    /// what can be read from a line without modifying the data, thus on several threads
+    struct ResolvedLine {
+        ed::types::StopPoint* stop_point = nullptr;
+        using VjIt = std::multimap<std::string, ed::types::VehicleJourney*>::const_iterator;
+        VjIt vj_begin, vj_end;
+        int local_arrival_time = 0;
+        int local_departure_time = 0;
+    };
+
     size_t count = 0;
     void init(Data& data);
     void finish(Data& data);
+    ResolvedLine resolve_line(const csv_row& line) const;
+    std::vector<ed::types::StopTime*> handle_resolved_line(Data& data,
+                                                           const csv_row& line,
+                                                           const ResolvedLine& resolved,
+                                                           bool is_first_line);
     std::vector<ed::types::StopTime*> handle_line(Data& data, const csv_row& line, bool is_first_line);
     const std::vector<std::string> required_headers() const {
         return {"trip_id", "arrival_time", "departure_time", "stop_id", "stop_sequence"};
@@ -346,11 +374,16 @@ protected:
     bool parse(Data&, std::string file_name, bool fail_if_no_file = false);
     template <typename Handler>
     void parse(Data&);  // some parser do not need a file since they just add default data
+    /// for the biggest files, with a handler able to resolve the lines on several threads
+    template <typename Handler>
+    bool parse_in_parallel(Data&, std::string file_name, bool fail_if_no_file = false);
 
     virtual void parse_files(Data&, const std::string& beginning_date = "") = 0;
 
 public:
     GtfsData gtfs_data;
+    /// number of threads used to parse stop_times.txt
+    size_t nb_threads = 1;
 
     /// Constructeur qui prend en paramètre le chemin vers les fichiers
     GenericGtfsParser(const std::string& path);
@@ -382,6 +415,14 @@ inline void GenericGtfsParser::parse(Data& data) {
     FileParser<Handler> parser(this->gtfs_data, "");
     parser.fill(data);
 }
+template <typename Handler>
+inline bool GenericGtfsParser::parse_in_parallel(Data& data, std::string file_name, bool fail_if_no_file) {
+    FileParser<Handler> parser(this->gtfs_data, path + "/" + file_name, fail_if_no_file);
+    if (nb_threads <= 1) {
+        return parser.fill(data);
+    }
+    return parser.fill(data, nb_threads);
+}
 
 /**
  * GTFS parser
@@ -414,7 +455,7 @@ struct InvalidHeaders {
 };
 
 template <typename Handler>
-inline bool FileParser<Handler>::fill(Data& data) {
+inline bool FileParser<Handler>::check_file_and_headers() {
     auto logger = log4cplus::Logger::getInstance("log");
     if (!csv.is_open() && !csv.filename.empty()) {
         if (fail_if_no_file) {
@@ -431,6 +472,14 @@ inline bool FileParser<Handler>::fill(Data& data) {
             logger, "Error while reading " << csv.filename << " missing headers : " << csv.missing_headers(headers));
         throw InvalidHeaders(csv.filename);
     }
+    return true;
+}
+
+template <typename Handler>
+inline bool FileParser<Handler>::fill(Data& data) {
+    if (!check_file_and_headers()) {
+        return false;
+    }
     handler.init(data);
 
     bool line_read = true;
@@ -446,6 +495,63 @@ inline bool FileParser<Handler>::fill(Data& data) {
     return true;
 }
 
+template <typename Handler>
+inline bool FileParser<Handler>::fill(Data& data, size_t nb_threads) {
+    if (!check_file_and_headers()) {
+        return false;
+    }
+    handler.init(data);
+
+    const size_t chunk_size = 10000 * nb_threads;
+    using Resolved = decltype(handler.resolve_line(std::declval<typename Handler::csv_row>()));
+    auto read_chunk = [&]() {
+        std::vector<typename Handler::csv_row> rows;
+        rows.reserve(chunk_size);
+        while (rows.size() < chunk_size && !csv.eof()) {
+            auto row = csv.next();
+            if (!row.empty()) {
+                rows.push_back(std::move(row));
+            }
+        }
+        return rows;
+    };
+    auto resolve_chunk = [&](const std::vector<typename Handler::csv_row>& rows) {
+        std::vector<Resolved> resolved(rows.size());
+        const size_t range_size = (rows.size() + nb_threads - 1) / nb_threads;
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < nb_threads; ++t) {
+            const size_t begin = std::min(t * range_size, rows.size());
+            const size_t end = std::min(begin + range_size, rows.size());
+            threads.emplace_back([&, begin, end]() {
+                for (size_t i = begin; i < end; ++i) {
+                    resolved[i] = handler.resolve_line(rows[i]);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return resolved;
+    };
+
+    bool line_read = true;
+    auto rows = read_chunk();
+    while (!rows.empty()) {
+        auto resolution = std::async(std::launch::async, resolve_chunk, std::cref(rows));
+        auto next_rows = read_chunk();
+        const auto resolved = resolution.get();
+        // the lines are handled in the order of the file, the data are the same as with only one thread
+        for (size_t i = 0; i < rows.size(); ++i) {
+            handler.handle_resolved_line(data, rows[i], resolved[i], line_read);
+            line_read = false;
+        }
+        rows = std::move(next_rows);
+    }
+    handler.finish(data);
+
+    return true;
+}
+
 template <typename T>
 bool empty(const std::pair<T, T>& r) {
     return r.first == r.second;
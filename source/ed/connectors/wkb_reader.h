@@ -0,0 +1,235 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "utils/exception.h"
+
+#include <boost/geometry.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace ed {
+namespace connectors {
+
+/**
+ * Reads the geometries sent by PostGIS in hexadecimal WKB, ie selected with encode(ST_AsBinary(geom), 'hex')
+ *
+ * Decoding the binary coordinates is much cheaper than parsing their WKT representation, and they aren't rounded.
+ * The extended WKB of ST_AsEWKB is handled too: the srid is skipped, like the z and m of the points.
+ */
+class WkbReader {
+public:
+    explicit WkbReader(const std::string& hex) {
+        size_t begin = 0;
+        // a bytea column is prefixed
+        if (hex.compare(0, 2, "\\x") == 0) {
+            begin = 2;
+        }
+        if ((hex.size() - begin) % 2 != 0) {
+            throw navitia::exception("invalid hexadecimal wkb: odd number of digits");
+        }
+        bytes.reserve((hex.size() - begin) / 2);
+        for (size_t i = begin; i < hex.size(); i += 2) {
+            bytes.push_back(uint8_t(hex_value(hex[i]) << 4 | hex_value(hex[i + 1])));
+        }
+    }
+
+    template <typename Geometry>
+    void read(Geometry& geometry) {
+        read(geometry, typename boost::geometry::tag<Geometry>::type());
+        if (pos != bytes.size()) {
+            throw navitia::exception("invalid wkb: unexpected data after the geometry");
+        }
+    }
+
+private:
+    enum WkbType : uint32_t { point = 1, linestring = 2, polygon = 3, multi_linestring = 5, multi_polygon = 6 };
+
+    std::vector<uint8_t> bytes;
+    size_t pos = 0;
+    bool little_endian = true;
+    // the z and m of the points are ignored
+    size_t nb_skipped_dims = 0;
+
+    static uint8_t hex_value(const char c) {
+        if (c >= '0' && c <= '9') {
+            return uint8_t(c - '0');
+        }
+        if (c >= 'a' && c <= 'f') {
+            return uint8_t(c - 'a' + 10);
+        }
+        if (c >= 'A' && c <= 'F') {
+            return uint8_t(c - 'A' + 10);
+        }
+        throw navitia::exception(std::string("invalid hexadecimal wkb: ") + c);
+    }
+
+    void check_size(const size_t size) const {
+        if (pos + size > bytes.size()) {
+            throw navitia::exception("invalid wkb: truncated geometry");
+        }
+    }
+
+    // the bytes are read one by one, whatever the endianness of the host
+    uint64_t read_bytes(const size_t size) {
+        check_size(size);
+        uint64_t value = 0;
+        for (size_t i = 0; i < size; ++i) {
+            const uint64_t byte = bytes[pos + (little_endian ? i : size - 1 - i)];
+            value |= byte << (8 * i);
+        }
+        pos += size;
+        return value;
+    }
+    uint32_t read_uint32() { return uint32_t(read_bytes(4)); }
+    double read_double() {
+        const uint64_t value = read_bytes(8);
+        double d;
+        std::memcpy(&d, &value, sizeof(d));
+        return d;
+    }
+
+    // number of geometries of a multi geometry, each of them takes at least a header
+    uint32_t read_nb_geometries() {
+        const uint32_t nb_geometries = read_uint32();
+        check_size(size_t(nb_geometries) * 5);
+        return nb_geometries;
+    }
+
+    void read_header(const WkbType expected_type) {
+        check_size(1);
+        little_endian = bytes[pos++] == 1;
+        uint32_t type = read_uint32();
+        // extended wkb flags
+        nb_skipped_dims = ((type & 0x80000000) ? 1 : 0) + ((type & 0x40000000) ? 1 : 0);
+        if (type & 0x20000000) {
+            read_uint32();  // srid
+        }
+        type &= 0x0fffffff;
+        // iso wkb: 1000 for z, 2000 for m, 3000 for zm
+        nb_skipped_dims += type / 1000 == 3 ? 2 : (type / 1000 == 0 ? 0 : 1);
+        type %= 1000;
+        if (type != expected_type) {
+            throw navitia::exception("invalid wkb: geometry type " + std::to_string(type) + " instead of "
+                                     + std::to_string(expected_type));
+        }
+    }
+
+    template <typename Point>
+    void read_coords(Point& point) {
+        boost::geometry::set<0>(point, read_double());
+        boost::geometry::set<1>(point, read_double());
+        for (size_t i = 0; i < nb_skipped_dims; ++i) {
+            read_double();
+        }
+    }
+
+    template <typename Range>
+    void read_points(Range& range) {
+        const uint32_t nb_points = read_uint32();
+        check_size(size_t(nb_points) * (2 + nb_skipped_dims) * sizeof(double));
+        range.resize(nb_points);
+        for (auto& point : range) {
+            read_coords(point);
+        }
+    }
+
+    template <typename Ring>
+    void read_ring(Ring& ring) {
+        read_points(ring);
+        // the wkb rings are closed
+        if (boost::geometry::closure<Ring>::value == boost::geometry::open && ring.size() > 1
+            && boost::geometry::equals(ring.front(), ring.back())) {
+            ring.pop_back();
+        }
+    }
+
+    template <typename Point>
+    void read(Point& point, boost::geometry::point_tag) {
+        read_header(WkbType::point);
+        read_coords(point);
+    }
+
+    template <typename Linestring>
+    void read(Linestring& linestring, boost::geometry::linestring_tag) {
+        read_header(WkbType::linestring);
+        read_points(linestring);
+    }
+
+    template <typename Polygon>
+    void read(Polygon& polygon, boost::geometry::polygon_tag) {
+        read_header(WkbType::polygon);
+        boost::geometry::clear(polygon);
+        const uint32_t nb_rings = read_uint32();
+        for (uint32_t i = 0; i < nb_rings; ++i) {
+            if (i == 0) {
+                read_ring(polygon.outer());
+            } else {
+                polygon.inners().resize(i);
+                read_ring(polygon.inners().back());
+            }
+        }
+    }
+
+    template <typename MultiLinestring>
+    void read(MultiLinestring& multi_linestring, boost::geometry::multi_linestring_tag) {
+        read_header(WkbType::multi_linestring);
+        multi_linestring.resize(read_nb_geometries());
+        for (auto& linestring : multi_linestring) {
+            read(linestring, boost::geometry::linestring_tag());
+        }
+    }
+
+    template <typename MultiPolygon>
+    void read(MultiPolygon& multi_polygon, boost::geometry::multi_polygon_tag) {
+        read_header(WkbType::multi_polygon);
+        multi_polygon.resize(read_nb_geometries());
+        for (auto& polygon : multi_polygon) {
+            read(polygon, boost::geometry::polygon_tag());
+        }
+    }
+};
+
+// an empty string (a null geometry) gives an empty geometry
+template <typename Geometry>
+void read_hex_wkb(const std::string& hex, Geometry& geometry) {
+    if (hex.empty()) {
+        boost::geometry::clear(geometry);
+        return;
+    }
+    WkbReader(hex).read(geometry);
+}
+
+}  // namespace connectors
+}  // namespace ed
@@ -41,6 +41,7 @@ www.navitia.io
 #include <boost/range/algorithm/max_element.hpp>
 
 #include <iostream>
+#include <unordered_set>
 
 namespace nt = navitia::type;
 namespace ed {
@@ -327,67 +328,60 @@ void Data::complete() {
 
 void Data::clean() {
     auto logger = log4cplus::Logger::getInstance("log");
-    std::set<std::string> toErase;
     int erase_emptiness = 0, erase_no_circulation = 0, erase_invalid_stoptimes = 0;
 
-    for (auto* vj : vehicle_journeys) {
+    // we check that no stop times are negatives
+    const auto st_is_invalid = [](const types::StopTime* st) {
+        return st->departure_time < 0 || st->arrival_time < 0 || st->boarding_time < 0 || st->alighting_time < 0;
+    };
+    auto must_be_erased = [&](types::VehicleJourney* vj) {
         if (vj_to_erase.count(vj)) {
-            toErase.insert(vj->uri);
-            continue;
+            return true;
         }
         if (vj->stop_time_list.empty()) {
-            toErase.insert(vj->uri);
             ++erase_emptiness;
-            continue;
+            return true;
         }
         if (vj->validity_pattern->days.none() && vj->adapted_validity_pattern->days.none()) {
-            toErase.insert(vj->uri);
             ++erase_no_circulation;
-            continue;
+            return true;
         }
-        // we check that no stop times are negatives
-        const auto st_is_invalid = [](const types::StopTime* st) {
-            return st->departure_time < 0 || st->arrival_time < 0 || st->boarding_time < 0 || st->alighting_time < 0;
-        };
         if (std::any_of(vj->stop_time_list.begin(), vj->stop_time_list.end(), st_is_invalid)) {
-            toErase.insert(vj->uri);
             ++erase_invalid_stoptimes;
+            return true;
         }
-    }
-
-    std::vector<size_t> erasest;
+        return false;
+    };
 
-    for (int i = stops.size() - 1; i >= 0; --i) {
-        auto it = toErase.find(stops[i]->vehicle_journey->uri);
-        if (it != toErase.end()) {
-            erasest.push_back(i);
+    // the vjs to erase are marked by their position
+    std::vector<bool> vj_erased(vehicle_journeys.size(), false);
+    std::unordered_set<const types::VehicleJourney*> to_erase;
+    for (size_t i = 0; i < vehicle_journeys.size(); ++i) {
+        if (must_be_erased(vehicle_journeys[i])) {
+            vj_erased[i] = true;
+            to_erase.insert(vehicle_journeys[i]);
         }
     }
 
-    // For each stop_time to remove, we delete and put the last element of the vector in it's place
-    // We avoid resizing the vector until completition for performance reasons.
-    size_t num_elements = stops.size();
-    for (size_t to_erase : erasest) {
-        remove_reference_to_object(stops[to_erase]);
-        delete stops[to_erase];
-        stops[to_erase] = stops[num_elements - 1];
-        num_elements--;
-    }
-
-    stops.resize(num_elements);
-
-    erasest.clear();
-    for (int i = vehicle_journeys.size() - 1; i >= 0; --i) {
-        auto it = toErase.find(vehicle_journeys[i]->uri);
-        if (it != toErase.end()) {
-            erasest.push_back(i);
+    // the kept stop times are compacted at the beginning of the vector, keeping their order
+    auto stops_end = std::remove_if(stops.begin(), stops.end(), [&](types::StopTime* st) {
+        if (!to_erase.count(st->vehicle_journey)) {
+            return false;
         }
-    }
+        remove_reference_to_object(st);
+        delete st;
+        return true;
+    });
+    stops.erase(stops_end, stops.end());
 
     // The same but now with vehicle_journey's
-    num_elements = vehicle_journeys.size();
-    for (size_t to_erase : erasest) {
-        auto vj = vehicle_journeys[to_erase];
+    size_t nb_kept = 0;
+    for (size_t i = 0; i < vehicle_journeys.size(); ++i) {
+        auto* vj = vehicle_journeys[i];
+        if (!vj_erased[i]) {
+            vehicle_journeys[nb_kept++] = vj;
+            continue;
+        }
         if (vj->next_vj) {
             vj->next_vj->prev_vj = nullptr;
         }
@@ -415,10 +409,8 @@ void Data::clean() {
 
         remove_reference_to_object(vj);
         delete vj;
-        vehicle_journeys[to_erase] = vehicle_journeys[num_elements - 1];
-        num_elements--;
     }
-    vehicle_journeys.resize(num_elements);
+    vehicle_journeys.resize(nb_kept);
 
     if (erase_emptiness || erase_no_circulation || erase_invalid_stoptimes) {
         LOG4CPLUS_INFO(logger, "Data::clean(): "
@@ -0,0 +1,58 @@
+# coding: utf-8
+# Copyright (c) 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+#
+# This file is part of Navitia,
+#     the software to build cool stuff with public transport.
+#
+#     powered by Canal TP (www.canaltp.fr).
+# Help us simplify mobility and open public transport:
+#     a non ending quest to the responsive locomotion way of traveling!
+#
+# LICENCE: This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+# Stay tuned using
+# twitter @navitia
+# channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+# https://groups.google.com/d/forum/navitia
+# www.navitia.io
+
+from __future__ import absolute_import, print_function, division
+from contextlib import closing
+from ed_handler import update_db, ALEMBIC_PATH_ED
+from testscommon.docker_wrapper import PostgisDocker
+from os.path import join, normpath, isfile
+import os
+import pytest
+import subprocess
+
+
+@pytest.yield_fixture(scope="session")
+def ed_docker():
+    """
+    a docker providing an ED database with its schema is started once for all tests
+    """
+    with closing(PostgisDocker()) as docker_ed:
+        update_db(docker_ed.get_db_params(), ALEMBIC_PATH_ED)
+        yield docker_ed
+
+
+def test_ed_database(ed_docker):
+    ed_db_tests_dir = os.getenv('ED_DB_TESTS_BUILD_DIR', '.')
+    ed_db_tests_exec = normpath(join(ed_db_tests_dir, 'ed_db_tests'))
+
+    assert isfile(ed_db_tests_exec), "Couldn't find test executable : {}".format(ed_db_tests_exec)
+
+    # Give the cpp test a connection string to the db
+    os.environ['ED_DB_CONNECTION_STR'] = ed_docker.get_db_params().old_school_cnx_string()
+    assert subprocess.check_call([ed_db_tests_exec]) == 0
@@ -0,0 +1,219 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ed_db_tests
+
+#include "conf.h"
+#include "ed/data.h"
+#include "ed/ed_converter.h"
+#include "ed/ed_persistor.h"
+#include "ed/ed_reader.h"
+#include "ed/connectors/fusio_parser.h"
+#include "georef/georef.h"
+#include "type/pt_data.h"
+#include "utils/logger.h"
+
+#include <boost/test/unit_test.hpp>
+#include <pqxx/pqxx>
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+/*
+ * Tests reading and writing an ED database, given by ED_DB_CONNECTION_STR.
+ * They are run by ed_db_test.py, that starts the database in a docker and creates its schema.
+ */
+
+struct logger_initialized {
+    logger_initialized() { navitia::init_logger(); }
+};
+BOOST_GLOBAL_FIXTURE(logger_initialized);
+
+namespace nt = navitia::type;
+
+const std::string ntfs_path = std::string(navitia::config::fixtures_dir) + "/ed/ntfs";
+const double min_non_connected_graph_ratio = 0.01;
+
+// the data of the fixture prepared like fusio2ed does before storing them in the database
+struct ntfs_fixture {
+    ed::Data ed_data;
+    const std::string connection_string;
+
+    ntfs_fixture() : connection_string(get_connection_string()) {
+        ed::connectors::FusioParser parser(ntfs_path);
+        parser.fill(ed_data);
+        ed_data.complete();
+        ed_data.clean();
+        ed_data.sort();
+        ed_data.build_route_destination();
+        ed_data.normalize_uri();
+    }
+
+    static std::string get_connection_string() {
+        const char* connection_string = std::getenv("ED_DB_CONNECTION_STR");
+        BOOST_REQUIRE_MESSAGE(connection_string != nullptr, "ED_DB_CONNECTION_STR must give the ED database");
+        return connection_string;
+    }
+
+    // the .nav of the database read on nb_connections connections
+    std::string read_nav(const size_t nb_connections) const {
+        nt::Data data;
+        ed::EdReader reader(connection_string);
+        reader.nb_connections = nb_connections;
+        reader.fill(data, min_non_connected_graph_ratio, false);
+        std::stringstream nav;
+        data.save(nav);
+        return nav.str();
+    }
+};
+
+static size_t count_rows(const std::string& connection_string, const std::string& table) {
+    pqxx::connection conn(connection_string);
+    pqxx::work work(conn);
+    return work.exec("SELECT count(*) AS nb FROM " + table + ";").begin()["nb"].as<size_t>();
+}
+
+// a small street network around the stops of the ntfs fixture: one way of two edges in one admin
+static void persist_georef(const std::string& connection_string) {
+    ed::Georef georef;
+    auto* admin = new ed::types::Admin();
+    admin->id = 1;
+    admin->is_used = true;
+    admin->insee = "A";
+    admin->name = "admin A";
+    admin->coord = nt::GeographicalCoord(0.58, 45.03);
+    georef.admins["admin:A"] = admin;
+
+    auto* way = new ed::types::Way();
+    way->id = 1;
+    way->uri = "way:1";
+    way->name = "rue A";
+    way->type = "residential";
+    way->admin = admin;
+    georef.ways[way->uri] = way;
+
+    const std::vector<nt::GeographicalCoord> coords = {{0.5725, 45.0245}, {0.58, 45.027}, {0.5881, 45.0296}};
+    for (size_t i = 0; i < coords.size(); ++i) {
+        auto* node = new ed::types::Node();
+        node->id = i + 1;
+        node->is_used = true;
+        node->coord = coords[i];
+        georef.nodes["node:" + std::to_string(node->id)] = node;
+    }
+    for (size_t i = 1; i < coords.size(); ++i) {
+        auto* edge = new ed::types::Edge();
+        edge->way = way;
+        edge->source = georef.nodes.at("node:" + std::to_string(i));
+        edge->target = georef.nodes.at("node:" + std::to_string(i + 1));
+        edge->length = 800;
+        way->edges.push_back(edge);
+        georef.edges["edge:" + std::to_string(i)] = edge;
+    }
+
+    ed::EdPersistor persistor(connection_string);
+    persistor.persist(georef);
+}
+
+// The .nav written from the converted data must be the same as the one written from the database
+BOOST_FIXTURE_TEST_CASE(convert_like_the_database_round_trip, ntfs_fixture) {
+    ed::EdPersistor persistor(connection_string);
+    persistor.persist(ed_data);
+    nt::Data db_data;
+    ed::EdReader db_reader(connection_string);
+    db_reader.fill(db_data, min_non_connected_graph_ratio, false);
+
+    // the same steps as ed2nav_from_data
+    nt::Data converted_data;
+    ed::EdConverter converter;
+    ed::EdReader georef_reader(connection_string);
+    converter.fill(ed_data, converted_data);
+    georef_reader.fill_georef(converted_data, min_non_connected_graph_ratio, false);
+    converter.fill_admin_stop_areas(ed_data, converted_data, georef_reader.admin_by_insee_code);
+
+    BOOST_CHECK_EQUAL(converted_data.pt_data->stop_points.size(), db_data.pt_data->stop_points.size());
+    BOOST_CHECK_EQUAL(converted_data.pt_data->vehicle_journeys.size(), db_data.pt_data->vehicle_journeys.size());
+    BOOST_CHECK_EQUAL(converted_data.pt_data->nb_stop_times(), db_data.pt_data->nb_stop_times());
+    std::stringstream db_nav, converted_nav;
+    db_data.save(db_nav);
+    converted_data.save(converted_nav);
+    BOOST_CHECK(converted_nav.str() == db_nav.str());
+}
+
+// The public transport, the street network and the fares read on their own connections, in the snapshot of the
+// main transaction, give the same data as one connection
+BOOST_FIXTURE_TEST_CASE(read_on_several_connections_like_on_one, ntfs_fixture) {
+    persist_georef(connection_string);
+    ed::EdPersistor persistor(connection_string);
+    persistor.persist(ed_data);
+
+    const auto nav = read_nav(1);
+    BOOST_CHECK(!nav.empty());
+    // 2: the street network on its own connection, 3: the fares too
+    for (const size_t nb_connections : {2, 3}) {
+        BOOST_CHECK_MESSAGE(read_nav(nb_connections) == nav,
+                            "the data read on " << nb_connections << " connections differ");
+    }
+
+    // the street network is in the data: the parallel read is not trivially empty
+    nt::Data data;
+    ed::EdReader reader(connection_string);
+    reader.nb_connections = 3;
+    reader.fill(data, min_non_connected_graph_ratio, false);
+    BOOST_CHECK(!data.geo_ref->ways.empty());
+    BOOST_CHECK(boost::num_vertices(data.geo_ref->graph) > 0);
+    BOOST_CHECK_EQUAL(data.pt_data->vehicle_journeys.size(), ed_data.vehicle_journeys.size());
+}
+
+// A failing COPY aborts the whole import: the tables keep the data of the previous import
+BOOST_FIXTURE_TEST_CASE(failing_copy_leaves_the_previous_data, ntfs_fixture) {
+    {
+        ed::EdPersistor persistor(connection_string);
+        persistor.persist(ed_data);
+    }
+    const auto nb_stop_times = count_rows(connection_string, "navitia.stop_time");
+    const auto nb_vjs = count_rows(connection_string, "navitia.vehicle_journey");
+    BOOST_REQUIRE_EQUAL(nb_stop_times, ed_data.stops.size());
+
+    // two stop times with the same id, the COPY of the stop times fails on the primary key
+    BOOST_REQUIRE(ed_data.stops.size() > 1);
+    const auto idx = ed_data.stops.back()->idx;
+    ed_data.stops.back()->idx = ed_data.stops.front()->idx;
+    {
+        // the transaction is rolled back when the connection of the persistor is closed
+        ed::EdPersistor persistor(connection_string);
+        BOOST_CHECK_THROW(persistor.persist(ed_data), std::exception);
+    }
+    ed_data.stops.back()->idx = idx;
+
+    BOOST_CHECK_EQUAL(count_rows(connection_string, "navitia.stop_time"), nb_stop_times);
+    BOOST_CHECK_EQUAL(count_rows(connection_string, "navitia.vehicle_journey"), nb_vjs);
+}
@@ -32,6 +32,8 @@ www.navitia.io
 
 #include "conf.h"
 #include "ed_reader.h"
+#include "ed_converter.h"
+#include "ed/connectors/wkb_reader.h"
 #include "type/meta_data.h"
 #include "utils/exception.h"
 #include "utils/functions.h"
@@ -49,6 +51,7 @@ www.navitia.io
 #include <boost/range/adaptor/filtered.hpp>
 #include <pqxx/pqxx>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 
@@ -127,8 +130,7 @@ struct FindAdminWithCities {
         admin->from_original_dataset = false;
         std::string post_codes = r["post_code"].c_str();
         boost::split(admin->postal_codes, post_codes, boost::is_any_of("-"));
-        std::string boundary = r["boundary"].c_str();
-        boost::geometry::read_wkt(boundary, admin->boundary);
+        connectors::read_hex_wkb(r["boundary"].c_str(), admin->boundary);
 
         // Add admins to added list
         added_admins[admin->uri] = admin;
@@ -174,7 +176,7 @@ struct FindAdminWithCities {
                 coalesce(post_code, '') as post_code,
                 ST_X(coord::geometry) as lon,
                 ST_Y(coord::geometry) as lat,
-                ST_ASTEXT(boundary) as boundary
+                encode(ST_AsBinary(boundary), 'hex') as boundary
             FROM
                 administrative_regions,
                 (
@@ -203,18 +205,8 @@ struct FindAdminWithCities {
         //clang-format on
         boost::range::transform(filtered_res, std::back_inserter(new_admins), make_admin_from_row);
 
-        auto add_admin_to_cache = [&](georef::Admin* admin) {
-            if (admin->boundary.empty()) {
-                return;
-            }
-            const auto box = boost::geometry::return_envelope<georef::Box>(admin->boundary);
-            const double min[2] = {box.min_corner().lon(), box.min_corner().lat()};
-            const double max[2] = {box.max_corner().lon(), box.max_corner().lat()};
-            admin_tree.Insert(min, max, admin);
-        };
-
         // Add admins to RTree cache
-        boost::range::for_each(new_admins, add_admin_to_cache);
+        boost::range::for_each(new_admins, [&](georef::Admin* admin) { admin_tree.insert(admin); });
 
         return georef.find_admins(c, admin_tree);
     }
@@ -290,9 +282,52 @@ bool write_data_to_file(const std::string& output_filename, const T& data) {
     return remove_file(backup_output_filename);
 }
 
+static bool save_data(navitia::type::Data& data, const std::string& output, const int read) {
+    auto logger = log4cplus::Logger::getInstance("log");
+    data.complete();
+    data.meta->publication_date = pt::microsec_clock::local_time();
+    // the admins added from the cities database depend on the stop points, kraken can't keep such a georef
+    const auto is_from_cities = [](const georef::Admin* admin) { return !admin->from_original_dataset; };
+    if (std::any_of(data.geo_ref->admins.begin(), data.geo_ref->admins.end(), is_from_cities)) {
+        data.meta->georef_version.clear();
+    }
+
+    LOG4CPLUS_INFO(logger, "line: " << data.pt_data->lines.size());
+    LOG4CPLUS_INFO(logger, "line_groups: " << data.pt_data->line_groups.size());
+    LOG4CPLUS_INFO(logger, "route: " << data.pt_data->routes.size());
+    LOG4CPLUS_INFO(logger, "stoparea: " << data.pt_data->stop_areas.size());
+    LOG4CPLUS_INFO(logger, "stoppoint: " << data.pt_data->stop_points.size());
+    LOG4CPLUS_INFO(logger, "vehiclejourney: " << data.pt_data->vehicle_journeys.size());
+    LOG4CPLUS_INFO(logger, "stop: " << data.pt_data->nb_stop_times());
+    LOG4CPLUS_INFO(logger, "connection: " << data.pt_data->stop_point_connections.size());
+    LOG4CPLUS_INFO(logger, "modes: " << data.pt_data->physical_modes.size());
+    LOG4CPLUS_INFO(logger, "validity pattern : " << data.pt_data->validity_patterns.size());
+    LOG4CPLUS_INFO(logger, "calendars: " << data.pt_data->calendars.size());
+    LOG4CPLUS_INFO(logger, "synonyms : " << data.geo_ref->synonyms.size());
+    LOG4CPLUS_INFO(logger, "fare tickets: " << data.fare->fare_map.size());
+    LOG4CPLUS_INFO(logger, "fare transitions: " << data.fare->nb_transitions());
+    LOG4CPLUS_INFO(logger, "fare od: " << data.fare->od_tickets.size());
+    LOG4CPLUS_INFO(logger, "Begin to save ...");
+
+    const auto start = pt::microsec_clock::local_time();
+
+    if (!write_data_to_file(output, data)) {
+        LOG4CPLUS_ERROR(logger, "Exiting ed2nav with errors");
+        return false;
+    }
+    const int save = (pt::microsec_clock::local_time() - start).total_milliseconds();
+
+    LOG4CPLUS_INFO(logger, "Computing times");
+    LOG4CPLUS_INFO(logger, "\t File reading: " << read << "ms");
+    LOG4CPLUS_INFO(logger, "\t Data writing: " << save << "ms");
+
+    return true;
+}
+
 int ed2nav(int argc, const char* argv[]) {
-    std::string output, connection_string, region_name, cities_connection_string;
+    std::string output, connection_string, region_name, cities_connection_string, georef_cache;
     double min_non_connected_graph_ratio;
+    size_t nb_connections;
     po::options_description desc("Allowed options");
 
     // clang-format off
@@ -314,6 +349,10 @@ int ed2nav(int argc, const char* argv[]) {
          "database connection parameters: host=localhost user=navitia dbname=navitia password=navitia")
         ("cities-connection-string", po::value<std::string>(&cities_connection_string)->default_value(""),
          "cities database connection parameters: host=localhost user=navitia dbname=cities password=navitia")
+        ("nb_connections", po::value<size_t>(&nb_connections)->default_value(1),
+         "number of database connections: the street network (2) and the fares (3) are read in parallel")
+        ("georef_cache", po::value<std::string>(&georef_cache)->default_value(""),
+         "file keeping the street network between two runs, it is read again from the database only when it changes")
         ("local_syslog", "activate log redirection within local syslog")
         ("log_comment", po::value<std::string>(), "optional field to add extra information like coverage name");
     // clang-format on
@@ -354,7 +393,7 @@ int ed2nav(int argc, const char* argv[]) {
     po::notify(vm);
 
     pt::ptime start, now;
-    int read, save;
+    int read;
 
     navitia::type::Data data;
 
@@ -362,6 +401,8 @@ int ed2nav(int argc, const char* argv[]) {
     now = start = pt::microsec_clock::local_time();
 
     ed::EdReader reader(connection_string);
+    reader.nb_connections = nb_connections;
+    reader.georef_cache = georef_cache;
 
     if (!cities_connection_string.empty()) {
         data.find_admins = FindAdminWithCities(cities_connection_string, *data.geo_ref);
@@ -376,39 +417,41 @@ int ed2nav(int argc, const char* argv[]) {
     }
 
     read = (pt::microsec_clock::local_time() - start).total_milliseconds();
-    data.complete();
-    data.meta->publication_date = pt::microsec_clock::local_time();
 
-    LOG4CPLUS_INFO(logger, "line: " << data.pt_data->lines.size());
-    LOG4CPLUS_INFO(logger, "line_groups: " << data.pt_data->line_groups.size());
-    LOG4CPLUS_INFO(logger, "route: " << data.pt_data->routes.size());
-    LOG4CPLUS_INFO(logger, "stoparea: " << data.pt_data->stop_areas.size());
-    LOG4CPLUS_INFO(logger, "stoppoint: " << data.pt_data->stop_points.size());
-    LOG4CPLUS_INFO(logger, "vehiclejourney: " << data.pt_data->vehicle_journeys.size());
-    LOG4CPLUS_INFO(logger, "stop: " << data.pt_data->nb_stop_times());
-    LOG4CPLUS_INFO(logger, "connection: " << data.pt_data->stop_point_connections.size());
-    LOG4CPLUS_INFO(logger, "modes: " << data.pt_data->physical_modes.size());
-    LOG4CPLUS_INFO(logger, "validity pattern : " << data.pt_data->validity_patterns.size());
-    LOG4CPLUS_INFO(logger, "calendars: " << data.pt_data->calendars.size());
-    LOG4CPLUS_INFO(logger, "synonyms : " << data.geo_ref->synonyms.size());
-    LOG4CPLUS_INFO(logger, "fare tickets: " << data.fare->fare_map.size());
-    LOG4CPLUS_INFO(logger, "fare transitions: " << data.fare->nb_transitions());
-    LOG4CPLUS_INFO(logger, "fare od: " << data.fare->od_tickets.size());
-    LOG4CPLUS_INFO(logger, "Begin to save ...");
+    return save_data(data, output, read) ? 0 : 1;
+}
 
-    start = pt::microsec_clock::local_time();
+bool ed2nav_from_data(const ed::Data& ed_data,
+                      const std::string& output,
+                      const std::string& connection_string,
+                      const std::string& cities_connection_string,
+                      const double min_non_connected_graph_ratio,
+                      const bool export_georef_edges_geometries) {
+    auto logger = log4cplus::Logger::getInstance("log");
+    const auto start = pt::microsec_clock::local_time();
 
-    if (!write_data_to_file(output, data)) {
-        LOG4CPLUS_ERROR(logger, "Exiting ed2nav with errors");
-        return 1;
+    navitia::type::Data data;
+    ed::EdReader reader(connection_string);
+
+    if (!cities_connection_string.empty()) {
+        data.find_admins = FindAdminWithCities(cities_connection_string, *data.geo_ref);
     }
-    save = (pt::microsec_clock::local_time() - start).total_milliseconds();
 
-    LOG4CPLUS_INFO(logger, "Computing times");
-    LOG4CPLUS_INFO(logger, "\t File reading: " << read << "ms");
-    LOG4CPLUS_INFO(logger, "\t Data writing: " << save << "ms");
+    try {
+        ed::EdConverter converter;
+        converter.fill(ed_data, data);
+        reader.fill_georef(data, min_non_connected_graph_ratio, export_georef_edges_geometries);
+        converter.fill_admin_stop_areas(ed_data, data, reader.admin_by_insee_code);
+        reader.check_coherence(data);
+    } catch (const navitia::exception& e) {
+        LOG4CPLUS_ERROR(logger, "error while converting the data " << e.what());
+        LOG4CPLUS_ERROR(logger, "stack: " << e.backtrace());
+        throw;
+    }
+
+    const int read = (pt::microsec_clock::local_time() - start).total_milliseconds();
 
-    return 0;
+    return save_data(data, output, read);
 }
 
 }  // namespace ed
@@ -44,6 +44,8 @@ struct Data;
 
 namespace ed {
 
+class Data;
+
 template <class T = navitia::type::Data>
 bool try_save_file(const std::string& filename, const T& data) {
     auto logger = log4cplus::Logger::getInstance("ed2nav::try_save_file");
@@ -63,4 +65,16 @@ template <class T = navitia::type::Data>
 bool write_data_to_file(const std::string& output_filename, const T& data);
 int ed2nav(int argc, const char** argv);
 
+/**
+ * Write the .nav file of the data read by a connector without storing them in the ED database first
+ *
+ * The street network, the admins and the pois are still read from the database given by connection_string
+ */
+bool ed2nav_from_data(const ed::Data& ed_data,
+                      const std::string& output,
+                      const std::string& connection_string,
+                      const std::string& cities_connection_string,
+                      const double min_non_connected_graph_ratio,
+                      const bool export_georef_edges_geometries);
+
 }  // namespace ed
@@ -0,0 +1,869 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "ed_converter.h"
+
+#include "type/meta_data.h"
+#include "type/network.h"
+#include "type/company.h"
+#include "type/contributor.h"
+#include "type/commercial_mode.h"
+#include "type/dataset.h"
+#include "utils/base64_encode.h"
+#include "utils/exception.h"
+#include "utils/functions.h"
+
+#include <boost/geometry.hpp>
+#include <boost/range/algorithm/find.hpp>
+
+#include <iomanip>
+#include <sstream>
+
+namespace ed {
+
+namespace bt = boost::posix_time;
+namespace nt = navitia::type;
+namespace ng = navitia::georef;
+namespace nf = navitia::fare;
+
+// the coordinates are written in the ED database with the 6 decimals of std::to_string
+static nt::GeographicalCoord as_persisted(const nt::GeographicalCoord& coord) {
+    return {std::stod(std::to_string(coord.lon())), std::stod(std::to_string(coord.lat()))};
+}
+
+// the geometries are written in the ED database as WKT with 16 significant digits (and read back as WKB)
+template <typename Geometry>
+static Geometry as_persisted(const Geometry& geometry) {
+    if (boost::geometry::is_empty(geometry)) {
+        return geometry;
+    }
+    std::stringstream wkt;
+    wkt << std::setprecision(16) << boost::geometry::wkt(geometry);
+    Geometry res;
+    boost::geometry::read_wkt(wkt.str(), res);
+    return res;
+}
+
+// A function to release the memory of a collection, like in EdReader
+template <typename T>
+static void release(T& a) {
+    T b;
+    a.swap(b);
+}
+
+void EdConverter::fill(const ed::Data& ed_data, navitia::type::Data& data) {
+    this->fill_meta(ed_data, data);
+    this->fill_feed_infos(ed_data, data);
+    this->fill_timezones(ed_data, data);
+    this->fill_networks(ed_data, data);
+    this->fill_commercial_modes(ed_data, data);
+    this->fill_physical_modes(ed_data, data);
+    this->fill_companies(ed_data, data);
+    this->fill_contributors(ed_data, data);
+    this->fill_datasets(ed_data, data);
+
+    this->fill_stop_areas(ed_data, data);
+    this->fill_stop_points(ed_data, data);
+
+    this->fill_lines(ed_data, data);
+    this->fill_line_groups(ed_data, data);
+    this->fill_routes(ed_data, data);
+    this->fill_validity_patterns(ed_data, data);
+
+    this->fill_comments(ed_data, data);
+    this->fill_shapes(ed_data);
+    this->fill_stop_times(ed_data);
+    this->fill_vehicle_journeys(ed_data, data);
+    this->finish_stop_times(data);
+
+    this->fill_calendars(ed_data, data);
+
+    this->fill_associated_calendars(ed_data, data);
+    this->fill_meta_vehicle_journeys(ed_data, data);
+
+    this->fill_object_codes(ed_data, data);
+    this->fill_stop_point_connections(ed_data, data);
+
+    this->fill_prices(ed_data, data);
+    this->fill_transitions(ed_data, data);
+    this->fill_origin_destinations(ed_data, data);
+}
+
+void EdConverter::fill_meta(const ed::Data& ed_data, navitia::type::Data& data) {
+    if (ed_data.meta.production_date.is_null()) {
+        throw navitia::exception("the production period is empty, we cannot create a nav file");
+    }
+    data.meta->production_date = ed_data.meta.production_date;
+}
+
+void EdConverter::fill_feed_infos(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto& feed_info : ed_data.feed_infos) {
+        if (feed_info.first == "feed_publisher_name") {
+            data.meta->publisher_name = feed_info.second;
+        }
+        if (feed_info.first == "feed_publisher_url") {
+            data.meta->publisher_url = feed_info.second;
+        }
+        if (feed_info.first == "feed_license") {
+            data.meta->license = feed_info.second;
+        }
+        if (feed_info.first == "feed_creation_datetime") {
+            try {
+                data.meta->dataset_created_at = bt::from_iso_string(feed_info.second);
+            } catch (const std::out_of_range&) {
+                LOG4CPLUS_INFO(log, "feed_creation_datetime is not valid");
+            }
+        }
+    }
+}
+
+void EdConverter::fill_timezones(const ed::Data& ed_data, navitia::type::Data& data) {
+    // in the ED part there can be only one TZ by construction
+    const auto& tz_handler = ed_data.tz_wrapper.tz_handler;
+    const auto dst_periods = tz_handler.get_periods_and_shift();
+    if (dst_periods.empty()) {
+        return;
+    }
+    timezone = data.pt_data->tz_manager.get_or_create(tz_handler.tz_name, data.meta->production_date.begin(),
+                                                      dst_periods);
+}
+
+void EdConverter::fill_networks(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto* ed_network : ed_data.networks) {
+        auto* network = new nt::Network();
+        network->uri = navitia::encode_uri(ed_network->uri);
+        network->name = ed_network->name;
+        network->sort = ed_network->sort;
+        network->website = ed_network->website;
+        network->idx = data.pt_data->networks.size();
+
+        data.pt_data->networks.push_back(network);
+        this->network_map[ed_network->idx] = network;
+    }
+}
+
+void EdConverter::fill_commercial_modes(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto* ed_mode : ed_data.commercial_modes) {
+        auto* mode = new nt::CommercialMode();
+        mode->uri = navitia::encode_uri(ed_mode->uri);
+        mode->name = ed_mode->name;
+        mode->idx = data.pt_data->commercial_modes.size();
+
+        data.pt_data->commercial_modes.push_back(mode);
+        this->commercial_mode_map[ed_mode->idx] = mode;
+    }
+}
+
+void EdConverter::fill_physical_modes(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto* ed_mode : ed_data.physical_modes) {
+        auto* mode = new nt::PhysicalMode();
+        mode->uri = navitia::encode_uri(ed_mode->uri);
+        mode->name = ed_mode->name;
+        mode->co2_emission = ed_mode->co2_emission;
+        mode->idx = data.pt_data->physical_modes.size();
+
+        data.pt_data->physical_modes.push_back(mode);
+        this->physical_mode_map[ed_mode->idx] = mode;
+    }
+}
+
+void EdConverter::fill_companies(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto* ed_company : ed_data.companies) {
+        auto* company = new nt::Company();
+        company->uri = navitia::encode_uri(ed_company->uri);
+        company->name = ed_company->name;
+        company->website = ed_company->website;
+        company->idx = data.pt_data->companies.size();
+
+        data.pt_data->companies.push_back(company);
+        this->company_map[ed_company->idx] = company;
+    }
+}
+
+void EdConverter::fill_contributors(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto* ed_contributor : ed_data.contributors) {
+        auto* contributor = new nt::Contributor();
+        contributor->uri = navitia::encode_uri(ed_contributor->uri);
+        contributor->name = ed_contributor->name;
+        contributor->website = ed_contributor->website;
+        contributor->license = ed_contributor->license;
+        contributor->idx = data.pt_data->contributors.size();
+
+        data.pt_data->contributors.push_back(contributor);
+        this->contributor_map[ed_contributor->idx] = contributor;
+    }
+}
+
+void EdConverter::fill_datasets(const ed::Data& ed_data, navitia::type::Data& data) {
+    size_t nb_unknown_contributor(0);
+    for (const auto* ed_dataset : ed_data.datasets) {
+        auto contributor_it = this->contributor_map.find(ed_dataset->contributor->idx);
+        if (contributor_it == this->contributor_map.end()) {
+            LOG4CPLUS_TRACE(log, "impossible to find contributor" << ed_dataset->contributor->idx
+                                                                  << ", we cannot assoicate it to dataset "
+                                                                  << ed_dataset->uri);
+            nb_unknown_contributor++;
+            continue;
+        }
+
+        auto* dataset = new nt::Dataset();
+        dataset->uri = navitia::encode_uri(ed_dataset->uri);
+        dataset->desc = ed_dataset->desc;
+        dataset->system = ed_dataset->system;
+        dataset->validation_period = ed_dataset->validation_period;
+        dataset->contributor = contributor_it->second;
+        dataset->idx = data.pt_data->datasets.size();
+
+        dataset->contributor->dataset_list.insert(dataset);
+        data.pt_data->datasets.push_back(dataset);
+        this->dataset_map[ed_dataset->idx] = dataset;
+    }
+    if (nb_unknown_contributor) {
+        LOG4CPLUS_WARN(log, nb_unknown_contributor << "contributor not found for dataset");
+    }
+}
+
+void EdConverter::fill_stop_areas(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto* ed_sa : ed_data.stop_areas) {
+        auto* sa = new nt::StopArea();
+        sa->uri = navitia::encode_uri(ed_sa->uri);
+        sa->name = ed_sa->name;
+        sa->timezone = ed_sa->time_zone_with_name.first;
+        sa->coord = as_persisted(ed_sa->coord);
+        sa->visible = ed_sa->visible;
+        sa->set_properties(ed_sa->properties());
+        sa->idx = data.pt_data->stop_areas.size();
+
+        data.pt_data->stop_areas.push_back(sa);
+        this->stop_area_map[ed_sa->idx] = sa;
+    }
+}
+
+void EdConverter::fill_stop_points(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto* ed_sp : ed_data.stop_points) {
+        auto* sp = new nt::StopPoint();
+        sp->uri = navitia::encode_uri(ed_sp->uri);
+        sp->name = ed_sp->name;
+        sp->fare_zone = ed_sp->fare_zone;
+        sp->platform_code = ed_sp->platform_code;
+        sp->is_zonal = ed_sp->is_zonal;
+        sp->coord = as_persisted(ed_sp->coord);
+        sp->set_properties(ed_sp->properties());
+        if (ed_sp->stop_area) {
+            sp->stop_area = stop_area_map[ed_sp->stop_area->idx];
+            sp->stop_area->stop_point_list.push_back(sp);
+        }
+        if (ed_sp->area && sp->is_zonal) {
+            data.pt_data->stop_points_by_area.insert(as_persisted(*ed_sp->area), sp);
+        }
+
+        data.pt_data->stop_points.push_back(sp);
+        this->stop_point_map[ed_sp->idx] = sp;
+    }
+}
+
+void EdConverter::fill_lines(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto* ed_line : ed_data.lines) {
+        if (!ed_line->network) {
+            // EdPersistor does not store them
+            LOG4CPLUS_INFO(log, "Line " + ed_line->uri + " ignored because it doesn't have any network");
+            continue;
+        }
+        auto* line = new nt::Line();
+        line->uri = navitia::encode_uri(ed_line->uri);
+        line->name = ed_line->name;
+        line->code = ed_line->code;
+        line->color = ed_line->color;
+        line->text_color = ed_line->text_color;
+        line->sort = ed_line->sort;
+        line->opening_time = ed_line->opening_time;
+        line->closing_time = ed_line->closing_time;
+
+        line->network = network_map[ed_line->network->idx];
+        line->network->line_list.push_back(line);
+
+        if (ed_line->commercial_mode) {
+            line->commercial_mode = commercial_mode_map[ed_line->commercial_mode->idx];
+            line->commercial_mode->line_list.push_back(line);
+        }
+
+        line->shape = as_persisted(ed_line->shape);
+
+        data.pt_data->lines.push_back(line);
+        this->line_map[ed_line->idx] = line;
+    }
+
+    // Add Object properties on lines
+    for (const auto& pt_property : ed_data.object_properties) {
+        if (pt_property.first.type != nt::Type_e::Line) {
+            continue;
+        }
+        auto line_it = this->line_map.find(pt_property.first.pt_object->idx);
+        if (line_it != this->line_map.end()) {
+            for (const auto& property : pt_property.second) {
+                line_it->second->properties[property.first] = property.second;
+            }
+        }
+    }
+}
+
+void EdConverter::fill_line_groups(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto* ed_line_group : ed_data.line_groups) {
+        auto* line_group = new nt::LineGroup();
+        line_group->uri = navitia::encode_uri(ed_line_group->uri);
+        line_group->name = ed_line_group->name;
+        line_group->main_line = this->line_map[ed_line_group->main_line->idx];
+        this->line_group_map[ed_line_group->idx] = line_group;
+        data.pt_data->line_groups.push_back(line_group);
+    }
+
+    for (const auto& link : ed_data.line_group_links) {
+        auto group_it = this->line_group_map.find(link.line_group->idx);
+        if (group_it != this->line_group_map.end()) {
+            auto line_it = this->line_map.find(link.line->idx);
+            if (line_it != this->line_map.end()) {
+                group_it->second->line_list.push_back(line_it->second);
+                line_it->second->line_group_list.push_back(group_it->second);
+            }
+        }
+    }
+}
+
+void EdConverter::fill_routes(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto* ed_route : ed_data.routes) {
+        auto* route = new nt::Route();
+        route->uri = navitia::encode_uri(ed_route->uri);
+        route->name = ed_route->name;
+        route->direction_type = ed_route->direction_type;
+        route->shape = as_persisted(ed_route->shape);
+
+        route->line = line_map[ed_route->line->idx];
+        route->line->route_list.push_back(route);
+
+        if (ed_route->destination) {
+            route->destination = stop_area_map[ed_route->destination->idx];
+        }
+
+        data.pt_data->routes.push_back(route);
+        this->route_map[ed_route->idx] = route;
+    }
+}
+
+void EdConverter::fill_validity_patterns(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto* ed_vp : ed_data.validity_patterns) {
+        // the validity patterns are stored as strings in ED, from the beginning of the production period
+        auto* validity_pattern = new nt::ValidityPattern(data.meta->production_date.begin(), ed_vp->days.to_string());
+        validity_pattern->idx = data.pt_data->validity_patterns.size();
+
+        data.pt_data->validity_patterns.push_back(validity_pattern);
+        this->validity_pattern_map[ed_vp->idx] = validity_pattern;
+    }
+}
+
+template <typename Map>
+static size_t add_comment(nt::Data& data, const idx_t obj_id, const Map& map, const nt::Comment& comment) {
+    const auto obj = find_or_default(obj_id, map);
+
+    if (!obj) {
+        return 1;
+    }
+
+    data.pt_data->comments.add(obj, comment);
+
+    return 0;
+}
+
+void EdConverter::fill_comments(const ed::Data& ed_data, navitia::type::Data& data) {
+    auto find_comment = [&](const std::string& comment_id, const idx_t obj_id) -> const nt::Comment* {
+        const auto it = ed_data.comment_by_id.find(comment_id);
+        if (it == ed_data.comment_by_id.end()) {
+            LOG4CPLUS_WARN(log, "impossible to find comment " << comment_id << " skipping comment for " << obj_id);
+            return nullptr;
+        }
+        return &it->second;
+    };
+
+    size_t cpt_not_found(0);
+    for (const auto& pt_obj_comments : ed_data.comments) {
+        const auto obj_id = pt_obj_comments.first.pt_object->idx;
+        for (const auto& comment_id : pt_obj_comments.second) {
+            const auto* comment = find_comment(comment_id, obj_id);
+            if (!comment) {
+                continue;
+            }
+            switch (pt_obj_comments.first.type) {
+                case nt::Type_e::Route:
+                    cpt_not_found += add_comment(data, obj_id, route_map, *comment);
+                    break;
+                case nt::Type_e::Line:
+                    cpt_not_found += add_comment(data, obj_id, line_map, *comment);
+                    break;
+                case nt::Type_e::LineGroup:
+                    cpt_not_found += add_comment(data, obj_id, line_group_map, *comment);
+                    break;
+                case nt::Type_e::StopArea:
+                    cpt_not_found += add_comment(data, obj_id, stop_area_map, *comment);
+                    break;
+                case nt::Type_e::StopPoint:
+                    cpt_not_found += add_comment(data, obj_id, stop_point_map, *comment);
+                    break;
+                case nt::Type_e::VehicleJourney:
+                    // as we need to create vjs after stop times, we need to store the comments
+                    vehicle_journey_comments[obj_id].push_back(*comment);
+                    break;
+                default:
+                    LOG4CPLUS_WARN(log, "invalid type, skipping object comment: " << obj_id);
+                    break;
+            }
+        }
+    }
+    for (const auto& st_comments : ed_data.stoptime_comments) {
+        for (const auto& comment_id : st_comments.second) {
+            const auto* comment = find_comment(comment_id, st_comments.first->idx);
+            if (comment) {
+                stop_time_comments[st_comments.first].push_back(*comment);
+            }
+        }
+    }
+    if (cpt_not_found) {
+        LOG4CPLUS_WARN(log, cpt_not_found << " pt object not found for comments");
+    }
+}
+
+void EdConverter::fill_shapes(const ed::Data& ed_data) {
+    for (const auto& ed_shape : ed_data.shapes_from_prev) {
+        this->shapes_map[ed_shape->idx] = boost::make_shared<nt::LineString>(as_persisted(ed_shape->geom));
+    }
+}
+
+void EdConverter::fill_stop_times(const ed::Data& ed_data) {
+    for (const auto* ed_st : ed_data.stops) {
+        if (!ed_st->vehicle_journey) {
+            continue;
+        }
+        const auto vj_id = ed_st->vehicle_journey->idx;
+        auto& sts = sts_from_vj[vj_id];
+        const size_t order = ed_st->order;
+        if (order + 1 > sts.size()) {
+            sts.resize(order + 1);
+        }
+        nt::StopTime& stop = sts[order];
+
+        stop.arrival_time = ed_st->arrival_time;
+        stop.departure_time = ed_st->departure_time;
+        stop.local_traffic_zone = ed_st->local_traffic_zone;
+        stop.set_date_time_estimated(ed_st->date_time_estimated);
+        stop.set_odt(ed_st->ODT);
+        stop.set_pick_up_allowed(ed_st->pick_up_allowed);
+        stop.set_drop_off_allowed(ed_st->drop_off_allowed);
+        stop.set_is_frequency(ed_st->is_frequency);
+
+        stop.stop_point = stop_point_map[ed_st->stop_point->idx];
+
+        if (ed_st->shape_from_prev) {
+            stop.shape_from_prev = this->shapes_map[ed_st->shape_from_prev->idx];
+        }
+
+        stop.boarding_time = ed_st->boarding_time;
+        stop.alighting_time = ed_st->alighting_time;
+
+        const StKey st_key = {vj_id, order};
+        if (!ed_st->headsign.empty()) {
+            stop_time_headsigns.emplace_back(st_key, ed_st->headsign);
+        }
+
+        // we check if we have some comments
+        const auto it_comments = stop_time_comments.find(ed_st);
+        if (it_comments != stop_time_comments.end()) {
+            stop_time_keys_with_comments.emplace_back(st_key, &it_comments->second);
+        }
+    }
+}
+
+void EdConverter::fill_vehicle_journeys(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto* ed_vj : ed_data.vehicle_journeys) {
+        auto* route = route_map[ed_vj->route->idx];
+        navitia::type::VehicleJourney* vj = nullptr;
+        std::string mvj_name = ed_vj->meta_vj_name;
+        if (mvj_name.empty()) {
+            mvj_name = ed_vj->name;
+        }
+        auto mvj = data.pt_data->meta_vjs.get_or_create(mvj_name);
+        const auto& vp = *validity_pattern_map[ed_vj->validity_pattern->idx];
+        const auto uri = navitia::encode_uri(ed_vj->uri);
+        const auto vj_id = ed_vj->idx;
+        if (ed_vj->is_frequency()) {
+            auto f_vj = mvj->create_frequency_vj(uri, ed_vj->name, ed_vj->realtime_level, vp, route,
+                                                 std::move(sts_from_vj[vj_id]), *data.pt_data);
+            f_vj->start_time = ed_vj->start_time;
+            f_vj->end_time = ed_vj->end_time;
+            f_vj->headway_secs = ed_vj->headway_secs;
+            vj = f_vj;
+        } else {
+            vj = mvj->create_discrete_vj(uri, ed_vj->name, ed_vj->realtime_level, vp, route,
+                                         std::move(sts_from_vj[vj_id]), *data.pt_data);
+        }
+        vj->odt_message = ed_vj->odt_message;
+        vj->vehicle_journey_type = ed_vj->vehicle_journey_type;
+        vj->physical_mode = physical_mode_map[ed_vj->physical_mode->idx];
+
+        if (ed_vj->company) {
+            vj->company = company_map[ed_vj->company->idx];
+        }
+        assert(vj->company);
+        assert(vj->route);
+
+        if (vj->route && vj->route->line && vj->company) {
+            if (boost::range::find(vj->route->line->company_list, vj->company) == vj->route->line->company_list.end()) {
+                vj->route->line->company_list.push_back(vj->company);
+            }
+            if (boost::range::find(vj->company->line_list, vj->route->line) == vj->company->line_list.end()) {
+                vj->company->line_list.push_back(vj->route->line);
+            }
+        }
+
+        vj->set_vehicles(ed_vj->vehicles());
+
+        data.pt_data->headsign_handler.change_name_and_register_as_headsign(*vj, vj->name);
+        vehicle_journey_map[vj_id] = vj;
+
+        // we check if we have some comments
+        const auto& it_comments = vehicle_journey_comments.find(vj_id);
+        if (it_comments != vehicle_journey_comments.end()) {
+            for (const auto& comment : it_comments->second) {
+                data.pt_data->comments.add(vj, comment);
+            }
+        }
+        if (ed_vj->dataset) {
+            auto dataset_it = this->dataset_map.find(ed_vj->dataset->idx);
+            if (dataset_it != this->dataset_map.end()) {
+                vj->dataset = dataset_it->second;
+                vj->dataset->vehiclejourney_list.insert(vj);
+            }
+        }
+    }
+
+    for (const auto* ed_vj : ed_data.vehicle_journeys) {
+        if (ed_vj->prev_vj) {
+            vehicle_journey_map[ed_vj->idx]->prev_vj = vehicle_journey_map[ed_vj->prev_vj->idx];
+        }
+        if (ed_vj->next_vj) {
+            vehicle_journey_map[ed_vj->idx]->next_vj = vehicle_journey_map[ed_vj->next_vj->idx];
+        }
+    }
+    release(sts_from_vj);
+    release(vehicle_journey_comments);
+}
+
+void EdConverter::finish_stop_times(navitia::type::Data& data) {
+    auto get_st = [&](const StKey& st_key) -> const nt::StopTime& {
+        return vehicle_journey_map.at(st_key.first)->stop_time_list.at(st_key.second);
+    };
+    for (const auto& headsign : stop_time_headsigns) {
+        data.pt_data->headsign_handler.affect_headsign_to_stop_time(get_st(headsign.first), headsign.second);
+    }
+    for (const auto& comments : stop_time_keys_with_comments) {
+        for (const auto& comment : *comments.second) {
+            data.pt_data->comments.add(get_st(comments.first), comment);
+        }
+    }
+    release(stop_time_headsigns);
+    release(stop_time_keys_with_comments);
+    release(stop_time_comments);
+}
+
+void EdConverter::fill_calendars(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto* ed_cal : ed_data.calendars) {
+        auto* cal = new navitia::type::Calendar(data.meta->production_date.begin());
+        cal->name = ed_cal->name;
+        // the calendar uris are base64 encoded in ED
+        cal->uri = navitia::base64_encode(ed_cal->uri);
+        cal->week_pattern = ed_cal->week_pattern;
+        cal->active_periods = ed_cal->period_list;
+        cal->exceptions = ed_cal->exceptions;
+
+        data.pt_data->calendars.push_back(cal);
+        calendar_map[ed_cal->idx] = cal;
+    }
+
+    for (const auto* ed_cal : ed_data.calendars) {
+        auto* cal = calendar_map[ed_cal->idx];
+        for (const auto* ed_line : ed_cal->line_list) {
+            auto* line = find_or_default(ed_line->idx, line_map);
+            if (line) {
+                line->calendar_list.push_back(cal);
+            } else {
+                LOG4CPLUS_WARN(log, "impossible to find line " << ed_line->idx);
+            }
+        }
+    }
+}
+
+void EdConverter::fill_associated_calendars(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto& meta_vj_pair : ed_data.meta_vj_map) {
+        for (const auto& name_associated_calendar : meta_vj_pair.second.associated_calendars) {
+            const auto* ed_associated_calendar = name_associated_calendar.second;
+
+            const auto calendar_it = this->calendar_map.find(ed_associated_calendar->calendar->idx);
+            if (calendar_it == this->calendar_map.end()) {
+                LOG4CPLUS_ERROR(log, "Impossible to find the calendar " << ed_associated_calendar->calendar->idx
+                                                                        << ", we won't add associated calendar");
+                continue;
+            }
+
+            auto* associated_calendar = new nt::AssociatedCalendar();
+            associated_calendar->calendar = calendar_it->second;
+            associated_calendar->exceptions = ed_associated_calendar->exceptions;
+            data.pt_data->associated_calendars.push_back(associated_calendar);
+            this->associated_calendar_map[ed_associated_calendar->idx] = associated_calendar;
+        }
+    }
+}
+
+void EdConverter::fill_meta_vehicle_journeys(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto& meta_vj_pair : ed_data.meta_vj_map) {
+        const std::string& name = meta_vj_pair.first;
+        nt::MetaVehicleJourney* meta_vj = data.pt_data->meta_vjs.get_mut(name);
+        if (meta_vj == nullptr) {
+            throw navitia::exception("impossible to find metavj " + name + " data are not valid");
+        }
+
+        for (const auto& name_associated_calendar : meta_vj_pair.second.associated_calendars) {
+            const auto* ed_associated_calendar = name_associated_calendar.second;
+            auto it_ac = this->associated_calendar_map.find(ed_associated_calendar->idx);
+            if (it_ac == this->associated_calendar_map.end()) {
+                LOG4CPLUS_ERROR(log, "Impossible to find the associated calendar " << ed_associated_calendar->idx
+                                                                                   << ", we won't add it to meta vj");
+            } else {
+                // ED links the meta vjs to the associated calendars by the uri of their calendar
+                meta_vj->associated_calendars[it_ac->second->calendar->uri] = it_ac->second;
+            }
+        }
+
+        if (!timezone) {
+            throw navitia::exception("impossible to find the timezone of metavj " + name
+                                     + " data is in an invalid state");
+        }
+        meta_vj->tz_handler = timezone;
+    }
+}
+
+template <typename Map>
+static void add_codes(const Map& map,
+                      const idx_t obj_id,
+                      const std::map<std::string, std::vector<std::string>>& codes,
+                      nt::Data& data) {
+    auto search = map.find(obj_id);
+    if (search == map.end()) {
+        return;
+    }
+    for (const auto& key_values : codes) {
+        for (const auto& value : key_values.second) {
+            data.pt_data->codes.add(search->second, key_values.first, value);
+        }
+    }
+}
+
+void EdConverter::fill_object_codes(const ed::Data& ed_data, navitia::type::Data& data) {
+    size_t count = 0;
+    for (const auto& object_codes : ed_data.object_codes) {
+        const auto obj_id = object_codes.first.pt_object->idx;
+        if (obj_id == nt::invalid_idx) {
+            ++count;
+            continue;
+        }
+        switch (object_codes.first.type) {
+            case nt::Type_e::StopArea:
+                add_codes(this->stop_area_map, obj_id, object_codes.second, data);
+                break;
+            case nt::Type_e::Network:
+                add_codes(this->network_map, obj_id, object_codes.second, data);
+                break;
+            case nt::Type_e::Company:
+                add_codes(this->company_map, obj_id, object_codes.second, data);
+                break;
+            case nt::Type_e::Line:
+                add_codes(this->line_map, obj_id, object_codes.second, data);
+                break;
+            case nt::Type_e::Route:
+                add_codes(this->route_map, obj_id, object_codes.second, data);
+                break;
+            case nt::Type_e::VehicleJourney:
+                add_codes(this->vehicle_journey_map, obj_id, object_codes.second, data);
+                break;
+            case nt::Type_e::StopPoint:
+                add_codes(this->stop_point_map, obj_id, object_codes.second, data);
+                break;
+            case nt::Type_e::Calendar:
+                add_codes(this->calendar_map, obj_id, object_codes.second, data);
+                break;
+            default:
+                break;
+        }
+    }
+    if (count > 0) {
+        LOG4CPLUS_INFO(log, count << "/" << ed_data.object_codes.size() << " object codes ignored.");
+    }
+}
+
+void EdConverter::fill_stop_point_connections(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto* ed_connection : ed_data.stop_point_connections) {
+        auto it_departure = stop_point_map.find(ed_connection->departure->idx);
+        auto it_destination = stop_point_map.find(ed_connection->destination->idx);
+        if (it_departure == stop_point_map.end() || it_destination == stop_point_map.end()) {
+            continue;
+        }
+        auto* stop_point_connection = new nt::StopPointConnection();
+        stop_point_connection->departure = it_departure->second;
+        stop_point_connection->destination = it_destination->second;
+        stop_point_connection->connection_type = ed_connection->connection_kind;
+        stop_point_connection->display_duration = ed_connection->display_duration;
+        stop_point_connection->duration = ed_connection->duration;
+        stop_point_connection->max_duration = ed_connection->max_duration;
+        stop_point_connection->set_properties(ed_connection->properties());
+
+        data.pt_data->stop_point_connections.push_back(stop_point_connection);
+
+        // add the connection in the stop points
+        stop_point_connection->departure->stop_point_connection_list.push_back(stop_point_connection);
+        stop_point_connection->destination->stop_point_connection_list.push_back(stop_point_connection);
+    }
+}
+
+void EdConverter::fill_admin_stop_areas(const ed::Data& ed_data,
+                                        navitia::type::Data& data,
+                                        const std::unordered_map<std::string, ng::Admin*>& admin_by_insee_code) {
+    size_t nb_unknown_admin(0), nb_unknown_stop(0), nb_valid_admin(0);
+
+    for (const auto* admin_stop_area : ed_data.admin_stop_areas) {
+        for (const auto* ed_sa : admin_stop_area->stop_area) {
+            auto it_admin = admin_by_insee_code.find(admin_stop_area->admin);
+            if (it_admin == admin_by_insee_code.end()) {
+                LOG4CPLUS_TRACE(log, "impossible to find admin " << admin_stop_area->admin
+                                                                 << ", we cannot associate stop_area " << ed_sa->uri
+                                                                 << " to it");
+                nb_unknown_admin++;
+                continue;
+            }
+            auto it_sa = stop_area_map.find(ed_sa->idx);
+            if (it_sa == stop_area_map.end()) {
+                LOG4CPLUS_TRACE(log, "impossible to find stop_area " << ed_sa->uri
+                                                                     << ", we cannot associate it to admin "
+                                                                     << admin_stop_area->admin);
+                nb_unknown_stop++;
+                continue;
+            }
+
+            data.pt_data->admin_main_stop_areas[it_admin->second->idx].push_back(it_sa->second);
+            nb_valid_admin++;
+        }
+    }
+    LOG4CPLUS_INFO(log, nb_valid_admin << " admin with at least one main stop");
+
+    if (nb_unknown_admin) {
+        LOG4CPLUS_WARN(log, nb_unknown_admin << " admin not found for admin main stops");
+    }
+    if (nb_unknown_stop) {
+        LOG4CPLUS_WARN(log, nb_unknown_stop << " stops not found for admin main stops");
+    }
+}
+
+// Fares:
+void EdConverter::fill_prices(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto& ticket_it : ed_data.fare_map) {
+        const nf::DateTicket& tickets = ticket_it.second;
+        assert(!tickets.tickets.empty());  // by construction there has to be at least one ticket
+
+        // ED stores the caption and the comment of a ticket once for all its periods
+        const auto& first_ticket = tickets.tickets.front().ticket;
+        for (const auto& dated_ticket : tickets.tickets) {
+            nf::Ticket ticket;
+            ticket.key = dated_ticket.ticket.key;
+            ticket.caption = first_ticket.caption;
+            ticket.comment = first_ticket.comment;
+            ticket.currency = dated_ticket.ticket.currency;
+            ticket.value.value = dated_ticket.ticket.value.value;
+
+            nf::DateTicket& date_ticket = data.fare->fare_map[ticket.key];
+            date_ticket.add(dated_ticket.validity_period.begin(), dated_ticket.validity_period.end(), ticket);
+        }
+    }
+}
+
+void EdConverter::fill_transitions(const ed::Data& ed_data, navitia::type::Data& data) {
+    // we build the transition graph
+    std::map<nf::State, nf::Fare::vertex_t> state_map;
+    nf::State begin;  // Start is an empty node (and the node is already is the fare graph, since it has been added in
+                      // the constructor with the default ticket)
+    state_map[begin] = data.fare->begin_v;
+
+    auto get_or_create_vertex = [&](const nf::State& state) {
+        auto it = state_map.find(state);
+        if (it != state_map.end()) {
+            return it->second;
+        }
+        const auto v = boost::add_vertex(state, data.fare->g);
+        state_map[state] = v;
+        return v;
+    };
+
+    // EdPersistor stores the transitions without ticket after the others
+    for (const bool with_ticket : {true, false}) {
+        for (const auto& transition_tuple : ed_data.transitions) {
+            const nf::Transition& ed_transition = std::get<2>(transition_tuple);
+            if (ed_transition.ticket_key.empty() == with_ticket) {
+                continue;
+            }
+            nf::Transition transition;
+            transition.start_conditions = ed_transition.start_conditions;
+            transition.end_conditions = ed_transition.end_conditions;
+            transition.global_condition = ed_transition.global_condition;
+            transition.ticket_key = ed_transition.ticket_key;
+
+            const auto start_v = get_or_create_vertex(std::get<0>(transition_tuple));
+            const auto end_v = get_or_create_vertex(std::get<1>(transition_tuple));
+
+            // add the edge to the fare graph
+            boost::add_edge(start_v, end_v, transition, data.fare->g);
+        }
+    }
+}
+
+void EdConverter::fill_origin_destinations(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto& origin_ticket : ed_data.od_tickets) {
+        for (const auto& destination_ticket : origin_ticket.second) {
+            for (const auto& ticket : destination_ticket.second) {
+                data.fare->od_tickets[origin_ticket.first][destination_ticket.first].push_back(ticket);
+            }
+        }
+    }
+}
+
+}  // namespace ed
@@ -0,0 +1,132 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "data.h"
+#include "type/data.h"
+
+#include <log4cplus/logger.h>
+#include <boost/shared_ptr.hpp>
+
+#include <unordered_map>
+
+namespace navitia {
+namespace georef {
+struct Admin;
+}
+}  // namespace navitia
+
+namespace ed {
+
+/**
+ * Build the public transport part of a navitia::type::Data straight from the data of a connector
+ *
+ * It does the same work as EdReader without storing the data in the ED database and reading them back: the objects
+ * are created in the same order and with the same transformations as the database round trip (encoded uris, rounded
+ * coordinates and geometries...) so the .nav file is the same.
+ * The georef is not built by the connectors, it has to be read from the database with EdReader::fill_georef
+ */
+struct EdConverter {
+    void fill(const ed::Data& ed_data, navitia::type::Data& data);
+
+    // the admins are read with the georef, their main stop areas are thus attached afterward
+    void fill_admin_stop_areas(const ed::Data& ed_data,
+                               navitia::type::Data& data,
+                               const std::unordered_map<std::string, navitia::georef::Admin*>& admin_by_insee_code);
+
+private:
+    // the objects created by ed idx (which is their id in the ED database)
+    std::unordered_map<idx_t, navitia::type::Network*> network_map;
+    std::unordered_map<idx_t, navitia::type::CommercialMode*> commercial_mode_map;
+    std::unordered_map<idx_t, navitia::type::PhysicalMode*> physical_mode_map;
+    std::unordered_map<idx_t, navitia::type::Company*> company_map;
+    std::unordered_map<idx_t, navitia::type::Contributor*> contributor_map;
+    std::unordered_map<idx_t, navitia::type::Dataset*> dataset_map;
+    std::unordered_map<idx_t, navitia::type::StopArea*> stop_area_map;
+    std::unordered_map<idx_t, navitia::type::StopPoint*> stop_point_map;
+    std::unordered_map<idx_t, navitia::type::Line*> line_map;
+    std::unordered_map<idx_t, navitia::type::LineGroup*> line_group_map;
+    std::unordered_map<idx_t, navitia::type::Route*> route_map;
+    std::unordered_map<idx_t, navitia::type::ValidityPattern*> validity_pattern_map;
+    std::unordered_map<idx_t, navitia::type::VehicleJourney*> vehicle_journey_map;
+    std::unordered_map<idx_t, navitia::type::Calendar*> calendar_map;
+    std::unordered_map<idx_t, navitia::type::AssociatedCalendar*> associated_calendar_map;
+    std::unordered_map<idx_t, boost::shared_ptr<navitia::type::LineString>> shapes_map;
+    const navitia::type::TimeZoneHandler* timezone = nullptr;
+
+    // stop_times by vj idx
+    std::unordered_map<idx_t, std::vector<navitia::type::StopTime>> sts_from_vj;
+
+    // the comments and headsigns of the stop times are added once their vj is created
+    std::unordered_map<idx_t, std::vector<navitia::type::Comment>> vehicle_journey_comments;
+    std::unordered_map<const types::StopTime*, std::vector<navitia::type::Comment>> stop_time_comments;
+    using StKey = std::pair<idx_t, uint16_t>;  // idx ed vj, order stop time
+    std::vector<std::pair<StKey, std::string>> stop_time_headsigns;
+    std::vector<std::pair<StKey, const std::vector<navitia::type::Comment>*>> stop_time_keys_with_comments;
+
+    void fill_meta(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_feed_infos(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_timezones(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_networks(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_commercial_modes(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_physical_modes(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_companies(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_contributors(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_datasets(const ed::Data& ed_data, navitia::type::Data& data);
+
+    void fill_stop_areas(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_stop_points(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_lines(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_line_groups(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_routes(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_validity_patterns(const ed::Data& ed_data, navitia::type::Data& data);
+
+    void fill_comments(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_shapes(const ed::Data& ed_data);
+    void fill_stop_times(const ed::Data& ed_data);
+    void fill_vehicle_journeys(const ed::Data& ed_data, navitia::type::Data& data);
+    void finish_stop_times(navitia::type::Data& data);
+
+    void fill_calendars(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_associated_calendars(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_meta_vehicle_journeys(const ed::Data& ed_data, navitia::type::Data& data);
+
+    void fill_object_codes(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_stop_point_connections(const ed::Data& ed_data, navitia::type::Data& data);
+
+    void fill_prices(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_transitions(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_origin_destinations(const ed::Data& ed_data, navitia::type::Data& data);
+
+    log4cplus::Logger log = log4cplus::Logger::getInstance("log");
+};
+
+}  // namespace ed
@@ -117,6 +117,13 @@ void EdPersistor::persist(const ed::Georef& data) {
     LOG4CPLUS_INFO(logger, "End: commit");
 }
 
+/*
+ * Every import of georef data changes the version, ed2nav reads the georef again from the database only when it changes
+ */
+std::string EdPersistor::new_georef_version() {
+    return boost::posix_time::to_iso_extended_string(boost::posix_time::microsec_clock::universal_time());
+}
+
 std::string EdPersistor::to_geographic_point(const navitia::type::GeographicalCoord& coord) const {
     std::stringstream geog;
     geog << std::setprecision(10) << "POINT(" << coord.lon() << " " << coord.lat() << ")";
@@ -417,6 +424,7 @@ void EdPersistor::persist_synonym(const std::map<std::string, std::string>& data
     this->clean_synonym();
     LOG4CPLUS_INFO(logger, "Begin: insert synonyms");
     this->insert_synonyms(data);
+    this->lotus.exec(Lotus::make_upsert_string("navitia.parameters", {{"georef_version", new_georef_version()}}));
     LOG4CPLUS_INFO(logger, "Begin: commit");
     this->lotus.commit();
     LOG4CPLUS_INFO(logger, "End: commit");
@@ -449,7 +457,7 @@ void EdPersistor::insert_metadata(const navitia::type::MetaData& meta) {
 void EdPersistor::insert_metadata_georef() {
     // If we do one poi2ed, we don't want to read pois from OSM anymore
     std::vector<std::pair<std::string, std::string>> values = {
-        {"parse_pois_from_osm", (is_osm_reader && parse_pois) ? "t" : "f"}};
+        {"parse_pois_from_osm", (is_osm_reader && parse_pois) ? "t" : "f"}, {"georef_version", new_georef_version()}};
 
     if (!street_network_source.empty()) {
         values.emplace_back("street_network_source", street_network_source);
@@ -137,6 +137,7 @@ private:
     void clean_db();
 
     std::string to_geographic_point(const navitia::type::GeographicalCoord& coord) const;
+    static std::string new_georef_version();
 
     size_t default_timezone_idx = 0;
 };
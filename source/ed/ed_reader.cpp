@@ -30,19 +30,25 @@ www.navitia.io
 
 #include "ed_reader.h"
 
+#include "ed/georef_cache.h"
 #include "ed/connectors/fare_utils.h"
+#include "ed/connectors/wkb_reader.h"
 #include "type/meta_data.h"
 #include "type/network.h"
 #include "type/company.h"
 #include "type/contributor.h"
 #include "type/commercial_mode.h"
 #include "type/dataset.h"
+#include "georef/georef.h"
 
 #include <boost/foreach.hpp>
 #include <boost/geometry.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/range/algorithm/find.hpp>
 #include <boost/smart_ptr/shared_ptr.hpp>
+
+#include <functional>
+#include <future>
 namespace ed {
 
 namespace bg = boost::gregorian;
@@ -60,12 +66,89 @@ static void release(T& a) {
     a.swap(b);
 }
 
+namespace {
+
+void log_throughput(log4cplus::Logger& log, const std::string& name, size_t nb_rows, const bt::ptime& start) {
+    const auto duration = (bt::microsec_clock::local_time() - start).total_milliseconds();
+    LOG4CPLUS_INFO(log, name << ": " << nb_rows << " rows read in " << duration << "ms ("
+                             << nb_rows * 1000 / std::max<int64_t>(duration, 1) << " rows/s)");
+}
+
+// all the transactions reading the database are in repeatable read to see the same snapshot
+void begin_snapshot_transaction(pqxx::work& work) {
+    work.exec("SET TRANSACTION ISOLATION LEVEL REPEATABLE READ, READ ONLY;");
+}
+
+}  // namespace
+
 void EdReader::fill(navitia::type::Data& data,
                     const double min_non_connected_graph_ratio,
                     const bool export_georef_edges_geometries) {
     pqxx::work work(*conn, "loading ED");
 
-    this->fill_vector_to_ignore(work, min_non_connected_graph_ratio);
+    if (nb_connections <= 1) {
+        this->fill_pt(data, work);
+        this->read_georef(data, work, min_non_connected_graph_ratio, export_georef_edges_geometries);
+        this->fill_admin_stop_areas(data, work);
+        this->fill_fares(data, work);
+        check_coherence(data);
+        return;
+    }
+
+    // the other connections import the snapshot of the main transaction, so that every part is read from the same
+    // state of the database
+    begin_snapshot_transaction(work);
+    const pqxx::result snapshot_result = work.exec("SELECT pg_export_snapshot() AS snapshot;");
+    const auto snapshot = snapshot_result.begin()["snapshot"].as<std::string>();
+    LOG4CPLUS_INFO(log, "reading the database on " << std::min<size_t>(nb_connections, 3)
+                                                   << " connections, snapshot " << snapshot);
+
+    // the georef and the fares do not touch the public transport objects, nor the maps of the public transport
+    // part, they can thus be read at the same time
+    auto read_on_own_connection = [&](const std::string& name, const std::function<void(pqxx::work&)>& read) {
+        const auto start = bt::microsec_clock::local_time();
+        try {
+            pqxx::connection other_conn(connection_string);
+            pqxx::work other_work(other_conn, name);
+            begin_snapshot_transaction(other_work);
+            other_work.exec("SET TRANSACTION SNAPSHOT " + other_work.quote(snapshot) + ";");
+            read(other_work);
+        } catch (const pqxx::pqxx_exception& e) {
+            throw navitia::exception(e.base().what());
+        }
+        LOG4CPLUS_INFO(log, name << " done in " << (bt::microsec_clock::local_time() - start).total_milliseconds()
+                                 << "ms");
+    };
+
+    auto georef = std::async(std::launch::async, read_on_own_connection, "loading ED georef", [&](pqxx::work& w) {
+        this->read_georef(data, w, min_non_connected_graph_ratio, export_georef_edges_geometries);
+    });
+    std::future<void> fares;
+    if (nb_connections >= 3) {
+        fares = std::async(std::launch::async, read_on_own_connection, "loading ED fares",
+                           [&](pqxx::work& w) { this->fill_fares(data, w); });
+    }
+
+    const auto start = bt::microsec_clock::local_time();
+    this->fill_pt(data, work);
+    LOG4CPLUS_INFO(log, "loading ED public transport done in "
+                            << (bt::microsec_clock::local_time() - start).total_milliseconds() << "ms");
+    if (!fares.valid()) {
+        this->fill_fares(data, work);
+    }
+
+    // get() rethrows the errors of the other connections
+    georef.get();
+    if (fares.valid()) {
+        fares.get();
+    }
+
+    // needs both the stop areas and the admins
+    this->fill_admin_stop_areas(data, work);
+    check_coherence(data);
+}
+
+void EdReader::fill_pt(navitia::type::Data& data, pqxx::work& work) {
     this->fill_meta(data, work);
     // TODO merge fill_feed_infos, fill_meta
     this->fill_feed_infos(data, work);
@@ -105,13 +188,70 @@ void EdReader::fill(navitia::type::Data& data,
     this->fill_associated_calendar(data, work);
     this->fill_meta_vehicle_journeys(data, work);
 
-    this->fill_admins(data, work);
-    this->fill_admins_postal_codes(data, work);
-    this->fill_admin_stop_areas(data, work);
     this->fill_object_codes(data, work);
 
     //@TODO: les connections ont des doublons, en attendant que ce soit corrigé, on ne les enregistre pas
     this->fill_stop_point_connections(data, work);
+}
+
+void EdReader::fill_fares(navitia::type::Data& data, pqxx::work& work) {
+    this->fill_prices(data, work);
+    this->fill_transitions(data, work);
+    this->fill_origin_destinations(data, work);
+}
+
+void EdReader::fill_georef(navitia::type::Data& data,
+                           const double min_non_connected_graph_ratio,
+                           const bool export_georef_edges_geometries) {
+    pqxx::work work(*conn, "loading georef");
+
+    this->read_georef(data, work, min_non_connected_graph_ratio, export_georef_edges_geometries);
+}
+
+void EdReader::read_georef(navitia::type::Data& data,
+                           pqxx::work& work,
+                           const double min_non_connected_graph_ratio,
+                           const bool export_georef_edges_geometries) {
+    this->fill_georef_meta(data, work);
+
+    const auto version = georef_version(work, min_non_connected_graph_ratio, export_georef_edges_geometries);
+    data.meta->georef_version = version;
+    const bool use_cache = !georef_cache.empty() && !version.empty();
+    const GeorefCache cache(georef_cache);
+    if (use_cache && cache.load(data, version, admin_by_insee_code)) {
+        return;
+    }
+    this->load_georef(data, work, min_non_connected_graph_ratio, export_georef_edges_geometries);
+    if (use_cache) {
+        cache.save(data, version);
+    }
+}
+
+/*
+ * The georef read from the database only depends on the georef tables, whose version is changed by every import
+ * (osm2ed, geopal2ed, poi2ed, synonym2ed), and on the options of the reading
+ */
+std::string EdReader::georef_version(pqxx::work& work,
+                                     const double min_non_connected_graph_ratio,
+                                     const bool export_georef_edges_geometries) {
+    const pqxx::result result = work.exec("SELECT georef_version FROM navitia.parameters");
+    if (result.empty() || result.begin()["georef_version"].is_null()) {
+        LOG4CPLUS_INFO(log, "no georef version in the database, the georef won't be reused");
+        return "";
+    }
+    return GeorefCache::key(result.begin()["georef_version"].as<std::string>(), min_non_connected_graph_ratio,
+                            export_georef_edges_geometries);
+}
+
+void EdReader::load_georef(navitia::type::Data& data,
+                           pqxx::work& work,
+                           const double min_non_connected_graph_ratio,
+                           const bool export_georef_edges_geometries) {
+    this->fill_vector_to_ignore(work, min_non_connected_graph_ratio);
+
+    this->fill_admins(data, work);
+    this->fill_admins_postal_codes(data, work);
+
     this->fill_poi_types(data, work);
     this->fill_pois(data, work);
     this->fill_poi_properties(data, work);
@@ -131,18 +271,12 @@ void EdReader::fill(navitia::type::Data& data,
     /// les relations admin et les autres objets
     this->build_rel_way_admin(data, work);
     this->build_rel_admin_admin(data, work);
-
-    this->fill_prices(data, work);
-    this->fill_transitions(data, work);
-    this->fill_origin_destinations(data, work);
-
-    check_coherence(data);
 }
 
 void EdReader::fill_admins(navitia::type::Data& nav_data, pqxx::work& work) {
     std::string request =
         "SELECT id, name, uri, comment, insee, level, ST_X(coord::geometry) as lon, "
-        "ST_Y(coord::geometry) as lat, ST_asText(boundary) as boundary "
+        "ST_Y(coord::geometry) as lat, encode(ST_AsBinary(boundary), 'hex') as boundary "
         "FROM georef.admin";
 
     pqxx::result result = work.exec(request);
@@ -157,7 +291,7 @@ void EdReader::fill_admins(navitia::type::Data& nav_data, pqxx::work& work) {
         admin->coord.set_lat(const_it["lat"].as<double>());
 
         if (!const_it["boundary"].is_null()) {
-            boost::geometry::read_wkt(const_it["boundary"].as<std::string>(), admin->boundary);
+            connectors::read_hex_wkb(const_it["boundary"].as<std::string>(), admin->boundary);
         }
 
         admin->idx = nav_data.geo_ref->admins.size();
@@ -188,7 +322,7 @@ void EdReader::fill_admins_postal_codes(navitia::type::Data& /*unused*/, pqxx::w
     }
 }
 
-void EdReader::fill_admin_stop_areas(navitia::type::Data& /*unused*/, pqxx::work& work) {
+void EdReader::fill_admin_stop_areas(navitia::type::Data& data, pqxx::work& work) {
     std::string request = "SELECT admin_id, stop_area_id from navitia.admin_stop_area";
 
     size_t nb_unknown_admin(0), nb_unknown_stop(0), nb_valid_admin(0);
@@ -216,7 +350,7 @@ void EdReader::fill_admin_stop_areas(navitia::type::Data& /*unused*/, pqxx::work
 
         navitia::type::StopArea* sa = it_sa->second;
 
-        admin->main_stop_areas.push_back(sa);
+        data.pt_data->admin_main_stop_areas[admin->idx].push_back(sa);
         nb_valid_admin++;
     }
     LOG4CPLUS_INFO(log, nb_valid_admin << " admin with at least one main stop");
@@ -278,9 +412,7 @@ void EdReader::fill_object_codes(navitia::type::Data& data, pqxx::work& work) {
 }
 
 void EdReader::fill_meta(navitia::type::Data& nav_data, pqxx::work& work) {
-    std::string request =
-        "SELECT beginning_date, end_date, st_astext(shape) as bounding_shape,"
-        "street_network_source, poi_source  FROM navitia.parameters";
+    std::string request = "SELECT beginning_date, end_date FROM navitia.parameters";
     pqxx::result result = work.exec(request);
 
     if (result.empty()) {
@@ -300,6 +432,19 @@ void EdReader::fill_meta(navitia::type::Data& nav_data, pqxx::work& work) {
     bg::date end = bg::from_string(const_it["end_date"].as<std::string>()) + bg::days(1);
 
     nav_data.meta->production_date = bg::date_period(begin, end);
+}
+
+void EdReader::fill_georef_meta(navitia::type::Data& nav_data, pqxx::work& work) {
+    std::string request =
+        "SELECT st_astext(shape) as bounding_shape, street_network_source, poi_source FROM navitia.parameters";
+    pqxx::result result = work.exec(request);
+
+    if (result.empty()) {
+        throw navitia::exception(
+            "Cannot find entry in navitia.parameters, "
+            " it's likely that no data have been imported, we cannot create a nav file");
+    }
+    auto const_it = result.begin();
     if (!const_it["poi_source"].is_null()) {
         const_it["poi_source"].to(nav_data.meta->poi_source);
     }
@@ -555,7 +700,7 @@ void EdReader::fill_stop_points(nt::Data& data, pqxx::work& work) {
         "sp.fare_zone as fare_zone, sp.stop_area_id as stop_area_id,"
         "sp.platform_code as platform_code,"
         "sp.is_zonal as is_zonal,"
-        "ST_AsText(sp.area) as area,"
+        "encode(ST_AsBinary(sp.area), 'hex') as area,"
         "pr.wheelchair_boarding as wheelchair_boarding,"
         "pr.sheltered as sheltered, pr.elevator as elevator,"
         "pr.escalator as escalator, pr.bike_accepted as bike_accepted,"
@@ -611,7 +756,7 @@ void EdReader::fill_stop_points(nt::Data& data, pqxx::work& work) {
         sp->stop_area->stop_point_list.push_back(sp);
         if (!const_it["area"].is_null() && sp->is_zonal) {
             nt::MultiPolygon area;
-            boost::geometry::read_wkt(const_it["area"].as<std::string>(), area);
+            connectors::read_hex_wkb(const_it["area"].as<std::string>(), area);
             data.pt_data->stop_points_by_area.insert(area, sp);
         }
 
@@ -623,7 +768,7 @@ void EdReader::fill_stop_points(nt::Data& data, pqxx::work& work) {
 void EdReader::fill_lines(nt::Data& data, pqxx::work& work) {
     std::string request =
         "SELECT id, name, uri, code, color, text_color,"
-        "network_id, commercial_mode_id, sort, ST_AsText(shape) AS shape, "
+        "network_id, commercial_mode_id, sort, encode(ST_AsBinary(shape), 'hex') AS shape, "
         "opening_time, closing_time "
         "FROM navitia.line";
 
@@ -649,7 +794,7 @@ void EdReader::fill_lines(nt::Data& data, pqxx::work& work) {
         line->commercial_mode = commercial_mode_map[const_it["commercial_mode_id"].as<idx_t>()];
         line->commercial_mode->line_list.push_back(line);
 
-        boost::geometry::read_wkt(const_it["shape"].as<std::string>("MULTILINESTRING()"), line->shape);
+        connectors::read_hex_wkb(const_it["shape"].as<std::string>(""), line->shape);
 
         data.pt_data->lines.push_back(line);
         this->line_map[const_it["id"].as<idx_t>()] = line;
@@ -698,7 +843,7 @@ void EdReader::fill_line_groups(nt::Data& data, pqxx::work& work) {
 void EdReader::fill_routes(nt::Data& data, pqxx::work& work) {
     std::string request =
         "SELECT id, name, uri, line_id, destination_stop_area_id,"
-        "ST_AsText(shape) AS shape, direction_type FROM navitia.route";
+        "encode(ST_AsBinary(shape), 'hex') AS shape, direction_type FROM navitia.route";
 
     pqxx::result result = work.exec(request);
     for (auto const_it = result.begin(); const_it != result.end(); ++const_it) {
@@ -706,7 +851,7 @@ void EdReader::fill_routes(nt::Data& data, pqxx::work& work) {
         const_it["uri"].to(route->uri);
         const_it["name"].to(route->name);
         const_it["direction_type"].to(route->direction_type);
-        boost::geometry::read_wkt(const_it["shape"].as<std::string>("MULTILINESTRING()"), route->shape);
+        connectors::read_hex_wkb(const_it["shape"].as<std::string>(""), route->shape);
 
         route->line = line_map[const_it["line_id"].as<idx_t>()];
         route->line->route_list.push_back(route);
@@ -1038,11 +1183,11 @@ void EdReader::fill_meta_vehicle_journeys(nt::Data& data, pqxx::work& work) {
 }
 
 void EdReader::fill_shapes(nt::Data& /*unused*/, pqxx::work& work) {
-    std::string request = "SELECT id as id, ST_AsText(geom) as geom FROM navitia.shape";
+    std::string request = "SELECT id as id, encode(ST_AsBinary(geom), 'hex') as geom FROM navitia.shape";
     const pqxx::result result = work.exec(request);
     for (auto const_it = result.begin(); const_it != result.end(); ++const_it) {
         auto shape = boost::make_shared<nt::LineString>();
-        boost::geometry::read_wkt(const_it["geom"].as<std::string>("LINESTRING()"), *shape);
+        connectors::read_hex_wkb(const_it["geom"].as<std::string>(""), *shape);
         this->shapes_map[const_it["id"].as<idx_t>()] = shape;
     }
 }
@@ -1068,6 +1213,7 @@ void EdReader::fill_stop_times(nt::Data& /*unused*/, pqxx::work& work) {
         "st.alighting_time as alighting_time "
         "FROM navitia.stop_time as st ";
 
+    const auto start = bt::microsec_clock::local_time();
     pqxx::stateless_cursor<pqxx::cursor_base::read_only, pqxx::cursor_base::owned> cursor(work, request, "stcursor",
                                                                                           false);
 
@@ -1136,6 +1282,7 @@ void EdReader::fill_stop_times(nt::Data& /*unused*/, pqxx::work& work) {
             }
         }
     }
+    log_throughput(log, "stop times", nb_rows, start);
 }
 
 void EdReader::finish_stop_times(nt::Data& data) {
@@ -1478,6 +1625,7 @@ void EdReader::fill_vector_to_ignore(pqxx::work& work, const double min_non_conn
 
 void EdReader::fill_vertex(navitia::type::Data& data, pqxx::work& work) {
     std::string request = "select id, ST_X(coord::geometry) as lon, ST_Y(coord::geometry) as lat from georef.node;";
+    const auto start = bt::microsec_clock::local_time();
     pqxx::result result = work.exec(request);
     uint64_t idx = 0;
     for (auto const_it = result.begin(); const_it != result.end(); ++const_it) {
@@ -1495,6 +1643,7 @@ void EdReader::fill_vertex(navitia::type::Data& data, pqxx::work& work) {
         this->node_map[id] = idx;
         idx++;
     }
+    log_throughput(log, "vertices", result.size(), start);
     data.geo_ref->init();
 }
 
@@ -1533,11 +1682,12 @@ void EdReader::fill_graph(navitia::type::Data& data, pqxx::work& work, bool expo
         "select e.source_node_id, target_node_id, e.way_id, "
         "ST_LENGTH(the_geog) AS leng, e.pedestrian_allowed as pede, "
         "e.cycles_allowed as bike,e.cars_allowed as car, car_speed";
-    // Don't call ST_ASTEXT if not needed since it's slow
+    // Don't export the geometries if not needed since it's slow
     if (export_georef_edges_geometries) {
-        request += ", ST_ASTEXT(the_geog) AS geometry";
+        request += ", encode(ST_AsBinary(the_geog), 'hex') AS geometry";
     }
     request += " from georef.edge e;";
+    const auto start = bt::microsec_clock::local_time();
     pqxx::result result = work.exec(request);
     size_t nb_edges_no_way = 0, nb_useless_edges = 0;
     size_t nb_walking_edges(0), nb_biking_edges(0), nb_driving_edges(0);
@@ -1570,7 +1720,7 @@ void EdReader::fill_graph(navitia::type::Data& data, pqxx::work& work, bool expo
         e.way_idx = way->idx;
         if (export_georef_edges_geometries) {
             nt::LineString geometry;
-            boost::geometry::read_wkt(const_it["geometry"].as<std::string>(), geometry);
+            connectors::read_hex_wkb(const_it["geometry"].as<std::string>(), geometry);
             if (!geometry.empty()) {
                 e.geom_idx = way->geoms.size();
                 way->geoms.push_back(geometry);
@@ -1631,6 +1781,7 @@ void EdReader::fill_graph(navitia::type::Data& data, pqxx::work& work, bool expo
         LOG4CPLUS_WARN(log, nb_useless_edges << " edges are not usable by any modes");
     }
 
+    log_throughput(log, "edges", result.size(), start);
     LOG4CPLUS_INFO(log, boost::num_edges(data.geo_ref->graph) << " edges added ");
     LOG4CPLUS_INFO(log, nb_walking_edges << " walking edges");
     LOG4CPLUS_INFO(log, nb_biking_edges << " biking edges");
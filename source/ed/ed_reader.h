@@ -45,8 +45,15 @@ namespace ed {
 
 struct EdReader {
     std::unique_ptr<pqxx::connection> conn;
-
-    EdReader(const std::string& connection_string) {
+    const std::string connection_string;
+    // number of connections used to read the database: the public transport, the street network and the fares are
+    // read in parallel on their own connection, sharing the same snapshot
+    size_t nb_connections = 1;
+    // file where the street network, the admins and the pois are kept between two runs, they are only read again from
+    // the database when its georef version changes. Empty to disable it
+    std::string georef_cache;
+
+    EdReader(const std::string& connection_string) : connection_string(connection_string) {
         try {
             conn = std::unique_ptr<pqxx::connection>(new pqxx::connection(connection_string));
         } catch (const pqxx::pqxx_exception& e) {
@@ -58,6 +65,14 @@ struct EdReader {
               const double min_non_connected_graph_ratio,
               const bool export_georef_edges_geometries);
 
+    // only read the street network, the admins and the pois, for a public transport part that is not in the database
+    void fill_georef(navitia::type::Data& data,
+                     const double min_non_connected_graph_ratio,
+                     const bool export_georef_edges_geometries);
+
+    /// coherence check for logging purpose
+    void check_coherence(navitia::type::Data& data) const;
+
     // for admin main stop areas, we need this temporary map
     //(we can't use an index since the link is between georef and navitia, and those modules are loaded separatly)
     std::unordered_map<std::string, navitia::georef::Admin*> admin_by_insee_code;
@@ -106,7 +121,11 @@ private:
     using EdgeId = std::pair<uint64_t, uint64_t>;
     navitia::flat_enum_map<navitia::type::Mode_e, std::set<EdgeId>> edge_to_ignore_by_modes;
 
+    void fill_pt(navitia::type::Data& data, pqxx::work& work);
+    void fill_fares(navitia::type::Data& data, pqxx::work& work);
+
     void fill_meta(navitia::type::Data& nav_data, pqxx::work& work);
+    void fill_georef_meta(navitia::type::Data& nav_data, pqxx::work& work);
     void fill_feed_infos(navitia::type::Data& data, pqxx::work& work);
     void fill_timezones(navitia::type::Data& data, pqxx::work& work);
     void fill_networks(navitia::type::Data& data, pqxx::work& work);
@@ -134,6 +153,17 @@ private:
 
     void fill_comments(navitia::type::Data& data, pqxx::work& work);
 
+    void read_georef(navitia::type::Data& data,
+                     pqxx::work& work,
+                     const double min_non_connected_graph_ratio,
+                     const bool export_georef_edges_geometries);
+    void load_georef(navitia::type::Data& data,
+                     pqxx::work& work,
+                     const double min_non_connected_graph_ratio,
+                     const bool export_georef_edges_geometries);
+    std::string georef_version(pqxx::work& work,
+                               const double min_non_connected_graph_ratio,
+                               const bool export_georef_edges_geometries);
     void fill_admins(navitia::type::Data& nav_data, pqxx::work& work);
     void fill_admin_stop_areas(navitia::type::Data& data, pqxx::work& work);
     void fill_admins_postal_codes(navitia::type::Data& data, pqxx::work& work);
@@ -177,8 +207,6 @@ private:
     void build_rel_way_admin(navitia::type::Data& data, pqxx::work& work);
     void build_rel_admin_admin(navitia::type::Data& data, pqxx::work& work);
 
-    /// coherence check for logging purpose
-    void check_coherence(navitia::type::Data& data) const;
     log4cplus::Logger log = log4cplus::Logger::getInstance("log");
 };
 
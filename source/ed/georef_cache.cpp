@@ -0,0 +1,131 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "georef_cache.h"
+
+#include "georef/georef.h"
+#include "lz4_filter/filter.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/filtering_streambuf.hpp>
+#include <eos_portable_archive/portable_iarchive.hpp>
+#include <eos_portable_archive/portable_oarchive.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace ed {
+
+namespace bt = boost::posix_time;
+namespace nt = navitia::type;
+
+std::string GeorefCache::key(const std::string& georef_version,
+                             const double min_non_connected_graph_ratio,
+                             const bool export_georef_edges_geometries,
+                             const unsigned int data_version) {
+    std::stringstream key;
+    key << georef_version << ";" << min_non_connected_graph_ratio << ";" << export_georef_edges_geometries << ";"
+        << data_version;
+    return key.str();
+}
+
+bool GeorefCache::load(nt::Data& data,
+                       const std::string& key,
+                       std::unordered_map<std::string, navitia::georef::Admin*>& admin_by_insee_code) const {
+    if (!boost::filesystem::exists(file)) {
+        LOG4CPLUS_INFO(log, "no georef cache " << file);
+        return false;
+    }
+    const auto start = bt::microsec_clock::local_time();
+    try {
+        std::ifstream ifs(file.c_str(), std::ios::in | std::ios::binary);
+        ifs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
+        in.push(LZ4Decompressor(2048 * 500), 8192 * 500, 8192 * 500);
+        in.push(ifs);
+        eos::portable_iarchive ia(in);
+        std::string cached_key;
+        ia >> cached_key;
+        if (cached_key != key) {
+            LOG4CPLUS_INFO(log, "the georef cache " << file << " is outdated (" << cached_key << " instead of " << key
+                                                    << ")");
+            return false;
+        }
+        ia >> *data.geo_ref;
+        // the boundaries are not in the .nav but are used to find the admins of the stop points
+        for (auto* admin : data.geo_ref->admins) {
+            ia >> admin->boundary;
+        }
+    } catch (const std::exception& e) {
+        // the cache is only an optimization, the georef is read from the database instead
+        LOG4CPLUS_WARN(log, "unable to read the georef cache " << file << ", it is removed: " << e.what());
+        // the archive may have been partly read
+        data.geo_ref = std::make_shared<navitia::georef::GeoRef>();
+        boost::system::error_code ec;
+        boost::filesystem::remove(file, ec);
+        return false;
+    }
+    for (auto* admin : data.geo_ref->admins) {
+        admin_by_insee_code[admin->insee] = admin;
+    }
+    LOG4CPLUS_INFO(log, "georef read from the cache " << file << " in "
+                                                      << (bt::microsec_clock::local_time() - start).total_milliseconds()
+                                                      << "ms");
+    return true;
+}
+
+void GeorefCache::save(const nt::Data& data, const std::string& key) const {
+    // written aside and renamed, an interrupted run must not leave a truncated cache
+    const auto tmp_file = file + ".temp";
+    try {
+        {
+            std::ofstream ofs(tmp_file.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+            ofs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+            boost::iostreams::filtering_streambuf<boost::iostreams::output> out;
+            out.push(LZ4Compressor(2048 * 500), 1024 * 500, 1024 * 500);
+            out.push(ofs);
+            eos::portable_oarchive oa(out);
+            oa << key << *data.geo_ref;
+            for (const auto* admin : data.geo_ref->admins) {
+                oa << admin->boundary;
+            }
+        }
+        boost::filesystem::rename(tmp_file, file);
+    } catch (const std::exception& e) {
+        // the cache is only an optimization for the next run
+        LOG4CPLUS_WARN(log, "unable to write the georef cache " << file << ": " << e.what());
+        std::remove(tmp_file.c_str());
+        return;
+    }
+    LOG4CPLUS_INFO(log, "georef saved in the cache " << file);
+}
+
+}  // namespace ed
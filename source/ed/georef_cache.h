@@ -0,0 +1,76 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "type/data.h"
+
+#include <log4cplus/logger.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace navitia {
+namespace georef {
+struct Admin;
+}
+}  // namespace navitia
+
+namespace ed {
+
+/**
+ * File where ed2nav keeps the street network, the admins (with their boundaries) and the pois between two runs
+ *
+ * The file starts with the key of the georef it contains, it is only used by a run reading the same key
+ */
+struct GeorefCache {
+    std::string file;
+
+    explicit GeorefCache(const std::string& file) : file(file) {}
+
+    // The georef read from the database only depends on the georef version of the database, on the options of the
+    // reading and on the serialization of the data
+    static std::string key(const std::string& georef_version,
+                           const double min_non_connected_graph_ratio,
+                           const bool export_georef_edges_geometries,
+                           const unsigned int data_version = navitia::type::Data::data_version);
+
+    // Fill the georef of data (and admin_by_insee_code) if the file is there with this key, an unreadable file is
+    // removed and data keeps an empty georef
+    bool load(navitia::type::Data& data,
+              const std::string& key,
+              std::unordered_map<std::string, navitia::georef::Admin*>& admin_by_insee_code) const;
+    void save(const navitia::type::Data& data, const std::string& key) const;
+
+private:
+    log4cplus::Logger log = log4cplus::Logger::getInstance("log");
+};
+
+}  // namespace ed
@@ -30,6 +30,7 @@ www.navitia.io
 
 #include "conf.h"
 #include "ed/connectors/gtfs_parser.h"
+#include "ed2nav.h"
 #include "ed_persistor.h"
 #include "utils/exception.h"
 #include "utils/init.h"
@@ -46,8 +47,9 @@ namespace po = boost::program_options;
 namespace pt = boost::posix_time;
 
 int main(int argc, char* argv[]) {
-    std::string input, date, connection_string;
-    double simplify_tolerance;
+    std::string input, date, connection_string, nav_output, cities_connection_string;
+    double simplify_tolerance, min_non_connected_graph_ratio;
+    size_t nb_threads;
     po::options_description desc("Allowed options");
 
     // clang-format off
@@ -59,10 +61,22 @@ int main(int argc, char* argv[]) {
          "Distance in unit of coordinate used to simplify geometries and reduce memory usage. Default is "
          "0.00003 (~ 3m). Pass 0 to disable any simplification.")
         ("version,v", "Show version")
+        ("nb_threads", po::value<size_t>(&nb_threads)->default_value(1),
+         "Number of threads used to parse the stop times")
         ("config-file", po::value<std::string>(), "Path to a config file")
         ("connection-string", po::value<std::string>(&connection_string)->required(),
             "Database connection parameters: host=localhost user=navitia"
             " dbname=navitia password=navitia")
+        ("nav-output", po::value<std::string>(&nav_output),
+         "Write directly this .nav file instead of storing the data in the database, "
+         "only the street network is read from the database")
+        ("cities-connection-string", po::value<std::string>(&cities_connection_string)->default_value(""),
+         "With nav-output, cities database connection parameters: host=localhost user=navitia dbname=cities "
+         "password=navitia")
+        ("min_non_connected_ratio,m",
+         po::value<double>(&min_non_connected_graph_ratio)->default_value(0.01),
+         "With nav-output, min ratio for the size of non connected graph")
+        ("full_street_network_geometries", "With nav-output, export the street network geometries")
         ("local_syslog", "activate log redirection within local syslog")
         ("log_comment", po::value<std::string>(), "optional field to add extra information like coverage name");
     // clang-format on
@@ -109,6 +123,7 @@ int main(int argc, char* argv[]) {
     start = pt::microsec_clock::local_time();
 
     ed::connectors::GtfsParser gtfs_parser(input);
+    gtfs_parser.nb_threads = nb_threads;
     gtfs_parser.fill(data, date);
     read = (pt::microsec_clock::local_time() - start).total_milliseconds();
     LOG4CPLUS_INFO(logger, "We excluded " << data.count_too_long_connections
@@ -146,8 +161,13 @@ int main(int argc, char* argv[]) {
     LOG4CPLUS_INFO(logger, "validity pattern : " << data.validity_patterns.size());
 
     start = pt::microsec_clock::local_time();
-    ed::EdPersistor p(connection_string);
-    p.persist(data);
+    if (nav_output.empty()) {
+        ed::EdPersistor p(connection_string);
+        p.persist(data);
+    } else if (!ed::ed2nav_from_data(data, nav_output, connection_string, cities_connection_string,
+                                     min_non_connected_graph_ratio, vm.count("full_street_network_geometries"))) {
+        return 1;
+    }
     save = (pt::microsec_clock::local_time() - start).total_milliseconds();
 
     LOG4CPLUS_INFO(logger, "temps de traitement");
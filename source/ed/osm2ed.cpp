@@ -31,6 +31,7 @@ www.navitia.io
 #include "osm2ed.h"
 
 #include "conf.h"
+#include "ed/connectors/wkb_reader.h"
 #include "ed/default_poi_types.h"
 #include "ed_persistor.h"
 #include "utils/functions.h"
@@ -47,6 +48,7 @@ www.navitia.io
 #include <boost/range/algorithm/reverse.hpp>
 
 #include <cstdio>
+#include <future>
 #include <iostream>
 #include <queue>
 #include <utility>
@@ -57,6 +59,26 @@ namespace pt = boost::posix_time;
 namespace ed {
 namespace connectors {
 
+/*
+ * Calls f(begin, end) on nb_threads slices of [0, size), the exceptions are rethrown
+ */
+template <typename F>
+static void parallel_for(const size_t size, const size_t nb_threads, const F& f) {
+    const size_t nb_slices = std::max<size_t>(1, std::min(nb_threads, size));
+    if (nb_slices == 1) {
+        f(size_t(0), size);
+        return;
+    }
+    const size_t slice_size = (size + nb_slices - 1) / nb_slices;
+    std::vector<std::future<void>> futures;
+    for (size_t begin = 0; begin < size; begin += slice_size) {
+        futures.push_back(std::async(std::launch::async, f, begin, std::min(begin + slice_size, size)));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
 /*
  * Read relations
  * Stores admins relations and initializes nodes and ways associated to it.
@@ -102,7 +124,7 @@ void ReadRelationsVisitor::relation_callback(uint64_t osm_id,
                     break;
                 case OSMPBF::Relation_MemberType::Relation_MemberType_NODE:
                     if (ref.role == "admin_centre" || ref.role == "admin_center") {
-                        cache.nodes.insert(OSMNode(ref.member_id));
+                        cache.add_node_ref(ref.member_id, false);
                     }
                     break;
                 case OSMPBF::Relation_MemberType::Relation_MemberType_RELATION:
@@ -205,12 +227,9 @@ void ReadWaysVisitor::way_callback(uint64_t osm_id,
         it_way = cache.ways.insert(OSMWay(osm_id, properties, name, speed)).first;
     }
     for (auto osm_id : nodes_refs) {
-        auto v = cache.nodes.insert(OSMNode(osm_id));
-        if (is_street && !v.second) {
-            v.first->set_used_more_than_once();
-        }
+        cache.add_node_ref(osm_id, is_street);
         if (it_way != cache.ways.end()) {
-            it_way->add_node(v.first);
+            it_way->node_ids.push_back(osm_id);
         }
     }
 }
@@ -219,10 +238,55 @@ void ReadWaysVisitor::way_callback(uint64_t osm_id,
  * We fill needed nodes with their coordinates
  */
 void ReadNodesVisitor::node_callback(uint64_t osm_id, double lon, double lat, const CanalTP::Tags& /*unused*/) {
-    auto node_it = cache.nodes.find(OSMNode(osm_id));
-    if (node_it != cache.nodes.end()) {
-        node_it->set_coord(lon, lat);
+    const auto* node = cache.find_node(osm_id);
+    if (node != nullptr) {
+        node->set_coord(lon, lat);
+    }
+}
+
+void OSMCache::add_node_ref(const uint64_t osm_id, const bool is_street) {
+    node_refs.push_back(is_street ? osm_id | STREET_REF : osm_id);
+}
+
+/*
+ * Builds the sorted array of the needed nodes from their references, and links the ways to them
+ * A node referenced by a street that isn't its first reference is used more than once
+ */
+void OSMCache::build_nodes() {
+    auto logger = log4cplus::Logger::getInstance("log");
+    const auto ref_id = [](const uint64_t ref) { return ref & ~STREET_REF; };
+    // stable to keep the first reference of each node first
+    std::stable_sort(node_refs.begin(), node_refs.end(),
+                     [&](const uint64_t a, const uint64_t b) { return ref_id(a) < ref_id(b); });
+    nodes.clear();
+    for (auto it = node_refs.begin(); it != node_refs.end();) {
+        const auto osm_id = ref_id(*it);
+        nodes.emplace_back(osm_id);
+        for (++it; it != node_refs.end() && ref_id(*it) == osm_id; ++it) {
+            if (*it & STREET_REF) {
+                nodes.back().set_used_more_than_once();
+            }
+        }
+    }
+    nodes.shrink_to_fit();
+    std::vector<uint64_t>().swap(node_refs);
+
+    for (const auto& way : ways) {
+        way.nodes.reserve(way.node_ids.size());
+        for (const auto osm_id : way.node_ids) {
+            way.add_node(find_node(osm_id));
+        }
+        std::vector<uint64_t>().swap(way.node_ids);
+    }
+    LOG4CPLUS_INFO(logger, nodes.size() << " nodes needed");
+}
+
+const OSMNode* OSMCache::find_node(const uint64_t osm_id) const {
+    const auto it = std::lower_bound(nodes.begin(), nodes.end(), OSMNode(osm_id));
+    if (it == nodes.end() || it->osm_id != osm_id) {
+        return nullptr;
     }
+    return &*it;
 }
 
 /*
@@ -235,6 +299,7 @@ void OSMCache::build_relations_geometries() {
         if (admin->polygon.empty()) {
             continue;
         }
+        admin->prepare_polygon();
         boost::geometry::model::box<point> box{};
         boost::geometry::envelope(admin->polygon, box);
         Rect r(box.min_corner().get<0>(), box.min_corner().get<1>(), box.max_corner().get<0>(),
@@ -247,6 +312,17 @@ void OSMCache::build_relations_geometries() {
  * Find the admin of coordinates
  */
 const Admin* OSMCache::match_coord_admin(const double lon, const double lat) {
+    const auto* admin = match_coord_admin_in_tree(lon, lat);
+    if (admin == nullptr && this->cities_db) {
+        return find_admin_in_cities(lon, lat);
+    }
+    return admin;
+}
+
+/*
+ * Find the admin of coordinates among the admins already known, it doesn't modify the cache
+ */
+const Admin* OSMCache::match_coord_admin_in_tree(const double lon, const double lat) {
     Rect search_rect(lon, lat);
     const auto p = point(lon, lat);
     using Admins = std::vector<const Admin*>;
@@ -261,20 +337,17 @@ const Admin* OSMCache::match_coord_admin(const double lon, const double lat) {
     };
     admin_tree.Search(search_rect.min, search_rect.max, callback, &result);
     for (const auto* rel : result) {
-        if (boost::geometry::covered_by(p, rel->polygon)) {
+        if (rel->covers(p)) {
             return rel;
         }
     }
-    if (this->cities_db) {
-        return find_admin_in_cities(lon, lat);
-    }
     return nullptr;
 }
 
 template <typename T>
-T read_wkt(const std::string& s) {
+T read_wkb(const std::string& s) {
     T g{};
-    boost::geometry::read_wkt(s, g);
+    read_hex_wkb(s, g);
     return g;
 }
 
@@ -285,8 +358,8 @@ const Admin* OSMCache::find_admin_in_cities(const double lon, const double lat)
     const auto p = point(lon, lat);
     std::stringstream request;
     request << "SELECT id, uri, name, coalesce(insee, '') as insee, level, coalesce(post_code, '') as post_code, "
-            << "ST_ASTEXT(coord) as center, "
-            << "ST_ASTEXT(boundary) as boundary "
+            << "encode(ST_AsBinary(coord), 'hex') as center, "
+            << "encode(ST_AsBinary(boundary), 'hex') as boundary "
             << "FROM administrative_regions "
             << "WHERE ST_Intersects(ST_MakeEnvelope(" << std::setprecision(16) << lon - cities_bbox_to_fetch << ", "
             << lat - cities_bbox_to_fetch << ", " << lon + cities_bbox_to_fetch << ", " << lat + cities_bbox_to_fetch
@@ -299,8 +372,8 @@ const Admin* OSMCache::find_admin_in_cities(const double lon, const double lat)
 
     const Admin* containing_admin = nullptr;
     for (const auto& it : result) {
-        auto polygon = read_wkt<mpolygon_type>(it["boundary"].as<std::string>());
-        auto center = read_wkt<point>(it["center"].as<std::string>());
+        auto polygon = read_wkb<mpolygon_type>(it["boundary"].as<std::string>());
+        auto center = read_wkb<point>(it["center"].as<std::string>());
         const auto id = it["id"].as<u_int64_t>();
 
         if (this->admins.find(id) != this->admins.end()) {
@@ -311,7 +384,9 @@ const Admin* OSMCache::find_admin_in_cities(const double lon, const double lat)
                                              it["post_code"].as<std::string>(), it["name"].as<std::string>(),
                                              it["level"].as<uint32_t>(), std::move(polygon), center);
 
-        if (boost::geometry::covered_by(p, admin->polygon)) {
+        // the admin is kept for the next coordinates, its polygon is prepared anyway
+        admin->prepare_polygon();
+        if (admin->covers(p)) {
             containing_admin = admin.get();
         }
 
@@ -331,16 +406,22 @@ const Admin* OSMCache::find_admin_in_cities(const double lon, const double lat)
  */
 void OSMCache::match_nodes_admin() {
     auto logger = log4cplus::Logger::getInstance("log");
-    size_t count_matches = 0;
-    for (const auto& node : nodes) {
-        if (!node.is_defined() || node.admin) {
-            continue;
-        }
-        node.admin = match_coord_admin(node.lon(), node.lat());
-        if (node.admin != nullptr) {
-            ++count_matches;
+    std::atomic<size_t> count_matches{0};
+    // the admins of the cities database are added to the cache when needed, the nodes are then matched one by one
+    parallel_for(nodes.size(), cities_db ? 1 : nb_threads, [&](const size_t begin, const size_t end) {
+        size_t nb_matches = 0;
+        for (size_t i = begin; i < end; ++i) {
+            const auto& node = nodes[i];
+            if (!node.is_defined() || node.admin) {
+                continue;
+            }
+            node.admin = match_coord_admin(node.lon(), node.lat());
+            if (node.admin != nullptr) {
+                ++nb_matches;
+            }
         }
-    }
+        count_matches += nb_matches;
+    });
 
     LOG4CPLUS_INFO(logger, "" << count_matches << "/" << nodes.size() << " nodes with an admin");
 }
@@ -431,7 +512,7 @@ void OSMCache::insert_edges() {
     size_t n_inserted = 0;
     const size_t max_n_inserted = 20000;
     for (const auto& way : ways) {
-        auto prev_node = nodes.end();
+        const OSMNode* prev_node = nullptr;
         const auto ref_way_id = way.way_ref == nullptr ? way.osm_id : way.way_ref->osm_id;
 
         std::string speed = lotus->null_value;
@@ -442,8 +523,8 @@ void OSMCache::insert_edges() {
             if (!node->is_defined()) {
                 continue;
             }
-            if ((node->is_used_more_than_once() && prev_node != nodes.end())
-                || (node == way.nodes.back() && prev_node != nodes.end())) {
+            if ((node->is_used_more_than_once() && prev_node != nullptr)
+                || (node == way.nodes.back() && prev_node != nullptr)) {
                 // If a node is used more than once, it is an intersection,
                 // hence it's a node of the street network graph
                 // If a node is only used by one way we can simplify the and reduce the number of edges, we don't need
@@ -468,10 +549,10 @@ void OSMCache::insert_edges() {
                                      std::to_string(way.properties[OSMWay::FOOT_BWD]),
                                      std::to_string(way.properties[OSMWay::CYCLE_BWD]),
                                      std::to_string(way.properties[OSMWay::CAR_BWD]), speed});
-                prev_node = nodes.end();
+                prev_node = nullptr;
                 n_inserted = n_inserted + 2;
             }
-            if (prev_node == nodes.end()) {
+            if (prev_node == nullptr) {
                 coords.clear();
                 prev_node = node;
             }
@@ -818,6 +899,10 @@ Admin::Admin(u_int64_t id,
 
 Admin::~Admin() = default;
 
+void Admin::prepare_polygon() {
+    prepared_polygon = std::make_unique<const navitia::georef::PreparedBoundary<mpolygon_type>>(polygon);
+}
+
 OSMAdminRelation::OSMAdminRelation(u_int64_t id,
                                    const std::string& uri,
                                    std::vector<CanalTP::Reference> refs,
@@ -830,15 +915,15 @@ OSMAdminRelation::OSMAdminRelation(u_int64_t id,
 void OSMAdminRelation::build_geometry(OSMCache& cache) {
     for (const CanalTP::Reference& ref : references) {
         if (ref.member_type == OSMPBF::Relation_MemberType::Relation_MemberType_NODE) {
-            auto node_it = cache.nodes.find(ref.member_id);
-            if (node_it == cache.nodes.end()) {
+            const auto* node = cache.find_node(ref.member_id);
+            if (node == nullptr) {
                 continue;
             }
-            if (!node_it->is_defined()) {
+            if (!node->is_defined()) {
                 continue;
             }
             if (ref.role == "admin_centre" || ref.role == "admin_center") {
-                this->center = point(node_it->lon(), node_it->lat());
+                this->center = point(node->lon(), node->lat());
                 break;
             }
         }
@@ -852,7 +937,7 @@ void OSMAdminRelation::build_geometry(OSMCache& cache) {
 void PoiHouseNumberVisitor::node_callback(uint64_t osm_id, double lon, double lat, const CanalTP::Tags& tags) {
     this->fill_poi(osm_id, tags, lon, lat, OsmObjectType::Node);
     this->fill_housenumber(osm_id, tags, lon, lat);
-    if ((data.pois.size() + house_numbers.size()) >= max_inserts_without_bulk) {
+    if ((data.pois.size() + pending_house_numbers.size()) >= max_inserts_without_bulk) {
         this->insert_data();
     }
 }
@@ -868,19 +953,19 @@ void PoiHouseNumberVisitor::way_callback(uint64_t osm_id,
     }
     polygon_type tmp_polygon;
     for (auto ref : refs) {
-        auto node_it = cache.nodes.find(OSMNode(ref));
-        if (node_it == cache.nodes.end() || !node_it->is_defined()) {
+        const auto* node = cache.find_node(ref);
+        if (node == nullptr || !node->is_defined()) {
             continue;
         }
-        const auto p = point(node_it->lon(), node_it->lat());
+        const auto p = point(node->lon(), node->lat());
         tmp_polygon.outer().push_back(p);
     }
     if (tmp_polygon.outer().size() <= 2) {
         for (auto ref_id : refs) {
-            auto node_it = cache.nodes.find(OSMNode(ref_id));
-            if (node_it != cache.nodes.end() && node_it->is_defined()) {
-                this->fill_housenumber(osm_id, tags, node_it->lon(), node_it->lat());
-                this->fill_poi(osm_id, tags, node_it->lon(), node_it->lat(), OsmObjectType::Way);
+            const auto* node = cache.find_node(ref_id);
+            if (node != nullptr && node->is_defined()) {
+                this->fill_housenumber(osm_id, tags, node->lon(), node->lat());
+                this->fill_poi(osm_id, tags, node->lon(), node->lat(), OsmObjectType::Way);
                 break;
             }
         }
@@ -892,12 +977,13 @@ void PoiHouseNumberVisitor::way_callback(uint64_t osm_id,
         this->fill_housenumber(osm_id, tags, center.get<0>(), center.get<1>());
         this->fill_poi(osm_id, tags, center.get<0>(), center.get<1>(), OsmObjectType::Way);
     }
-    if ((data.pois.size() + house_numbers.size()) >= max_inserts_without_bulk) {
+    if ((data.pois.size() + pending_house_numbers.size()) >= max_inserts_without_bulk) {
         this->insert_data();
     }
 }
 
 void PoiHouseNumberVisitor::insert_data() {
+    match_house_numbers();
     persistor.insert_pois(data);
     persistor.insert_poi_properties(data);
     insert_house_numbers();
@@ -1035,25 +1121,53 @@ void PoiHouseNumberVisitor::fill_housenumber(const uint64_t osm_id,
     if (it_hn == tags.end()) {
         return;
     }
-    const OSMWay* candidate_way = nullptr;
-    auto asso_it = cache.associated_streets.find(AssociateStreetRelation(osm_id));
-    if (asso_it != cache.associated_streets.end()) {
-        auto it_cache = cache.ways.find(OSMWay(asso_it->way_id));
-        if (it_cache != cache.ways.end()) {
-            candidate_way = &*it_cache;
+    // only the tags used to find the way are kept
+    CanalTP::Tags address_tags;
+    for (const auto* key : {"addr:street", "addr:postcode"}) {
+        const auto it = tags.find(key);
+        if (it != tags.end()) {
+            address_tags.insert(*it);
         }
-    } else {
-        candidate_way = find_way(tags, lon, lat);
     }
-    if (candidate_way == nullptr) {
-        return;
+    pending_house_numbers.push_back({osm_id, size_t(str_to_int(it_hn->second)), lon, lat, std::move(address_tags)});
+}
+
+const OSMWay* PoiHouseNumberVisitor::find_house_number_way(const PendingHouseNumber& house_number) {
+    auto asso_it = cache.associated_streets.find(AssociateStreetRelation(house_number.osm_id));
+    if (asso_it != cache.associated_streets.end()) {
+        auto it_cache = cache.ways.find(OSMWay(asso_it->way_id));
+        return it_cache != cache.ways.end() ? &*it_cache : nullptr;
     }
-    if (!candidate_way->way_ref->is_street()) {  // the way isn't a street, we don't have it in the database
-        auto logger = log4cplus::Logger::getInstance("log");
-        LOG4CPLUS_ERROR(logger, "impossible to associate house number to way " << candidate_way->way_ref->osm_id);
-        return;
+    return find_way(house_number.address_tags, house_number.lon, house_number.lat);
+}
+
+/*
+ * Finds the ways of the pending house numbers, in parallel batches
+ */
+void PoiHouseNumberVisitor::match_house_numbers() {
+    std::vector<const OSMWay*> candidate_ways(pending_house_numbers.size(), nullptr);
+    // the admins of the cities database are added to the cache when needed, the house numbers are then matched one by
+    // one
+    parallel_for(pending_house_numbers.size(), cache.cities_db ? 1 : cache.nb_threads,
+                 [&](const size_t begin, const size_t end) {
+                     for (size_t i = begin; i < end; ++i) {
+                         candidate_ways[i] = find_house_number_way(pending_house_numbers[i]);
+                     }
+                 });
+    for (size_t i = 0; i < pending_house_numbers.size(); ++i) {
+        const auto* candidate_way = candidate_ways[i];
+        if (candidate_way == nullptr) {
+            continue;
+        }
+        if (!candidate_way->way_ref->is_street()) {  // the way isn't a street, we don't have it in the database
+            auto logger = log4cplus::Logger::getInstance("log");
+            LOG4CPLUS_ERROR(logger, "impossible to associate house number to way " << candidate_way->way_ref->osm_id);
+            continue;
+        }
+        const auto& house_number = pending_house_numbers[i];
+        house_numbers.emplace_back(house_number.number, house_number.lon, house_number.lat, candidate_way->way_ref);
     }
-    house_numbers.emplace_back(str_to_int(it_hn->second), lon, lat, candidate_way->way_ref);
+    pending_house_numbers.clear();
 }
 
 void PoiHouseNumberVisitor::fill_poi(const u_int64_t osm_id,
@@ -1119,6 +1233,7 @@ void OSMCache::flag_nodes() {
 int osm2ed(int argc, const char** argv) {
     pt::ptime start;
     std::string input, connection_string, json_poi_types;
+    size_t nb_threads;
 
     po::options_description desc("Allowed options");
 
@@ -1138,7 +1253,9 @@ int osm2ed(int argc, const char** argv) {
         ("log_comment", po::value<std::string>(), "optional field to add extra information like coverage name")
         ("cities-connection-string", po::value<std::string>(),
             "cities database connection string, to use admins from cities instead of osm's relations")
-        ("import-car-speed", "import car speed in ED");
+        ("import-car-speed", "import car speed in ED")
+        ("nb_threads", po::value<size_t>(&nb_threads)->default_value(1),
+            "number of threads used to match the nodes and the house numbers with their admin");
     // clang-format on
 
     po::variables_map vm;
@@ -1208,10 +1325,12 @@ int osm2ed(int argc, const char** argv) {
     persistor.clean_poi();
 
     ed::connectors::OSMCache cache(std::make_unique<Lotus>(connection_string), cities_cnx);
+    cache.nb_threads = nb_threads;
     ed::connectors::ReadRelationsVisitor relations_visitor(cache, use_cities);
     CanalTP::read_osm_pbf(input, relations_visitor);
     ed::connectors::ReadWaysVisitor ways_visitor(cache, poi_params, speed_parser);
     CanalTP::read_osm_pbf(input, ways_visitor);
+    cache.build_nodes();
     ed::connectors::ReadNodesVisitor node_visitor(cache);
     CanalTP::read_osm_pbf(input, node_visitor);
     cache.build_relations_geometries();
@@ -36,6 +36,7 @@ www.navitia.io
 #include "ed_persistor.h"
 #include "ed/connectors/osm_tags_reader.h"
 #include "ed/connectors/speed_parser.h"
+#include "georef/prepared_boundary.h"
 
 #include <boost/geometry.hpp>
 #include <boost/geometry/multi/geometries/multi_polygon.hpp>
@@ -43,6 +44,7 @@ www.navitia.io
 #include <RTree/RTree.h>
 #include <osmpbfreader/osmpbfreader.h>
 
+#include <atomic>
 #include <unordered_map>
 #include <set>
 
@@ -134,6 +136,9 @@ struct Admin {
     virtual ~Admin();
     virtual void build_geometry(OSMCache&) {}
     bool is_city() const { return level == 8; }
+    // to be called once the polygon is built, before the point in polygon tests
+    void prepare_polygon();
+    bool covers(const point& p) const { return prepared_polygon && prepared_polygon->covered_by(p); }
 
     const u_int64_t id;
     const std::string uri;
@@ -142,6 +147,7 @@ struct Admin {
     std::vector<std::string> postal_codes;
     const uint32_t level = std::numeric_limits<uint32_t>::max();
     mpolygon_type polygon;
+    std::unique_ptr<const navitia::georef::PreparedBoundary<mpolygon_type>> prepared_polygon;
     point center = point(0.0, 0.0);
 };
 
@@ -178,7 +184,9 @@ struct OSMWay {
     /// Properties of a way : can we use it
     mutable std::bitset<8> properties;
     mutable std::string name = "";
-    mutable std::vector<std::set<OSMNode>::const_iterator> nodes;
+    mutable std::vector<const OSMNode*> nodes;
+    // osm ids of the nodes, only kept until the nodes of the cache are built
+    mutable std::vector<uint64_t> node_ids;
     mutable ls_type ls;
     mutable const OSMWay* way_ref = nullptr;
     mutable boost::optional<float> car_speed;
@@ -192,7 +200,7 @@ struct OSMWay {
            boost::optional<float> car_speed = boost::none)
         : osm_id(osm_id), properties(properties), name(name), car_speed(car_speed) {}
 
-    void add_node(std::set<OSMNode>::const_iterator node) const {
+    void add_node(const OSMNode* node) const {
         nodes.push_back(node);
         if (node->is_defined()) {
             ls.push_back(point(node->lon(), node->lat()));
@@ -270,14 +278,20 @@ constexpr double M_TO_DEG = 1.0 / 111320.0;  // approximate the convertion betwe
 
 struct OSMCache {
     std::map<uint64_t, std::unique_ptr<Admin>> admins;
-    std::set<OSMNode> nodes;
+    // sorted by osm id, built from node_refs once the ways have been read
+    std::vector<OSMNode> nodes;
+    // references to the nodes in reading order, flagged with STREET_REF when done by a street
+    std::vector<uint64_t> node_refs;
+    static constexpr uint64_t STREET_REF = uint64_t(1) << 63;
     std::set<OSMWay> ways;
     std::set<AssociateStreetRelation> associated_streets;
     std::unordered_map<std::string, rel_ways> way_admin_map;
     RTree<const Admin*, double, 2> admin_tree;
     RTree<it_way, double, 2> way_tree;
     double max_search_distance = 0;
-    size_t NB_PROJ = 0;
+    std::atomic<size_t> NB_PROJ{0};
+    // number of threads used to match the nodes and the house numbers with their admin
+    size_t nb_threads = 1;
     double cities_bbox_to_fetch =
         10000.0 * M_TO_DEG;  // by default if we search for cities in the db, we get all the cities +/- 10km around
 
@@ -295,8 +309,12 @@ struct OSMCache {
         }
     }
 
+    void add_node_ref(const uint64_t osm_id, const bool is_street);
+    void build_nodes();
+    const OSMNode* find_node(const uint64_t osm_id) const;
     void build_relations_geometries();
     const Admin* match_coord_admin(const double lon, const double lat);
+    const Admin* match_coord_admin_in_tree(const double lon, const double lat);
     const Admin* find_admin_in_cities(const double lon, const double lat);
     void match_nodes_admin();
     void insert_nodes();
@@ -400,12 +418,21 @@ public:
     }
 };
 
+// a house number read in the pbf, its way is searched when the batch is inserted
+struct PendingHouseNumber {
+    uint64_t osm_id;
+    size_t number;
+    double lon, lat;
+    CanalTP::Tags address_tags;
+};
+
 struct PoiHouseNumberVisitor {
     const size_t max_inserts_without_bulk = 20000;
     ed::EdPersistor& persistor;
     /*const*/ OSMCache& cache;
     ed::Georef& data;
     bool parse_pois;
+    std::vector<PendingHouseNumber> pending_house_numbers;
     std::vector<OSMHouseNumber> house_numbers;
     size_t n_inserted_pois = 0;
     size_t n_inserted_house_numbers = 0;
@@ -437,6 +464,8 @@ struct PoiHouseNumberVisitor {
                   const double lat,
                   OsmObjectType osm_relation_type);
     void fill_housenumber(const u_int64_t osm_id, const CanalTP::Tags& tags, const double lon, const double lat);
+    const OSMWay* find_house_number_way(const PendingHouseNumber& house_number);
+    void match_house_numbers();
     void insert_house_numbers();
     void insert_data();
     void finish();
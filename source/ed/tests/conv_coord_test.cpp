@@ -33,6 +33,8 @@ www.navitia.io
 #define BOOST_TEST_MODULE test_convcoord
 #include <boost/test/unit_test.hpp>
 
+#include <chrono>
+
 class CoordParams {
 public:
     ed::connectors::Projection lambert2;
@@ -74,3 +76,37 @@ BOOST_FIXTURE_TEST_CASE(default_constructor_test, CoordParams) {
 
     BOOST_REQUIRE_EQUAL(coord_wgs84 == navitia::type::GeographicalCoord(1.491911486572199, 48.431961616400599), true);
 }
+
+BOOST_FIXTURE_TEST_CASE(batch_conversion_test, CoordParams) {
+    ed::connectors::ConvCoord conv_coord(lambert2, wgs84);
+    std::vector<navitia::type::GeographicalCoord> coords;
+    for (size_t i = 0; i < 100000; ++i) {
+        coords.emplace_back(537482.27 + i % 1000, 2381791.96 + i / 1000);
+    }
+    auto batch = coords;
+    std::vector<navitia::type::GeographicalCoord> one_by_one;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& coord : coords) {
+        one_by_one.push_back(conv_coord.convert_to(coord));
+    }
+    const auto middle = std::chrono::steady_clock::now();
+    conv_coord.convert_to(batch);
+    const auto end = std::chrono::steady_clock::now();
+    using milliseconds = std::chrono::duration<double, std::milli>;
+    BOOST_TEST_MESSAGE(coords.size() << " coords converted one by one in " << milliseconds(middle - start).count()
+                                     << "ms, all at once in " << milliseconds(end - middle).count() << "ms");
+
+    BOOST_REQUIRE_EQUAL(batch.size(), one_by_one.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(batch[i].lon(), one_by_one[i].lon());
+        BOOST_REQUIRE_EQUAL(batch[i].lat(), one_by_one[i].lat());
+    }
+    BOOST_CHECK(batch[0] == navitia::type::GeographicalCoord(1.491911486572199, 48.431961616400599));
+
+    // nothing to do between the same projections
+    ed::connectors::ConvCoord identity(wgs84, wgs84);
+    auto same = one_by_one;
+    identity.convert_to(same);
+    BOOST_CHECK_EQUAL(same[42].lon(), one_by_one[42].lon());
+}
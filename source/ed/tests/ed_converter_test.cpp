@@ -0,0 +1,138 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ed_converter
+
+#include "conf.h"
+#include "ed/data.h"
+#include "ed/ed_converter.h"
+#include "ed/connectors/fusio_parser.h"
+#include "type/network.h"
+#include "type/pt_data.h"
+#include "type/meta_data.h"
+#include "utils/base64_encode.h"
+#include "utils/logger.h"
+
+#include <boost/test/unit_test.hpp>
+
+struct logger_initialized {
+    logger_initialized() { navitia::init_logger(); }
+};
+BOOST_GLOBAL_FIXTURE(logger_initialized);
+
+const std::string ntfs_path = std::string(navitia::config::fixtures_dir) + "/ed/ntfs";
+
+// the data of the fixture prepared like fusio2ed does before storing them in the database
+struct ntfs_fixture {
+    ed::Data ed_data;
+    navitia::type::Data data;
+
+    ntfs_fixture() {
+        ed::connectors::FusioParser parser(ntfs_path);
+        parser.fill(ed_data);
+        ed_data.complete();
+        ed_data.clean();
+        ed_data.sort();
+        ed_data.build_route_destination();
+        ed_data.normalize_uri();
+
+        ed::EdConverter converter;
+        converter.fill(ed_data, data);
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE(convert_ntfs_objects, ntfs_fixture) {
+    BOOST_CHECK_EQUAL(data.meta->production_date, ed_data.meta.production_date);
+
+    BOOST_REQUIRE_EQUAL(data.pt_data->networks.size(), ed_data.networks.size());
+    for (size_t i = 0; i < ed_data.networks.size(); ++i) {
+        BOOST_CHECK_EQUAL(data.pt_data->networks[i]->uri, navitia::encode_uri(ed_data.networks[i]->uri));
+        BOOST_CHECK_EQUAL(data.pt_data->networks[i]->name, ed_data.networks[i]->name);
+        BOOST_CHECK_EQUAL(data.pt_data->networks[i]->idx, i);
+    }
+
+    BOOST_REQUIRE_EQUAL(data.pt_data->stop_areas.size(), ed_data.stop_areas.size());
+    BOOST_REQUIRE_EQUAL(data.pt_data->stop_points.size(), ed_data.stop_points.size());
+    for (size_t i = 0; i < ed_data.stop_points.size(); ++i) {
+        const auto* sp = data.pt_data->stop_points[i];
+        const auto* ed_sp = ed_data.stop_points[i];
+        BOOST_CHECK_EQUAL(sp->uri, navitia::encode_uri(ed_sp->uri));
+        // the coordinates are rounded like in the database
+        BOOST_CHECK_CLOSE(sp->coord.lon(), ed_sp->coord.lon(), 1e-4);
+        BOOST_CHECK_CLOSE(sp->coord.lat(), ed_sp->coord.lat(), 1e-4);
+        if (ed_sp->stop_area) {
+            BOOST_REQUIRE(sp->stop_area);
+            BOOST_CHECK_EQUAL(sp->stop_area->uri, navitia::encode_uri(ed_sp->stop_area->uri));
+        }
+    }
+
+    size_t nb_lines_with_network = 0;
+    for (const auto* ed_line : ed_data.lines) {
+        nb_lines_with_network += ed_line->network ? 1 : 0;
+    }
+    BOOST_CHECK_EQUAL(data.pt_data->lines.size(), nb_lines_with_network);
+    BOOST_CHECK_EQUAL(data.pt_data->routes.size(), ed_data.routes.size());
+    BOOST_CHECK_EQUAL(data.pt_data->line_groups.size(), ed_data.line_groups.size());
+    BOOST_CHECK_EQUAL(data.pt_data->datasets.size(), ed_data.datasets.size());
+    BOOST_CHECK_EQUAL(data.pt_data->stop_point_connections.size(), ed_data.stop_point_connections.size());
+
+    BOOST_REQUIRE_EQUAL(data.pt_data->calendars.size(), ed_data.calendars.size());
+    for (size_t i = 0; i < ed_data.calendars.size(); ++i) {
+        BOOST_CHECK_EQUAL(data.pt_data->calendars[i]->uri, navitia::base64_encode(ed_data.calendars[i]->uri));
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(convert_ntfs_vehicle_journeys, ntfs_fixture) {
+    BOOST_REQUIRE_EQUAL(data.pt_data->vehicle_journeys.size(), ed_data.vehicle_journeys.size());
+    BOOST_CHECK_EQUAL(data.pt_data->nb_stop_times(), ed_data.stops.size());
+
+    for (const auto* ed_vj : ed_data.vehicle_journeys) {
+        const auto* vj = data.pt_data->vehicle_journeys_map.at(navitia::encode_uri(ed_vj->uri));
+        BOOST_CHECK_EQUAL(vj->route->uri, navitia::encode_uri(ed_vj->route->uri));
+        BOOST_REQUIRE_EQUAL(vj->stop_time_list.size(), ed_vj->stop_time_list.size());
+        for (size_t i = 0; i < vj->stop_time_list.size(); ++i) {
+            const auto& st = vj->stop_time_list[i];
+            const auto* ed_st = ed_vj->stop_time_list[i];
+            BOOST_CHECK_EQUAL(st.departure_time, ed_st->departure_time);
+            BOOST_CHECK_EQUAL(st.arrival_time, ed_st->arrival_time);
+            BOOST_CHECK_EQUAL(st.stop_point->uri, navitia::encode_uri(ed_st->stop_point->uri));
+            BOOST_CHECK_EQUAL(st.pick_up_allowed(), ed_st->pick_up_allowed);
+            BOOST_CHECK_EQUAL(st.drop_off_allowed(), ed_st->drop_off_allowed);
+        }
+    }
+
+    for (const auto& ed_meta_vj : ed_data.meta_vj_map) {
+        const auto* meta_vj = data.pt_data->meta_vjs.get_mut(ed_meta_vj.first);
+        BOOST_REQUIRE(meta_vj);
+        BOOST_CHECK(meta_vj->tz_handler);
+        BOOST_CHECK_EQUAL(meta_vj->associated_calendars.size(), ed_meta_vj.second.associated_calendars.size());
+    }
+}
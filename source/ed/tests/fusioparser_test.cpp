@@ -543,3 +543,36 @@ BOOST_AUTO_TEST_CASE(stop_time_precision_retrocompatibilty_tests) {
         }
     }
 }
+
+/*
+ * The stop times parsed on several threads must be exactly the ones parsed on one thread, in the same order
+ */
+BOOST_AUTO_TEST_CASE(ntfs_stop_times_parsed_in_parallel) {
+    ed::Data data;
+    ed::connectors::FusioParser parser(ntfs_path);
+    parser.fill(data);
+
+    ed::Data parallel_data;
+    ed::connectors::FusioParser parallel_parser(ntfs_path);
+    parallel_parser.nb_threads = 4;
+    parallel_parser.fill(parallel_data);
+
+    BOOST_REQUIRE_EQUAL(parallel_data.stops.size(), data.stops.size());
+    for (size_t i = 0; i < data.stops.size(); ++i) {
+        const auto* st = data.stops[i];
+        const auto* parallel_st = parallel_data.stops[i];
+        BOOST_CHECK_EQUAL(parallel_st->idx, st->idx);
+        BOOST_CHECK_EQUAL(parallel_st->vehicle_journey->uri, st->vehicle_journey->uri);
+        BOOST_CHECK_EQUAL(parallel_st->stop_point->uri, st->stop_point->uri);
+        BOOST_CHECK_EQUAL(parallel_st->order, st->order);
+        BOOST_CHECK_EQUAL(parallel_st->arrival_time, st->arrival_time);
+        BOOST_CHECK_EQUAL(parallel_st->departure_time, st->departure_time);
+        BOOST_CHECK_EQUAL(parallel_st->boarding_time, st->boarding_time);
+        BOOST_CHECK_EQUAL(parallel_st->alighting_time, st->alighting_time);
+        BOOST_CHECK_EQUAL(parallel_st->headsign, st->headsign);
+        BOOST_CHECK_EQUAL(parallel_st->pick_up_allowed, st->pick_up_allowed);
+        BOOST_CHECK_EQUAL(parallel_st->drop_off_allowed, st->drop_off_allowed);
+        BOOST_CHECK_EQUAL(parallel_st->date_time_estimated, st->date_time_estimated);
+    }
+    BOOST_CHECK_EQUAL(parallel_data.stoptime_comments.size(), data.stoptime_comments.size());
+}
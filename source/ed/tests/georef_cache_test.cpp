@@ -0,0 +1,165 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE georef_cache
+
+#include "ed/georef_cache.h"
+#include "georef/adminref.h"
+#include "georef/georef.h"
+#include "utils/logger.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/geometry.hpp>
+#include <boost/test/unit_test.hpp>
+
+namespace ng = navitia::georef;
+namespace nt = navitia::type;
+
+struct logger_initialized {
+    logger_initialized() { navitia::init_logger(); }
+};
+BOOST_GLOBAL_FIXTURE(logger_initialized);
+
+// a small georef: a way of one edge and two admins, only the first one with a boundary
+struct georef_fixture {
+    nt::Data data;
+    const std::string cache_file = "georef_cache_test.cache";
+    const std::string key = ed::GeorefCache::key("3", 0.01, false);
+
+    georef_fixture() {
+        boost::filesystem::remove(cache_file);
+
+        auto& graph = data.geo_ref->graph;
+        boost::add_vertex(ng::Vertex(nt::GeographicalCoord(2.35, 48.85)), graph);
+        boost::add_vertex(ng::Vertex(nt::GeographicalCoord(2.36, 48.86)), graph);
+        boost::add_edge(0, 1, ng::Edge(0, navitia::seconds(42)), graph);
+        auto* way = new ng::Way();
+        way->idx = 0;
+        way->uri = "way:1";
+        way->name = "rue de la paix";
+        way->edges.push_back(std::make_pair(0, 1));
+        data.geo_ref->ways.push_back(way);
+
+        auto* paris = new ng::Admin();
+        paris->idx = 0;
+        paris->uri = "admin:75056";
+        paris->insee = "75056";
+        paris->name = "Paris";
+        paris->level = 8;
+        boost::geometry::read_wkt("MULTIPOLYGON(((2.2 48.8,2.2 48.9,2.5 48.9,2.5 48.8,2.2 48.8)))", paris->boundary);
+        data.geo_ref->admins.push_back(paris);
+        auto* no_boundary = new ng::Admin();
+        no_boundary->idx = 1;
+        no_boundary->uri = "admin:93048";
+        no_boundary->insee = "93048";
+        no_boundary->name = "Montreuil";
+        data.geo_ref->admins.push_back(no_boundary);
+    }
+
+    ~georef_fixture() { boost::filesystem::remove(cache_file); }
+};
+
+BOOST_FIXTURE_TEST_CASE(georef_cache_is_reloaded_with_the_boundaries, georef_fixture) {
+    const ed::GeorefCache cache(cache_file);
+    cache.save(data, key);
+
+    nt::Data reloaded;
+    std::unordered_map<std::string, ng::Admin*> admin_by_insee_code;
+    BOOST_REQUIRE(cache.load(reloaded, key, admin_by_insee_code));
+
+    const auto& graph = reloaded.geo_ref->graph;
+    BOOST_REQUIRE_EQUAL(boost::num_vertices(graph), 2);
+    BOOST_REQUIRE_EQUAL(boost::num_edges(graph), 1);
+    BOOST_CHECK_EQUAL(graph[1].coord.lon(), 2.36);
+    BOOST_CHECK_EQUAL(graph[1].coord.lat(), 48.86);
+    BOOST_CHECK_EQUAL(graph[*boost::edges(graph).first].duration, navitia::seconds(42));
+    BOOST_REQUIRE_EQUAL(reloaded.geo_ref->ways.size(), 1);
+    BOOST_CHECK_EQUAL(reloaded.geo_ref->ways[0]->name, "rue de la paix");
+
+    BOOST_REQUIRE_EQUAL(reloaded.geo_ref->admins.size(), data.geo_ref->admins.size());
+    for (size_t i = 0; i < data.geo_ref->admins.size(); ++i) {
+        const auto* admin = data.geo_ref->admins[i];
+        const auto* reloaded_admin = reloaded.geo_ref->admins[i];
+        BOOST_CHECK_EQUAL(reloaded_admin->uri, admin->uri);
+        BOOST_CHECK_EQUAL(reloaded_admin->insee, admin->insee);
+        BOOST_CHECK_EQUAL(reloaded_admin->name, admin->name);
+        BOOST_CHECK_EQUAL(reloaded_admin->level, admin->level);
+        // the boundaries are not in the georef serialization, the cache keeps them
+        BOOST_CHECK_EQUAL(reloaded_admin->boundary.size(), admin->boundary.size());
+        BOOST_CHECK(boost::geometry::equals(reloaded_admin->boundary, admin->boundary));
+        BOOST_CHECK_EQUAL(admin_by_insee_code.at(admin->insee), reloaded_admin);
+    }
+    BOOST_CHECK_EQUAL(admin_by_insee_code.size(), 2);
+    BOOST_CHECK(!reloaded.geo_ref->admins[0]->boundary.empty());
+    BOOST_CHECK(reloaded.geo_ref->admins[1]->boundary.empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(georef_cache_misses_when_the_file_is_corrupt, georef_fixture) {
+    const ed::GeorefCache cache(cache_file);
+    cache.save(data, key);
+    boost::filesystem::resize_file(cache_file, boost::filesystem::file_size(cache_file) / 2);
+
+    nt::Data reloaded;
+    std::unordered_map<std::string, ng::Admin*> admin_by_insee_code;
+    BOOST_CHECK(!cache.load(reloaded, key, admin_by_insee_code));
+    // nothing partly read is kept, and the file is removed for the next run
+    BOOST_CHECK(reloaded.geo_ref->admins.empty());
+    BOOST_CHECK(reloaded.geo_ref->ways.empty());
+    BOOST_CHECK_EQUAL(boost::num_vertices(reloaded.geo_ref->graph), 0);
+    BOOST_CHECK(admin_by_insee_code.empty());
+    BOOST_CHECK(!boost::filesystem::exists(cache_file));
+}
+
+BOOST_FIXTURE_TEST_CASE(georef_cache_misses_when_the_key_changes, georef_fixture) {
+    const ed::GeorefCache cache(cache_file);
+    nt::Data reloaded;
+    std::unordered_map<std::string, ng::Admin*> admin_by_insee_code;
+    BOOST_CHECK(!cache.load(reloaded, key, admin_by_insee_code));
+
+    cache.save(data, key);
+    // everything the georef read from the database depends on is in the key
+    const std::vector<std::string> other_keys = {
+        ed::GeorefCache::key("4", 0.01, false),
+        ed::GeorefCache::key("3", 0.02, false),
+        ed::GeorefCache::key("3", 0.01, true),
+        ed::GeorefCache::key("3", 0.01, false, nt::Data::data_version + 1),
+    };
+    for (const auto& other_key : other_keys) {
+        BOOST_CHECK_NE(other_key, key);
+        BOOST_CHECK(!cache.load(reloaded, other_key, admin_by_insee_code));
+    }
+    BOOST_CHECK(reloaded.geo_ref->admins.empty());
+    BOOST_CHECK_EQUAL(boost::num_vertices(reloaded.geo_ref->graph), 0);
+    BOOST_CHECK(admin_by_insee_code.empty());
+
+    BOOST_CHECK(cache.load(reloaded, key, admin_by_insee_code));
+    BOOST_CHECK_EQUAL(reloaded.geo_ref->admins.size(), 2);
+}
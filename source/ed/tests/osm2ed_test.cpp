@@ -36,6 +36,7 @@ www.navitia.io
 #include "utils/lotus.h"
 #include "ed/types.h"
 #include "ed/osm2ed.h"
+#include "ed/default_poi_types.h"
 
 struct logger_initialized {
     logger_initialized() { navitia::init_logger(); }
@@ -159,3 +160,37 @@ BOOST_AUTO_TEST_CASE(osm_admin_without_zero_in_month_in_end_date) {
     relations_visitor.relation_callback(5, tags, ref);
     BOOST_CHECK(relations_visitor.cache.admins.find(5) == relations_visitor.cache.admins.end());
 }
+
+// The nodes are stored once, sorted by id, and a node shared by two streets is an intersection
+BOOST_AUTO_TEST_CASE(osm_nodes_built_from_the_ways) {
+    OSMCache cache(std::unique_ptr<Lotus>(), boost::none);
+    const PoiTypeParams poi_params(DEFAULT_JSON_POI_TYPES);
+    ReadWaysVisitor ways_visitor(cache, poi_params);
+
+    const Tags street = {{"name", "rue de la paix"}, {"highway", "residential"}};
+    ways_visitor.way_callback(1, street, {30, 20, 10});
+    ways_visitor.way_callback(2, street, {10, 40});
+    cache.build_nodes();
+
+    BOOST_REQUIRE_EQUAL(cache.nodes.size(), 4);
+    BOOST_CHECK_EQUAL(cache.nodes[0].osm_id, 10);
+    BOOST_CHECK_EQUAL(cache.nodes[1].osm_id, 20);
+    BOOST_CHECK_EQUAL(cache.nodes[2].osm_id, 30);
+    BOOST_CHECK_EQUAL(cache.nodes[3].osm_id, 40);
+    BOOST_CHECK(cache.find_node(10)->is_used_more_than_once());
+    BOOST_CHECK(!cache.find_node(20)->is_used_more_than_once());
+    BOOST_CHECK(cache.find_node(50) == nullptr);
+
+    const auto way = cache.ways.find(OSMWay(1));
+    BOOST_REQUIRE(way != cache.ways.end());
+    BOOST_REQUIRE_EQUAL(way->nodes.size(), 3);
+    BOOST_CHECK(way->nodes[0] == cache.find_node(30));
+    BOOST_CHECK(way->nodes[2] == cache.find_node(10));
+    BOOST_CHECK(way->node_ids.empty());
+
+    ReadNodesVisitor nodes_visitor(cache);
+    nodes_visitor.node_callback(20, 2.35, 48.85, {});
+    BOOST_REQUIRE(cache.find_node(20)->is_defined());
+    BOOST_CHECK_CLOSE(cache.find_node(20)->lon(), 2.35, 0.001);
+    BOOST_CHECK(!cache.find_node(30)->is_defined());
+}
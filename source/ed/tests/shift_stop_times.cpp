@@ -283,3 +283,43 @@ BOOST_AUTO_TEST_CASE(shift_after_freq) {
     BOOST_CHECK_EQUAL(vj->start_time, 0);
     BOOST_CHECK_EQUAL(vj->end_time, 1000);
 }
+
+BOOST_AUTO_TEST_CASE(clean_keeps_the_order_of_the_remaining_objects) {
+    ed::Data d;
+    auto* vp = new navitia::type::ValidityPattern(boost::gregorian::date(2020, 1, 1), "1");
+    d.validity_patterns.push_back(vp);
+    auto add_vj = [&](const std::string& uri, const std::vector<int>& times) {
+        auto* vj = new ed::types::VehicleJourney();
+        vj->uri = uri;
+        vj->meta_vj_name = uri;
+        vj->validity_pattern = vp;
+        vj->adapted_validity_pattern = vp;
+        d.vehicle_journeys.push_back(vj);
+        d.meta_vj_map[uri].theoric_vj.push_back(vj);
+        for (int time : times) {
+            auto* st = new ed::types::StopTime();
+            st->vehicle_journey = vj;
+            st->arrival_time = st->departure_time = st->alighting_time = st->boarding_time = time;
+            vj->stop_time_list.push_back(st);
+            d.stops.push_back(st);
+        }
+        return vj;
+    };
+    auto* vj1 = add_vj("vj1", {100, 200});
+    add_vj("empty", {});
+    add_vj("negative", {-100, 200});
+    auto* vj4 = add_vj("vj4", {300, 400, 500});
+
+    d.clean();
+
+    BOOST_REQUIRE_EQUAL(d.vehicle_journeys.size(), 2);
+    BOOST_CHECK_EQUAL(d.vehicle_journeys[0], vj1);
+    BOOST_CHECK_EQUAL(d.vehicle_journeys[1], vj4);
+    BOOST_REQUIRE_EQUAL(d.stops.size(), 5);
+    BOOST_CHECK_EQUAL(d.stops[0], vj1->stop_time_list[0]);
+    BOOST_CHECK_EQUAL(d.stops[1], vj1->stop_time_list[1]);
+    BOOST_CHECK_EQUAL(d.stops[2], vj4->stop_time_list[0]);
+    BOOST_CHECK_EQUAL(d.stops[4], vj4->stop_time_list[2]);
+    BOOST_CHECK_EQUAL(d.meta_vj_map.size(), 2);
+    BOOST_CHECK_EQUAL(d.meta_vj_map.count("negative"), 0);
+}
@@ -0,0 +1,178 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "ed/connectors/wkb_reader.h"
+#include "type/geographical_coord.h"
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_wkb_reader
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace nt = navitia::type;
+using ed::connectors::read_hex_wkb;
+
+namespace {
+
+// little endian wkb, as sent by PostGIS
+struct HexWkbWriter {
+    std::stringstream hex;
+
+    void add_bytes(uint64_t value, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            hex << std::hex << std::setw(2) << std::setfill('0') << ((value >> (8 * i)) & 0xff);
+        }
+    }
+    void add_header(uint32_t type) {
+        add_bytes(1, 1);
+        add_bytes(type, 4);
+    }
+    void add_point(const nt::GeographicalCoord& coord) {
+        for (const double d : {coord.lon(), coord.lat()}) {
+            uint64_t value;
+            std::memcpy(&value, &d, sizeof(d));
+            add_bytes(value, 8);
+        }
+    }
+    void add_points(const std::vector<nt::GeographicalCoord>& coords) {
+        add_bytes(coords.size(), 4);
+        for (const auto& coord : coords) {
+            add_point(coord);
+        }
+    }
+};
+
+nt::LineString make_line(size_t nb_points, double offset) {
+    nt::LineString line;
+    for (size_t i = 0; i < nb_points; ++i) {
+        line.emplace_back(2.3 + offset + i * 1e-5, 48.8 + std::sin(double(i)) * 1e-3);
+    }
+    return line;
+}
+
+template <typename F>
+double duration_ms(const F& f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(read_point_and_linestring) {
+    HexWkbWriter point_writer;
+    point_writer.add_header(1);
+    point_writer.add_point({2.123456789012345, 48.98765432109876});
+    const auto point_hex = point_writer.hex.str();
+    nt::GeographicalCoord point;
+    read_hex_wkb(point_hex, point);
+    BOOST_CHECK_EQUAL(point.lon(), 2.123456789012345);
+    BOOST_CHECK_EQUAL(point.lat(), 48.98765432109876);
+
+    // big endian, with the z coordinate and the srid of the extended wkb
+    nt::LineString line;
+    read_hex_wkb(
+        "00a0000002000010e600000002"
+        "3ff000000000000040000000000000004008000000000000"
+        "401000000000000040140000000000004018000000000000",
+        line);
+    BOOST_REQUIRE_EQUAL(line.size(), 2);
+    BOOST_CHECK_EQUAL(line[0], nt::GeographicalCoord(1, 2));
+    BOOST_CHECK_EQUAL(line[1], nt::GeographicalCoord(4, 5));
+
+    // a null geometry
+    read_hex_wkb("", line);
+    BOOST_CHECK(line.empty());
+
+    BOOST_CHECK_THROW(read_hex_wkb(point_hex, line), navitia::exception);
+    BOOST_CHECK_THROW(read_hex_wkb("0102000000ff", line), navitia::exception);
+    BOOST_CHECK_THROW(read_hex_wkb("01020000000000000000", line), navitia::exception);
+}
+
+BOOST_AUTO_TEST_CASE(read_multipolygon) {
+    HexWkbWriter writer;
+    writer.add_header(6);
+    writer.add_bytes(2, 4);
+    writer.add_header(3);
+    writer.add_bytes(2, 4);
+    writer.add_points({{0, 0}, {0, 10}, {10, 10}, {10, 0}, {0, 0}});
+    writer.add_points({{2, 2}, {4, 2}, {4, 4}, {2, 4}, {2, 2}});
+    writer.add_header(3);
+    writer.add_bytes(1, 4);
+    writer.add_points({{20, 0}, {20, 2}, {22, 2}, {22, 0}, {20, 0}});
+
+    nt::MultiPolygon from_wkb, from_wkt;
+    read_hex_wkb(writer.hex.str(), from_wkb);
+    boost::geometry::read_wkt(
+        "MULTIPOLYGON(((0 0,0 10,10 10,10 0,0 0),(2 2,4 2,4 4,2 4,2 2)),((20 0,20 2,22 2,22 0,20 0)))", from_wkt);
+    BOOST_CHECK(boost::geometry::equals(from_wkb, from_wkt));
+    BOOST_REQUIRE_EQUAL(from_wkb.size(), 2);
+    BOOST_CHECK_EQUAL(from_wkb[0].inners().size(), 1);
+    BOOST_CHECK_EQUAL(from_wkb[1].outer().size(), 5);
+}
+
+// the shapes of the lines are the largest geometries read by ed2nav with the edges of the street network
+BOOST_AUTO_TEST_CASE(wkb_faster_than_wkt) {
+    nt::MultiLineString shape;
+    HexWkbWriter writer;
+    writer.add_header(5);
+    writer.add_bytes(20, 4);
+    for (size_t i = 0; i < 20; ++i) {
+        shape.push_back(make_line(10000, i * 0.1));
+        writer.add_header(2);
+        writer.add_points(shape.back());
+    }
+    std::stringstream wkt;
+    wkt << std::setprecision(17) << boost::geometry::wkt(shape);
+    const auto wkt_str = wkt.str();
+    const auto hex_str = writer.hex.str();
+
+    nt::MultiLineString from_wkt, from_wkb;
+    const auto wkt_duration = duration_ms([&]() { boost::geometry::read_wkt(wkt_str, from_wkt); });
+    const auto wkb_duration = duration_ms([&]() { read_hex_wkb(hex_str, from_wkb); });
+    BOOST_TEST_MESSAGE("200000 points read from wkt in " << wkt_duration << "ms, from hexadecimal wkb in "
+                                                         << wkb_duration << "ms");
+
+    // the wkb keeps the exact coordinates
+    BOOST_REQUIRE_EQUAL(from_wkb.size(), shape.size());
+    for (size_t i = 0; i < shape.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(from_wkb[i].size(), shape[i].size());
+        for (size_t j = 0; j < shape[i].size(); ++j) {
+            BOOST_REQUIRE_EQUAL(from_wkb[i][j].lon(), shape[i][j].lon());
+            BOOST_REQUIRE_EQUAL(from_wkb[i][j].lat(), shape[i][j].lat());
+        }
+    }
+    BOOST_CHECK_EQUAL(from_wkt.size(), shape.size());
+}
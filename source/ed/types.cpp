@@ -30,8 +30,15 @@ www.navitia.io
 
 #include "types.h"
 
+#include <boost/pool/singleton_pool.hpp>
+
 using namespace ed::types;
 
+namespace {
+struct StopTimePoolTag {};
+using StopTimePool = boost::singleton_pool<StopTimePoolTag, sizeof(StopTime)>;
+}  // namespace
+
 bool CommercialMode::operator<(const CommercialMode& other) const {
     return this->name < other.name || (this->name == other.name && this < &other);
 }
@@ -134,6 +141,21 @@ bool StopPointConnection::operator<(const StopPointConnection& other) const {
     return *(this->departure) < *(other.departure);
 }
 
+void* StopTime::operator new(size_t size) {
+    assert(size == sizeof(StopTime));
+    void* ptr = StopTimePool::malloc();
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void StopTime::operator delete(void* ptr) {
+    if (ptr) {
+        StopTimePool::free(ptr);
+    }
+}
+
 bool StopTime::operator<(const StopTime& other) const {
     if (this->vehicle_journey != other.vehicle_journey) {
         return *(this->vehicle_journey) < *(other.vehicle_journey);
@@ -335,6 +335,11 @@ struct StopTime {
 
     uint16_t local_traffic_zone = std::numeric_limits<uint16_t>::max();
 
+    // there are tens of millions of stop times on the big feeds, they are allocated in a pool whose memory is
+    // reused by the next stop times and given back at the end of the process
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr);
+
     bool operator<(const StopTime& other) const;
     void shift_times(int n_days) {
         arrival_time += n_days * int(navitia::DateTimeUtils::SECONDS_PER_DAY);
@@ -32,6 +32,7 @@ www.navitia.io
 
 #include <boost/algorithm/string/join.hpp>
 #include <boost/geometry.hpp>
+#include <boost/range/algorithm_ext/erase.hpp>
 
 namespace navitia {
 namespace georef {
@@ -81,20 +82,39 @@ std::string Admin::postal_codes_to_string() const {
     return boost::algorithm::join(this->postal_codes, ";");
 }
 
-AdminRtree build_admins_tree(const std::vector<Admin*> admins) {
-    AdminRtree admins_tree;
+void AdminRtree::insert(Admin* admin) {
     double min[2] = {0., 0.};
     double max[2] = {0., 0.};
+    if (!admin->boundary.empty()) {
+        const auto box = boost::geometry::return_envelope<Box>(admin->boundary);
+        min[0] = box.min_corner().lon();
+        min[1] = box.min_corner().lat();
+        max[0] = box.max_corner().lon();
+        max[1] = box.max_corner().lat();
+    }
+    Insert(min, max, admin);
+    boundaries.emplace(admin, PreparedBoundary<multi_polygon_type>(admin->boundary));
+}
+
+std::vector<Admin*> AdminRtree::search(const nt::GeographicalCoord& coord) {
+    std::vector<Admin*> result;
+
+    auto callback = [](Admin* admin, void* c) -> bool {
+        auto* candidates = reinterpret_cast<std::vector<Admin*>*>(c);
+        candidates->push_back(admin);
+        return true;
+    };
+    const double c[2] = {coord.lon(), coord.lat()};
+    Search(c, c, callback, &result);
+    boost::range::remove_erase_if(result,
+                                  [&](const Admin* admin) { return !boundaries.at(admin).within(coord); });
+    return result;
+}
+
+AdminRtree build_admins_tree(const std::vector<Admin*> admins) {
+    AdminRtree admins_tree;
     for (auto* admin : admins) {
-        if (!admin->boundary.empty()) {
-            boost::geometry::model::box<nt::GeographicalCoord> box;
-            boost::geometry::envelope(admin->boundary, box);
-            min[0] = box.min_corner().lon();
-            min[1] = box.min_corner().lat();
-            max[0] = box.max_corner().lon();
-            max[1] = box.max_corner().lat();
-        }
-        admins_tree.Insert(min, max, admin);
+        admins_tree.insert(admin);
     }
     return admins_tree;
 }
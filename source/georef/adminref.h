@@ -29,6 +29,7 @@ www.navitia.io
 */
 
 #pragma once
+#include "georef/prepared_boundary.h"
 #include "type/fwd_type.h"
 #include "type/geographical_coord.h"
 #include "type/type_interfaces.h"
@@ -72,10 +73,8 @@ struct Admin : nt::Header, nt::Nameable {
     nt::GeographicalCoord coord;
     multi_polygon_type boundary;
     std::vector<const Admin*> admin_list;
-    std::vector<const nt::StopArea*> main_stop_areas;
-
-    // TODO ODT NTFSv0.3: remove that when we stop to support NTFSv0.1
-    std::vector<const nt::StopPoint*> odt_stop_points;  // zone odt stop points for the admin
+    // the main stop areas and the odt stop points of the admin are in PT_Data, the georef doesn't point to pt
+    // objects so that kraken can share it between data
     Postal_codes postal_codes;
 
     Admin() : level(-1) {}
@@ -92,12 +91,34 @@ struct Admin : nt::Header, nt::Nameable {
     std::string postal_codes_to_string() const;
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
-        ar& idx& level& from_original_dataset& insee& name& uri& coord& admin_list& main_stop_areas& label&
-            odt_stop_points& postal_codes;
+        ar& idx& level& from_original_dataset& insee& name& uri& coord& admin_list& label& postal_codes;
     }
 };
 
-using AdminRtree = RTree<Admin*, double, 2>;
+/**
+ * Admins indexed by the envelope of their boundary
+ *
+ * The boundaries are prepared when inserted, the tree is meant to be built once for a batch of lookups
+ */
+class AdminRtree : private RTree<Admin*, double, 2> {
+    using Tree = RTree<Admin*, double, 2>;
+
+public:
+    // the admins without boundary are at (0, 0)
+    void insert(Admin* admin);
+    // the admins whose boundary contains the coord (boundary excluded)
+    std::vector<Admin*> search(const nt::GeographicalCoord& coord);
+
+    // iteration over the admins, every insertion must go through insert() to keep the boundaries
+    using Tree::Iterator;
+    using Tree::GetFirst;
+    using Tree::GetNext;
+    using Tree::IsNull;
+    using Tree::Count;
+
+private:
+    std::unordered_map<const Admin*, PreparedBoundary<multi_polygon_type>> boundaries;
+};
 AdminRtree build_admins_tree(const std::vector<Admin*> admins);
 }  // namespace georef
 }  // namespace navitia
@@ -44,11 +44,18 @@ void AstarPathFinder::init(const type::GeographicalCoord& start_coord,
                            const type::GeographicalCoord& dest_projected_coord,
                            nt::Mode_e mode,
                            const float speed_factor) {
-    PathFinder::init_start(start_coord, mode, speed_factor);
-
     // we initialize the costs to the maximum value
+    // like the distances, only the costs of the vertices touched by the previous search have to be reset
     size_t n = boost::num_vertices(geo_ref.graph);
-    costs.assign(n, bt::pos_infin);
+    if (costs.size() != n) {
+        costs.assign(n, bt::pos_infin);
+    } else {
+        for (const auto v : touched_vertices) {
+            costs[v] = bt::pos_infin;
+        }
+    }
+
+    PathFinder::init_start(start_coord, mode, speed_factor);
 
     if (starting_edge.found) {
         costs.at(starting_edge[source_e]) =
@@ -84,11 +91,7 @@ void AstarPathFinder::astar(const std::array<georef::vertex_t, 2>& origin_vertex
     // Note: the predecessors have been updated in init
 
     // Fill color map in white before A*
-    std::fill(color.data.get(),
-              color.data.get()
-                  + (color.n + boost::two_bit_color_map<>::elements_per_char - 1)
-                        / boost::two_bit_color_map<>::elements_per_char,
-              0);
+    reset_color();
 
     // we filter the graph to only use certain mean of transport
     using filtered_graph = boost::filtered_graph<georef::Graph, boost::keep_all, TransportationModeFilter>;
@@ -111,14 +114,15 @@ void AstarPathFinder::astar_shortest_paths_no_init_with_heap(const Graph& g,
                                                              const Compare& compare) {
     using MutableQueue = boost::d_ary_heap_indirect<vertex_t, 4, vertex_t*, navitia::time_duration*, Compare>;
     MutableQueue Q(&costs[0], &index_in_heap_map[0], compare);
+    const TouchedColorMap touched_color{&color, &touched_vertices};
 
     boost::detail::astar_bfs_visitor<astar_distance_heuristic, astar_distance_or_target_visitor, MutableQueue,
                                      vertex_t*, navitia::time_duration*, navitia::time_duration*, WeightMap,
-                                     boost::two_bit_color_map<>, SpeedDistanceCombiner, Compare>
-        bfs_vis(h, vis, Q, &predecessors[0], &costs[0], &distances[0], weight, color, combine, compare,
+                                     TouchedColorMap, SpeedDistanceCombiner, Compare>
+        bfs_vis(h, vis, Q, &predecessors[0], &costs[0], &distances[0], weight, touched_color, combine, compare,
                 navitia::seconds(0));
 
-    breadth_first_visit(g, &s_begin, &s_end, Q, bfs_vis, color);
+    breadth_first_visit(g, &s_begin, &s_end, Q, bfs_vis, touched_color);
 }
 
 // The cost of a starting edge is the distance from this edge to the projected destination point (distance_to_dest)
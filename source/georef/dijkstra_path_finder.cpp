@@ -201,11 +201,7 @@ template <class Visitor>
 void DijkstraPathFinder::dijkstra(const std::array<georef::vertex_t, 2>& origin_vertexes, const Visitor& visitor) {
     // Note: the predecessors have been updated in init
     // Fill color map in white before dijkstra
-    std::fill(color.data.get(),
-              color.data.get()
-                  + (color.n + boost::two_bit_color_map<>::elements_per_char - 1)
-                        / boost::two_bit_color_map<>::elements_per_char,
-              0);
+    reset_color();
 
     // we filter the graph to only use certain mean of transport
     using filtered_graph = boost::filtered_graph<georef::Graph, boost::keep_all, TransportationModeFilter>;
@@ -282,7 +278,7 @@ void DijkstraPathFinder::dijkstra_shortest_paths_no_init_with_heap(const Graph&
                                         SpeedDistanceCombiner, Compare>
         bfs_vis(visitor, Q, weight, &predecessors[0], &distances[0], combine, compare, navitia::seconds(0));
 
-    breadth_first_visit(g, &s_begin, &s_end, Q, bfs_vis, color);
+    breadth_first_visit(g, &s_begin, &s_end, Q, bfs_vis, TouchedColorMap{&color, &touched_vertices});
 }
 
 }  // namespace georef
@@ -44,8 +44,13 @@ public:
     DijkstraPathFinder(const DijkstraPathFinder& o) = default;
     virtual ~DijkstraPathFinder();
 
+    // the reachable stop points have been found in the FallbackCache, no dijkstra has been run
+    // so the paths to the stop points are computed on demand
+    bool paths_on_demand = false;
+
     void init(const type::GeographicalCoord& start_coord, nt::Mode_e mode, const float speed_factor) {
         PathFinder::init_start(start_coord, mode, speed_factor);
+        paths_on_demand = false;
     }
 
     void start_distance_dijkstra(const navitia::time_duration& radius);
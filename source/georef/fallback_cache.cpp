@@ -0,0 +1,107 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+
+#include "fallback_cache.h"
+
+#include "utils/logger.h"
+
+#include <tuple>
+
+namespace navitia {
+namespace georef {
+
+FallbackCache::Key::Key(const ProjectionData& projection,
+                        const type::GeographicalCoord& start_coord,
+                        type::Mode_e mode,
+                        float speed_factor,
+                        const navitia::time_duration& max_duration)
+    : vertices(projection.vertices),
+      projected(projection.projected),
+      start_coord(start_coord),
+      mode(mode),
+      speed_factor(speed_factor),
+      max_duration(max_duration.total_seconds()) {}
+
+bool FallbackCache::Key::operator<(const Key& other) const {
+    const auto to_tuple = [](const Key& k) {
+        return std::make_tuple(k.vertices[source_e], k.vertices[target_e], k.projected.lon(), k.projected.lat(),
+                               k.start_coord.lon(), k.start_coord.lat(), k.mode, k.speed_factor, k.max_duration);
+    };
+    return to_tuple(*this) < to_tuple(other);
+}
+
+FallbackCache::FallbackCache(size_t max_size) : max_size(max_size) {}
+
+FallbackCache::~FallbackCache() {
+    auto logger = log4cplus::Logger::getInstance("log");
+    LOG4CPLUS_INFO(logger, "Fallback cache hits: " << nb_hits << " / " << nb_calls << " (max size " << max_size
+                                                   << ")");
+}
+
+FallbackCache::Value FallbackCache::get(const Key& key) {
+    ++nb_calls;
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = items_by_key.find(key);
+    if (it == items_by_key.end()) {
+        return nullptr;
+    }
+    ++nb_hits;
+    items.splice(items.begin(), items, it->second);
+    return it->second->second;
+}
+
+void FallbackCache::add(const Key& key, routing::map_stop_point_duration stop_points) {
+    if (max_size == 0) {
+        return;
+    }
+    auto value = std::make_shared<const routing::map_stop_point_duration>(std::move(stop_points));
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = items_by_key.find(key);
+    if (it != items_by_key.end()) {
+        // computed concurrently by another request
+        items.splice(items.begin(), items, it->second);
+        return;
+    }
+    items.emplace_front(key, std::move(value));
+    items_by_key.emplace(key, items.begin());
+    if (items.size() > max_size) {
+        items_by_key.erase(items.back().first);
+        items.pop_back();
+    }
+}
+
+size_t FallbackCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return items.size();
+}
+
+}  // namespace georef
+}  // namespace navitia
@@ -0,0 +1,109 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+
+#pragma once
+
+#include "path_finder.h"
+#include "routing/raptor_utils.h"
+#include "type/time_duration.h"
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace navitia {
+namespace georef {
+
+/**
+ * Cache of the stop points reachable from a projection on the street network
+ *
+ * A large share of the journeys start or end at the same stations, pois or admins,
+ * the fallback durations only depend on the starting coordinate and its projection,
+ * the mode, the speed factor and the max duration, so we keep them to avoid running
+ * the same dijkstra again.
+ *
+ * The cache is owned by the GeoRef, so it's discarded with its Data generation.
+ * It's thread safe, the least recently used entries are dropped beyond max_size.
+ */
+class FallbackCache {
+public:
+    struct Key {
+        flat_enum_map<ProjectionData::Direction, vertex_t> vertices;
+        type::GeographicalCoord projected;
+        // the stop points are first searched in crow fly around it
+        type::GeographicalCoord start_coord;
+        type::Mode_e mode;
+        float speed_factor;
+        long max_duration;  // in seconds
+
+        Key(const ProjectionData& projection,
+            const type::GeographicalCoord& start_coord,
+            type::Mode_e mode,
+            float speed_factor,
+            const navitia::time_duration& max_duration);
+        bool operator<(const Key& other) const;
+    };
+    using Value = std::shared_ptr<const routing::map_stop_point_duration>;
+
+    explicit FallbackCache(size_t max_size);
+    ~FallbackCache();
+
+    // return nullptr if the key is not in the cache
+    Value get(const Key& key);
+    void add(const Key& key, routing::map_stop_point_duration stop_points);
+
+    size_t size() const;
+    size_t get_max_size() const { return max_size; }
+    size_t get_nb_calls() const { return nb_calls; }
+    size_t get_nb_hits() const { return nb_hits; }
+
+private:
+    // most recently used first
+    using Items = std::list<std::pair<Key, Value>>;
+
+    const size_t max_size;
+    mutable std::mutex mutex;
+    Items items;
+    std::map<Key, Items::iterator> items_by_key;
+    std::atomic<size_t> nb_calls{0};
+    std::atomic<size_t> nb_hits{0};
+};
+
+// hits and misses of a FallbackCache, for the metrics
+struct FallbackCacheStats {
+    size_t nb_hits = 0;
+    size_t nb_misses = 0;
+};
+
+}  // namespace georef
+}  // namespace navitia
@@ -30,6 +30,7 @@ www.navitia.io
 
 #include "georef.h"
 
+#include "fallback_cache.h"
 #include "type/stop_area.h"
 #include "type/stop_point.h"
 #include "utils/configuration.h"
@@ -410,6 +411,10 @@ void GeoRef::build_proximity_list() {
     poi_proximity_list.build();
 }
 
+void GeoRef::init_fallback_cache(size_t max_size) {
+    fallback_cache = max_size > 0 ? std::make_shared<FallbackCache>(max_size) : nullptr;
+}
+
 static const Admin* find_city_admin(const std::vector<Admin*>& admins) {
     for (Admin* admin : admins) {
         // Level 8: City
@@ -514,7 +519,8 @@ std::vector<nf::Autocomplete<nt::idx_t>::fl_quality> GeoRef::find_ways(
     const int nbmax,
     const int search_type,
     const std::function<bool(nt::idx_t)>& keep_element,
-    const std::set<std::string>& ghostwords) const {
+    const std::set<std::string>& ghostwords,
+    const nf::Autocomplete<nt::idx_t>::Scores& scores) const {
     std::vector<nf::Autocomplete<nt::idx_t>::fl_quality> to_return;
     boost::tokenizer<> tokens(str);
 
@@ -535,9 +541,9 @@ std::vector<nf::Autocomplete<nt::idx_t>::fl_quality> GeoRef::find_ways(
         search_str = str;
     }
     if (search_type == 0) {
-        to_return = fl_way.find_complete(search_str, nbmax, keep_element, ghostwords);
+        to_return = fl_way.find_complete(search_str, nbmax, keep_element, ghostwords, scores);
     } else {
-        to_return = fl_way.find_partial_with_pattern(search_str, word_weight, nbmax, keep_element, ghostwords);
+        to_return = fl_way.find_partial_with_pattern(search_str, word_weight, nbmax, keep_element, ghostwords, scores);
     }
 
     /// récupération des coordonnées du numéro recherché pour chaque rue
@@ -625,19 +631,7 @@ std::vector<Admin*> GeoRef::find_admins(const type::GeographicalCoord& coord) co
 }
 
 std::vector<Admin*> search_admins(const type::GeographicalCoord& coord, AdminRtree& admins_tree) {
-    std::vector<Admin*> result;
-
-    auto callback = [](Admin* admin, void* c) -> bool {
-        auto* context = reinterpret_cast<std::pair<type::GeographicalCoord, std::vector<Admin*>*>*>(c);
-        if (boost::geometry::within(context->first, admin->boundary)) {
-            context->second->push_back(admin);
-        }
-        return true;
-    };
-    double c[2] = {coord.lon(), coord.lat()};
-    auto context = std::make_pair(coord, &result);
-    admins_tree.Search(c, c, callback, &context);
-    return result;
+    return admins_tree.search(coord);
 }
 
 std::vector<Admin*> GeoRef::find_admins(const type::GeographicalCoord& coord, AdminRtree& admins_tree) const {
@@ -651,6 +645,34 @@ std::vector<Admin*> GeoRef::find_admins(const type::GeographicalCoord& coord, Ad
     return result;
 }
 
+bool GeoRef::has_same_projections(const std::vector<type::StopPoint*>& stop_points) const {
+    if (stop_points.size() != projected_stop_points.size()) {
+        return false;
+    }
+    for (const type::StopPoint* stop_point : stop_points) {
+        const auto& projections = projected_stop_points[stop_point->idx];
+        bool all_found = true;
+        for (const auto mode : enum_range<nt::Mode_e>()) {
+            if (!projections[mode].found) {
+                all_found = false;
+            } else if (!(projections[mode].real_coord == stop_point->coord)) {
+                return false;
+            }
+        }
+        if (all_found) {
+            // a projection only depends on the projected coordinate
+            continue;
+        }
+        const auto new_projections = project_stop_point(stop_point).first;
+        for (const auto mode : enum_range<nt::Mode_e>()) {
+            if (new_projections[mode].found != projections[mode].found) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 std::pair<GeoRef::ProjectionByMode, bool> GeoRef::project_stop_point(const type::StopPoint* stop_point) const {
     bool one_proj_found = false;
     ProjectionByMode projections;
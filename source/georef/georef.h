@@ -44,6 +44,7 @@ www.navitia.io
 #include <boost/serialization/set.hpp>
 
 #include <map>
+#include <memory>
 #include <set>
 #include <functional>
 
@@ -197,6 +198,7 @@ struct ProjectionData;
 
 struct POI;
 struct POIType;
+class FallbackCache;
 
 std::vector<Admin*> search_admins(const type::GeographicalCoord& coord, AdminRtree& admins_tree);
 
@@ -259,6 +261,10 @@ struct GeoRef {
 
     int word_weight = 5;  // Pas serialisé : lu dans le fichier ini
 
+    // Not serialized: stop points reachable from the projections used by the requests,
+    // no cache until init_fallback_cache() is called
+    std::shared_ptr<FallbackCache> fallback_cache;
+
     void init();
 
     template <class Archive>
@@ -280,6 +286,8 @@ struct GeoRef {
     /** Construit l'indexe spatial */
     void build_proximity_list();
 
+    void init_fallback_cache(size_t max_size);
+
     ///  Construit l'indexe autocomplete à partir des rues
     void build_autocomplete_list();
 
@@ -293,11 +301,14 @@ struct GeoRef {
     void build_pois_map();
 
     /// Recherche d'une adresse avec un numéro en utilisant Autocomplete
-    std::vector<nf::Autocomplete<nt::idx_t>::fl_quality> find_ways(const std::string& str,
-                                                                   const int nbmax,
-                                                                   const int search_type,
-                                                                   const std::function<bool(nt::idx_t)>& keep_element,
-                                                                   const std::set<std::string>& ghostwords) const;
+    /// the scores of the ways are the ones of fl_way unless they are given (see autocomplete::admin_list_score)
+    std::vector<nf::Autocomplete<nt::idx_t>::fl_quality> find_ways(
+        const std::string& str,
+        const int nbmax,
+        const int search_type,
+        const std::function<bool(nt::idx_t)>& keep_element,
+        const std::set<std::string>& ghostwords,
+        const nf::Autocomplete<nt::idx_t>::Scores& scores = nullptr) const;
     std::vector<Admin*> find_admins(const type::GeographicalCoord&) const;
     std::vector<Admin*> find_admins(const type::GeographicalCoord&, AdminRtree&) const;
 
@@ -313,6 +324,12 @@ struct GeoRef {
      */
     std::pair<ProjectionByMode, bool> project_stop_point(const type::StopPoint* stop_point) const;
 
+    /** true when projecting the stop points would give projected_stop_points again
+     *
+     * A georef shared by several data can't be projected again, it is only kept when this is true
+     */
+    bool has_same_projections(const std::vector<type::StopPoint*>& stop_points) const;
+
     /** Retourne l'arc (segment) le plus proche
      *
      * Pour le trouver, on cherche le nœud le plus proche, puis pour chaque arc adjacent, on garde le plus proche
@@ -33,6 +33,8 @@ www.navitia.io
 #include "utils/logger.h"
 
 #include <boost/math/constants/constants.hpp>
+#include <boost/range/algorithm/sort.hpp>
+#include <boost/range/algorithm/unique.hpp>
 
 namespace navitia {
 namespace georef {
@@ -103,11 +105,29 @@ void PathFinder::init_start(const type::GeographicalCoord& start_coord, nt::Mode
 
     distance_to_entry_point.clear();
     // we initialize the distances to the maximum value
+    // only the vertices reached by the previous search have to be reset, unless the graph has changed
     size_t n = boost::num_vertices(geo_ref.graph);
-    distances.assign(n, bt::pos_infin);
-    // for the predecessors no need to clean the values, the important one will be updated during search
-    predecessors.resize(n);
-    index_in_heap_map.resize(n);
+    if (distances.size() != n) {
+        distances.assign(n, bt::pos_infin);
+        // for the predecessors no need to clean the values, the important one will be updated during search
+        predecessors.resize(n);
+        index_in_heap_map.resize(n);
+        if (color.n != n) {
+            color = boost::two_bit_color_map<>(n);
+        } else {
+            std::fill(color.data.get(),
+                      color.data.get()
+                          + (color.n + boost::two_bit_color_map<>::elements_per_char - 1)
+                                / boost::two_bit_color_map<>::elements_per_char,
+                      0);
+        }
+    } else {
+        for (const auto v : touched_vertices) {
+            distances[v] = bt::pos_infin;
+            put(color, v, boost::two_bit_white);
+        }
+    }
+    touched_vertices.clear();
 
     if (starting_edge.found) {
         // durations initializations
@@ -116,6 +136,8 @@ void PathFinder::init_start(const type::GeographicalCoord& start_coord, nt::Mode
         distances[starting_edge[target_e]] = crow_fly_duration(starting_edge.distances[target_e]);
         predecessors[starting_edge[source_e]] = starting_edge[source_e];
         predecessors[starting_edge[target_e]] = starting_edge[target_e];
+        touched_vertices.push_back(starting_edge[source_e]);
+        touched_vertices.push_back(starting_edge[target_e]);
 
         if (starting_edge[target_e] != starting_edge[source_e]) {  // if we're on a useless edge we do not enhance
             // small enchancement, if the projection is done on a node, we disable the crow fly
@@ -128,9 +150,14 @@ void PathFinder::init_start(const type::GeographicalCoord& start_coord, nt::Mode
             }
         }
     }
+}
 
-    if (color.n != n) {
-        color = boost::two_bit_color_map<>(n);
+void PathFinder::reset_color() {
+    // a search run several times from the same start colors the same vertices again, remove the duplicates
+    boost::sort(touched_vertices);
+    touched_vertices.erase(boost::unique<boost::return_found>(touched_vertices), touched_vertices.end());
+    for (const auto v : touched_vertices) {
+        put(color, v, boost::two_bit_white);
     }
 }
 
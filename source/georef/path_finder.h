@@ -112,6 +112,33 @@ struct SpeedDistanceCombiner
     }
 };
 
+/**
+ * Color map that records the vertices it colors
+ *
+ * A search only visits a small part of the graph, so the next one only has to reset the distances and colors of the
+ * vertices recorded here instead of the whole graph
+ */
+struct TouchedColorMap {
+    using key_type = vertex_t;
+    using value_type = boost::two_bit_color_type;
+    using reference = value_type;
+    using category = boost::read_write_property_map_tag;
+
+    boost::two_bit_color_map<>* color;
+    std::vector<vertex_t>* touched_vertices;
+};
+
+inline boost::two_bit_color_type get(const TouchedColorMap& m, vertex_t v) {
+    return get(*m.color, v);
+}
+
+inline void put(const TouchedColorMap& m, vertex_t v, boost::two_bit_color_type c) {
+    if (get(*m.color, v) == boost::two_bit_white) {
+        m.touched_vertices->push_back(v);
+    }
+    put(*m.color, v, c);
+}
+
 class PathFinder {
 public:
     const GeoRef& geo_ref;
@@ -141,6 +168,9 @@ public:
     // Color map for the dijkstra shortest path (to avoid extra alloc)
     boost::two_bit_color_map<> color;
 
+    // vertices whose distance or color have been set since the last init
+    std::vector<vertex_t> touched_vertices;
+
     PathFinder(const GeoRef& gref);
     PathFinder(const PathFinder& o) = default;
 
@@ -176,6 +206,9 @@ protected:
      */
     void init_start(const type::GeographicalCoord& start_coord, nt::Mode_e mode, const float speed_factor);
 
+    // set back in white the vertices colored by the previous search, before running a new one from the same start
+    void reset_color();
+
     // return the time the travel the distance at the current speed (used for projections)
     navitia::time_duration crow_fly_duration(const double distance) const;
 
@@ -0,0 +1,215 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <boost/geometry.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace navitia {
+namespace georef {
+
+/**
+ * Multipolygon prepared for the point in polygon tests
+ *
+ * The envelope of the multipolygon is cut in a grid, each cell is either crossed by an edge or fully inside or
+ * outside of the multipolygon. A point in a cell that isn't crossed is located without any computation, otherwise
+ * the ray casting only considers the edges of the row of the point, not the whole boundary.
+ *
+ * The admin boundaries have tens of thousands of points, so it's worth it as soon as a boundary is tested more than
+ * a few times. The prepared boundary doesn't reference the multipolygon, it's immutable once built.
+ */
+template <typename MultiPolygon>
+class PreparedBoundary {
+public:
+    using Point = typename boost::geometry::point_type<MultiPolygon>::type;
+
+    explicit PreparedBoundary(const MultiPolygon& multi_polygon, size_t max_cells_by_side = 128) {
+        std::vector<Edge> edges;
+        for (const auto& polygon : multi_polygon) {
+            add_ring_edges(polygon.outer(), edges);
+            for (const auto& inner : polygon.inners()) {
+                add_ring_edges(inner, edges);
+            }
+        }
+        if (edges.empty()) {
+            return;
+        }
+        min_x = max_x = edges.front().x1;
+        min_y = max_y = edges.front().y1;
+        for (const auto& edge : edges) {
+            min_x = std::min(min_x, edge.x1);
+            max_x = std::max(max_x, edge.x1);
+            min_y = std::min(min_y, edge.y1);
+            max_y = std::max(max_y, edge.y1);
+        }
+        // about one cell by edge
+        nb_cols = nb_rows = std::max<size_t>(
+            1, std::min(max_cells_by_side, static_cast<size_t>(std::ceil(std::sqrt(double(edges.size()))))));
+        cell_width = (max_x - min_x) / nb_cols;
+        cell_height = (max_y - min_y) / nb_rows;
+
+        row_edges.resize(nb_rows);
+        cells.assign(nb_rows * nb_cols, Location::outside);
+        for (const auto& edge : edges) {
+            const size_t first_row = row_of(std::min(edge.y1, edge.y2));
+            const size_t last_row = row_of(std::max(edge.y1, edge.y2));
+            for (size_t row = first_row; row <= last_row; ++row) {
+                row_edges[row].push_back(edge);
+                // the part of the edge in the row
+                double row_min_x = std::min(edge.x1, edge.x2), row_max_x = std::max(edge.x1, edge.x2);
+                if (edge.y1 != edge.y2) {
+                    const double x_a = edge.x_at(std::max(min_y + row * cell_height, std::min(edge.y1, edge.y2)));
+                    const double x_b =
+                        edge.x_at(std::min(min_y + (row + 1) * cell_height, std::max(edge.y1, edge.y2)));
+                    row_min_x = std::min(x_a, x_b);
+                    row_max_x = std::max(x_a, x_b);
+                }
+                // one more cell on each side, for the rounding errors
+                const size_t first_col = std::max<size_t>(col_of(row_min_x), 1) - 1;
+                const size_t last_col = std::min(col_of(row_max_x) + 1, nb_cols - 1);
+                for (size_t col = first_col; col <= last_col; ++col) {
+                    cells[row * nb_cols + col] = Location::boundary;
+                }
+            }
+        }
+        // the cells that aren't crossed are located by their center
+        std::vector<double> crossings;
+        for (size_t row = 0; row < nb_rows; ++row) {
+            const double y = min_y + (row + 0.5) * cell_height;
+            crossings.clear();
+            for (const auto& edge : row_edges[row]) {
+                if (edge.crosses(y)) {
+                    crossings.push_back(edge.x_at(y));
+                }
+            }
+            std::sort(crossings.begin(), crossings.end());
+            size_t nb_crossings_before = 0;
+            for (size_t col = 0; col < nb_cols; ++col) {
+                const double x = min_x + (col + 0.5) * cell_width;
+                while (nb_crossings_before < crossings.size() && crossings[nb_crossings_before] <= x) {
+                    ++nb_crossings_before;
+                }
+                auto& cell = cells[row * nb_cols + col];
+                if (cell != Location::boundary && (crossings.size() - nb_crossings_before) % 2 == 1) {
+                    cell = Location::inside;
+                }
+            }
+        }
+    }
+
+    // same result as boost::geometry::within: the points on the boundary aren't within
+    bool within(const Point& p) const { return locate(p) == Location::inside; }
+
+    // same result as boost::geometry::covered_by: the points on the boundary are covered
+    bool covered_by(const Point& p) const { return locate(p) != Location::outside; }
+
+private:
+    enum class Location : uint8_t { outside, inside, boundary };
+
+    struct Edge {
+        double x1, y1, x2, y2;
+
+        // half open on y so that a ray passing through a vertex crosses only one of its edges
+        bool crosses(double y) const { return (y1 > y) != (y2 > y); }
+        double x_at(double y) const { return x1 + (y - y1) * (x2 - x1) / (y2 - y1); }
+        bool contains(double x, double y) const {
+            if (x < std::min(x1, x2) || x > std::max(x1, x2) || y < std::min(y1, y2) || y > std::max(y1, y2)) {
+                return false;
+            }
+            return (x2 - x1) * (y - y1) - (y2 - y1) * (x - x1) == 0;
+        }
+    };
+
+    double min_x = 0, max_x = 0, min_y = 0, max_y = 0;
+    double cell_width = 0, cell_height = 0;
+    size_t nb_cols = 0, nb_rows = 0;
+    // row major
+    std::vector<Location> cells;
+    // the edges intersecting each row
+    std::vector<std::vector<Edge>> row_edges;
+
+    template <typename Ring>
+    static void add_ring_edges(const Ring& ring, std::vector<Edge>& edges) {
+        if (ring.size() < 2) {
+            return;
+        }
+        auto add_edge = [&](const Point& a, const Point& b) {
+            edges.push_back({boost::geometry::get<0>(a), boost::geometry::get<1>(a), boost::geometry::get<0>(b),
+                             boost::geometry::get<1>(b)});
+        };
+        for (size_t i = 1; i < ring.size(); ++i) {
+            add_edge(ring[i - 1], ring[i]);
+        }
+        // the rings may be open
+        if (!boost::geometry::equals(ring.back(), ring.front())) {
+            add_edge(ring.back(), ring.front());
+        }
+    }
+
+    static size_t index_of(double v, double min, double cell_size, size_t nb_cells) {
+        if (cell_size <= 0 || v <= min) {
+            return 0;
+        }
+        return std::min(nb_cells - 1, static_cast<size_t>((v - min) / cell_size));
+    }
+    size_t row_of(double y) const { return index_of(y, min_y, cell_height, nb_rows); }
+    size_t col_of(double x) const { return index_of(x, min_x, cell_width, nb_cols); }
+
+    Location locate(const Point& p) const {
+        const double x = boost::geometry::get<0>(p);
+        const double y = boost::geometry::get<1>(p);
+        if (cells.empty() || x < min_x || x > max_x || y < min_y || y > max_y) {
+            return Location::outside;
+        }
+        const size_t row = row_of(y);
+        const auto cell = cells[row * nb_cols + col_of(x)];
+        if (cell != Location::boundary) {
+            return cell;
+        }
+        bool inside = false;
+        for (const auto& edge : row_edges[row]) {
+            if (edge.contains(x, y)) {
+                return Location::boundary;
+            }
+            if (edge.crosses(y) && x < edge.x_at(y)) {
+                inside = !inside;
+            }
+        }
+        return inside ? Location::inside : Location::outside;
+    }
+};
+
+}  // namespace georef
+}  // namespace navitia
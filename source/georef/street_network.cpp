@@ -30,6 +30,7 @@ www.navitia.io
 
 #include "street_network.h"
 
+#include "fallback_cache.h"
 #include "georef.h"
 #include "type/data.h"
 
@@ -63,7 +64,29 @@ routing::map_stop_point_duration StreetNetwork::find_nearest_stop_points(
     bool use_second) {
     // delegate to the arrival or departure pathfinder
     // results are store to build the routing path after the transportation routing computation
-    return (use_second ? arrival_path_finder : departure_path_finder).find_nearest_stop_points(radius, pl);
+    auto& path_finder = use_second ? arrival_path_finder : departure_path_finder;
+    if (!geo_ref.fallback_cache || !path_finder.starting_edge.found || radius == navitia::seconds(0)) {
+        return path_finder.find_nearest_stop_points(radius, pl);
+    }
+
+    const FallbackCache::Key key(path_finder.starting_edge, path_finder.start_coord, path_finder.mode,
+                                 path_finder.speed_factor, radius);
+    if (const auto cached = geo_ref.fallback_cache->get(key)) {
+        ++nb_fallback_cache_hits;
+        path_finder.paths_on_demand = true;
+        return *cached;
+    }
+    ++nb_fallback_cache_misses;
+    auto result = path_finder.find_nearest_stop_points(radius, pl);
+    geo_ref.fallback_cache->add(key, result);
+    return result;
+}
+
+FallbackCacheStats StreetNetwork::pop_fallback_cache_stats() {
+    FallbackCacheStats res;
+    res.nb_hits = nb_fallback_cache_hits.exchange(0);
+    res.nb_misses = nb_fallback_cache_misses.exchange(0);
+    return res;
 }
 
 navitia::time_duration StreetNetwork::get_distance(type::idx_t target_idx, bool use_second) {
@@ -72,6 +95,10 @@ navitia::time_duration StreetNetwork::get_distance(type::idx_t target_idx, bool
 
 Path StreetNetwork::get_path(type::idx_t idx, bool use_second) {
     Path result;
+    auto& path_finder = use_second ? arrival_path_finder : departure_path_finder;
+    if (path_finder.paths_on_demand) {
+        path_finder.get_distance(idx);
+    }
     if (!use_second) {
         result = departure_path_finder.get_path(idx);
 
@@ -32,10 +32,13 @@ www.navitia.io
 #include "georef.h"
 #include "dijkstra_path_finder.h"
 #include "astar_path_finder.h"
+#include "fallback_cache.h"
 #include "routing/raptor_utils.h"
 #include "type/entry_point.h"
 #include "type/time_duration.h"
 
+#include <atomic>
+
 namespace navitia {
 namespace georef {
 
@@ -61,10 +64,20 @@ struct StreetNetwork {
      **/
     Path get_direct_path(const type::EntryPoint& origin, const type::EntryPoint& destination);
 
+    /**
+     * The hits and misses of the fallback cache since the previous call
+     **/
+    FallbackCacheStats pop_fallback_cache_stats();
+
     const GeoRef& geo_ref;
     DijkstraPathFinder departure_path_finder;
     DijkstraPathFinder arrival_path_finder;
     AstarPathFinder direct_path_finder;
+
+private:
+    // the departure and the arrival fallbacks can be computed concurrently
+    std::atomic<size_t> nb_fallback_cache_hits{0};
+    std::atomic<size_t> nb_fallback_cache_misses{0};
 };
 
 }  // namespace georef
@@ -1452,6 +1452,50 @@ BOOST_AUTO_TEST_CASE(list_postal_codes) {
     BOOST_CHECK_EQUAL(admin->postal_codes_to_string(), "44000;44100;44200;44300");
 }
 
+// the prepared boundary must give the same results as boost::geometry, on the edges and the vertices too
+BOOST_AUTO_TEST_CASE(prepared_boundary_same_as_boost) {
+    using navitia::type::GeographicalCoord;
+    multi_polygon_type boundary;
+    boost::geometry::read_wkt(
+        "MULTIPOLYGON(((0 0,0 10,4 12,10 10,10 0,5 1,0 0),(2 2,4 2,4 4,2 4,2 2)),((20 0,20 2,22 2,22 0,20 0)))",
+        boundary);
+    const PreparedBoundary<multi_polygon_type> prepared(boundary, 4);
+
+    std::vector<GeographicalCoord> coords = {{3, 3}, {1, 1}, {5, 1}, {5, 0.5}, {0, 5}, {2, 3}, {4, 12},
+                                             {7, 11}, {21, 1}, {20, 1}, {15, 1}, {-1, 5}, {5, 11.5}};
+    for (double lon = -1; lon <= 23; lon += 0.25) {
+        for (double lat = -1; lat <= 13; lat += 0.25) {
+            coords.emplace_back(lon, lat);
+        }
+    }
+    for (const auto& coord : coords) {
+        BOOST_CHECK_MESSAGE(prepared.within(coord) == boost::geometry::within(coord, boundary),
+                            "within " << coord);
+        BOOST_CHECK_MESSAGE(prepared.covered_by(coord) == boost::geometry::covered_by(coord, boundary),
+                            "covered_by " << coord);
+    }
+
+    const PreparedBoundary<multi_polygon_type> empty{multi_polygon_type()};
+    BOOST_CHECK(!empty.covered_by({0, 0}));
+}
+
+BOOST_AUTO_TEST_CASE(search_admins_in_tree) {
+    Admin big, small, no_boundary;
+    boost::geometry::read_wkt("MULTIPOLYGON(((0 0,0 10,10 10,10 0,0 0)))", big.boundary);
+    boost::geometry::read_wkt("MULTIPOLYGON(((2 2,2 4,4 4,4 2,2 2)))", small.boundary);
+    auto admins_tree = build_admins_tree({&big, &small, &no_boundary});
+
+    auto admins = search_admins({3, 3}, admins_tree);
+    std::sort(admins.begin(), admins.end());
+    auto expected = std::vector<Admin*>{&big, &small};
+    std::sort(expected.begin(), expected.end());
+    BOOST_CHECK(admins == expected);
+    BOOST_CHECK(search_admins({5, 5}, admins_tree) == std::vector<Admin*>{&big});
+    // on the boundary of small, in the envelope of both
+    BOOST_CHECK(search_admins({2, 3}, admins_tree) == std::vector<Admin*>{&big});
+    BOOST_CHECK(search_admins({11, 5}, admins_tree).empty());
+}
+
 BOOST_AUTO_TEST_CASE(find_nearest_on_same_edge) {
     using namespace navitia::type;
 
@@ -36,6 +36,7 @@ www.navitia.io
 #include "type/pt_data.h"
 #include "type/stop_point.h"
 
+#include "georef/fallback_cache.h"
 #include "georef/street_network.h"
 #include <boost/test/unit_test.hpp>
 
@@ -233,3 +234,143 @@ BOOST_AUTO_TEST_CASE(astar_init) {
         BOOST_CHECK_THROW(worker.costs.at(worker.starting_edge[dir::Target]), proximitylist::NotFound);
     }
 }
+
+/*
+ * A path finder only resets the vertices reached by its previous search,
+ * it has to give the same results as a path finder that has never been used
+ */
+BOOST_AUTO_TEST_CASE(path_finder_reuse) {
+    GraphBuilder b;
+    type::Data data;
+    build_data(b, data);
+    auto const target_idx = data.pt_data->stop_points.front()->idx;
+    const auto speed = georef::default_speed[type::Mode_e::Walking];
+
+    type::GeographicalCoord first_start;
+    first_start.set_xy(2., 2.);
+    type::GeographicalCoord second_start;
+    second_start.set_xy(6., 3.);
+    type::GeographicalCoord destination;
+    destination.set_xy(8., 8.);
+
+    {
+        DijkstraPathFinder reused(b.geo_ref);
+        reused.init(first_start, type::Mode_e::Walking, speed);
+        BOOST_REQUIRE_NE(reused.get_distance(target_idx), bt::pos_infin);
+        BOOST_REQUIRE(!reused.touched_vertices.empty());
+
+        reused.init(second_start, type::Mode_e::Walking, speed);
+        auto const distance = reused.get_distance(target_idx);
+
+        DijkstraPathFinder fresh(b.geo_ref);
+        fresh.init(second_start, type::Mode_e::Walking, speed);
+        BOOST_CHECK_EQUAL(fresh.get_distance(target_idx), distance);
+        BOOST_CHECK_EQUAL_COLLECTIONS(reused.distances.begin(), reused.distances.end(), fresh.distances.begin(),
+                                      fresh.distances.end());
+    }
+    {
+        AstarPathFinder reused(b.geo_ref);
+        reused.init(first_start, destination, type::Mode_e::Walking, speed);
+        reused.start_distance_or_target_astar(navitia::seconds(1000), destination, {});
+
+        reused.init(second_start, destination, type::Mode_e::Walking, speed);
+        reused.start_distance_or_target_astar(navitia::seconds(1000), destination, {});
+
+        AstarPathFinder fresh(b.geo_ref);
+        fresh.init(second_start, destination, type::Mode_e::Walking, speed);
+        fresh.start_distance_or_target_astar(navitia::seconds(1000), destination, {});
+        BOOST_CHECK_EQUAL_COLLECTIONS(reused.distances.begin(), reused.distances.end(), fresh.distances.begin(),
+                                      fresh.distances.end());
+        BOOST_CHECK_EQUAL_COLLECTIONS(reused.costs.begin(), reused.costs.end(), fresh.costs.begin(),
+                                      fresh.costs.end());
+    }
+}
+
+/*
+ * The second search from the same place is answered by the fallback cache,
+ * the paths to the stop points are then computed on demand
+ */
+BOOST_AUTO_TEST_CASE(fallback_cache) {
+    GraphBuilder b;
+    type::Data data;
+    build_data(b, data);
+    data.pt_data->build_proximity_list();
+    b.geo_ref.init_fallback_cache(1);
+    const auto& pl = data.pt_data->stop_point_proximity_list;
+    const auto sp_idx = data.pt_data->stop_points.front()->idx;
+
+    type::EntryPoint start(type::Type_e::Coord, "");
+    start.coordinates.set_xy(2., 2.);
+    const auto max_duration = navitia::seconds(36000);
+
+    StreetNetwork first_sn(b.geo_ref);
+    first_sn.init(start);
+    const auto first_res = first_sn.find_nearest_stop_points(max_duration, pl, false);
+    BOOST_REQUIRE_EQUAL(first_res.size(), 1);
+    BOOST_CHECK(!first_sn.departure_path_finder.paths_on_demand);
+    const auto first_path = first_sn.get_path(sp_idx);
+    BOOST_REQUIRE(!first_path.path_items.empty());
+
+    StreetNetwork second_sn(b.geo_ref);
+    second_sn.init(start);
+    const auto second_res = second_sn.find_nearest_stop_points(max_duration, pl, false);
+    BOOST_CHECK(second_sn.departure_path_finder.paths_on_demand);
+    BOOST_CHECK(first_res == second_res);
+    const auto second_path = second_sn.get_path(sp_idx);
+    BOOST_CHECK_EQUAL(second_path.path_items.size(), first_path.path_items.size());
+    BOOST_CHECK_EQUAL(second_path.duration, first_path.duration);
+
+    BOOST_CHECK_EQUAL(b.geo_ref.fallback_cache->get_nb_calls(), 2);
+    BOOST_CHECK_EQUAL(b.geo_ref.fallback_cache->get_nb_hits(), 1);
+    auto stats = first_sn.pop_fallback_cache_stats();
+    BOOST_CHECK_EQUAL(stats.nb_hits, 0);
+    BOOST_CHECK_EQUAL(stats.nb_misses, 1);
+    stats = second_sn.pop_fallback_cache_stats();
+    BOOST_CHECK_EQUAL(stats.nb_hits, 1);
+    BOOST_CHECK_EQUAL(stats.nb_misses, 0);
+    // the stats are reset once read
+    stats = second_sn.pop_fallback_cache_stats();
+    BOOST_CHECK_EQUAL(stats.nb_hits, 0);
+    BOOST_CHECK_EQUAL(stats.nb_misses, 0);
+
+    // another max duration is another entry, the least recently used one is discarded
+    second_sn.init(start);
+    second_sn.find_nearest_stop_points(max_duration + navitia::seconds(1), pl, false);
+    BOOST_CHECK(!second_sn.departure_path_finder.paths_on_demand);
+    BOOST_CHECK_EQUAL(b.geo_ref.fallback_cache->size(), 1);
+    second_sn.init(start);
+    second_sn.find_nearest_stop_points(max_duration, pl, false);
+    BOOST_CHECK(!second_sn.departure_path_finder.paths_on_demand);
+    BOOST_CHECK_EQUAL(b.geo_ref.fallback_cache->get_nb_hits(), 1);
+    stats = second_sn.pop_fallback_cache_stats();
+    BOOST_CHECK_EQUAL(stats.nb_hits, 0);
+    BOOST_CHECK_EQUAL(stats.nb_misses, 2);
+}
+
+/*
+ * The stop points are searched in crow fly around the starting coordinate,
+ * two places projected on the same point of the street network can't share their fallbacks
+ */
+BOOST_AUTO_TEST_CASE(fallback_cache_key_depends_on_start_coord) {
+    GraphBuilder b;
+    type::Data data;
+    const auto proj = build_data(b, data);
+    FallbackCache cache(10);
+
+    type::GeographicalCoord start;
+    start.set_xy(8., 8.);
+    type::GeographicalCoord other_start;
+    other_start.set_xy(8., 8.1);
+    const auto max_duration = navitia::seconds(1000);
+    const FallbackCache::Key key(proj, start, type::Mode_e::Walking, 1, max_duration);
+    const FallbackCache::Key same_key(proj, start, type::Mode_e::Walking, 1, max_duration);
+    const FallbackCache::Key other_key(proj, other_start, type::Mode_e::Walking, 1, max_duration);
+
+    routing::map_stop_point_duration stop_points;
+    stop_points[routing::SpIdx(0)] = navitia::seconds(10);
+    cache.add(key, stop_points);
+    BOOST_CHECK(cache.get(same_key) != nullptr);
+    BOOST_CHECK(cache.get(other_key) == nullptr);
+    BOOST_CHECK_EQUAL(cache.get_nb_calls(), 2);
+    BOOST_CHECK_EQUAL(cache.get_nb_hits(), 1);
+}
@@ -0,0 +1,117 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "api_class.h"
+
+#include "type/request.pb.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
+namespace navitia {
+namespace kraken {
+
+ApiClass get_api_class(pbnavitia::API api) {
+    switch (api) {
+        case pbnavitia::STATUS:
+        case pbnavitia::METADATAS:
+        case pbnavitia::places:
+        case pbnavitia::pt_objects:
+        case pbnavitia::place_uri:
+        case pbnavitia::place_code:
+        case pbnavitia::PTREFERENTIAL:
+        case pbnavitia::calendars:
+        case pbnavitia::geo_status:
+        case pbnavitia::car_co2_emission:
+        case pbnavitia::odt_stop_points:
+        case pbnavitia::matching_routes:
+            return ApiClass::Light;
+        case pbnavitia::NMPLANNER:
+        case pbnavitia::pt_planner:
+        case pbnavitia::PLANNER:
+        case pbnavitia::ISOCHRONE:
+        case pbnavitia::graphical_isochrone:
+        case pbnavitia::heat_map:
+        case pbnavitia::street_network_routing_matrix:
+            return ApiClass::Heavy;
+        default:
+            return ApiClass::Standard;
+    }
+}
+
+std::string get_api_class_name(ApiClass api_class) {
+    switch (api_class) {
+        case ApiClass::Light:
+            return "light";
+        case ApiClass::Standard:
+            return "standard";
+        case ApiClass::Heavy:
+            return "heavy";
+        default:
+            return "unknown";
+    }
+}
+
+RequestHeader read_request_header(const std::string& message) {
+    using google::protobuf::internal::WireFormatLite;
+    RequestHeader header;
+    google::protobuf::io::CodedInputStream input(reinterpret_cast<const uint8_t*>(message.data()),
+                                                 static_cast<int>(message.size()));
+    while (const uint32_t tag = input.ReadTag()) {
+        const int field = WireFormatLite::GetTagFieldNumber(tag);
+        const auto wire_type = WireFormatLite::GetTagWireType(tag);
+        if (field == pbnavitia::Request::kRequestedApiFieldNumber && wire_type == WireFormatLite::WIRETYPE_VARINT) {
+            uint32_t api = 0;
+            if (!input.ReadVarint32(&api)) {
+                return {};
+            }
+            if (pbnavitia::API_IsValid(static_cast<int>(api))) {
+                header.api = static_cast<pbnavitia::API>(api);
+            }
+        } else if (field == pbnavitia::Request::kDeadlineFieldNumber
+                   && wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+            std::string deadline;
+            if (!WireFormatLite::ReadString(&input, &deadline)) {
+                return {};
+            }
+            header.deadline = std::move(deadline);
+        } else if (!WireFormatLite::SkipField(&input, tag)) {
+            return {};
+        }
+    }
+    // ReadTag also returns 0 on a truncated message
+    if (!input.ConsumedEntireMessage()) {
+        return {};
+    }
+    return header;
+}
+
+}  // namespace kraken
+}  // namespace navitia
@@ -0,0 +1,67 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+#include "type/type.pb.h"
+
+#include <boost/optional.hpp>
+
+#include <string>
+
+namespace navitia {
+namespace kraken {
+
+/*
+ * Requests are grouped by their expected cost, each group having its own queue
+ * so that a burst of expensive requests (journeys, isochrones, heat maps...)
+ * cannot starve the cheap ones (metadatas, places, ptref...)
+ */
+enum class ApiClass { Light = 0, Standard, Heavy, size };
+
+constexpr size_t NB_API_CLASSES = static_cast<size_t>(ApiClass::size);
+
+ApiClass get_api_class(pbnavitia::API api);
+std::string get_api_class_name(ApiClass api_class);
+
+/*
+ * What the load balancer needs to know about a request to queue it
+ *
+ * Only the top level fields of the protobuf are read, the sub messages (journeys, places...)
+ * are skipped without being parsed. An invalid message gives an empty header, the worker will report it.
+ */
+struct RequestHeader {
+    boost::optional<pbnavitia::API> api;
+    boost::optional<std::string> deadline;
+};
+
+RequestHeader read_request_header(const std::string& message);
+
+}  // namespace kraken
+}  // namespace navitia
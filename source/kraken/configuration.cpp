@@ -78,10 +78,28 @@ po::options_description get_options_description(const boost::optional<std::strin
              po::value<bool>()->default_value(*display_contributors) : po::value<bool>()->default_value(false),
          "display all contributors in feed publishers")
         ("GENERAL.raptor_cache_size", po::value<int>()->default_value(10), "maximum number of stored raptor caches")
+        ("GENERAL.raptor_second_pass_threads", po::value<int>()->default_value(1),
+                                  "number of threads used by each worker for the second pass of raptor")
+        ("GENERAL.raptor_matrix_threads", po::value<int>()->default_value(1),
+                                  "number of threads used by each worker for the rows of a public transport matrix")
+        ("GENERAL.heat_map_threads", po::value<int>()->default_value(1),
+                                  "number of threads used by each worker for the grid of a heat map")
+        ("GENERAL.raptor_target_pruning", po::value<bool>()->default_value(false),
+                                  "prune the first pass of raptor with lower bounds of the duration to the destinations")
+        ("GENERAL.fallback_cache_size", po::value<int>()->default_value(1000),
+                                  "maximum number of street network fallbacks kept in cache, 0 to disable it")
         ("GENERAL.log_level", po::value<std::string>(), "log level of kraken")
         ("GENERAL.log_format", po::value<std::string>()->default_value("[%D{%y-%m-%d %H:%M:%S,%q}] [%p] [%x] - %m %b:%L  %n"), "log format")
 
         ("GENERAL.enable_request_deadline", po::value<bool>()->default_value(true), "enable deadline of request")
+        ("GENERAL.light_requests_weight", po::value<int>()->default_value(4),
+                                  "share of workers given to light requests (places, ptref, metadatas...) when requests are queued")
+        ("GENERAL.standard_requests_weight", po::value<int>()->default_value(2),
+                                  "share of workers given to standard requests (departures, schedules, reports...) when requests are queued")
+        ("GENERAL.heavy_requests_weight", po::value<int>()->default_value(1),
+                                  "share of workers given to heavy requests (journeys, isochrones, heat maps...) when requests are queued")
+        ("GENERAL.max_queued_requests", po::value<int>()->default_value(0),
+                                  "maximum number of requests waiting for a worker, 0 for no limit")
         ("GENERAL.metrics_binding", po::value<std::string>(), "IP:PORT to serving metrics in http")
         ("GENERAL.core_file_size_limit", po::value<int>()->default_value(0), "ulimit that define the maximum size of a core file")
 
@@ -253,6 +271,38 @@ bool Configuration::enable_request_deadline() const {
     return vm["GENERAL.enable_request_deadline"].as<bool>();
 }
 
+int Configuration::light_requests_weight() const {
+    int weight = vm["GENERAL.light_requests_weight"].as<int>();
+    if (weight < 1) {
+        throw std::invalid_argument("light_requests_weight must be strictly positive");
+    }
+    return weight;
+}
+
+int Configuration::standard_requests_weight() const {
+    int weight = vm["GENERAL.standard_requests_weight"].as<int>();
+    if (weight < 1) {
+        throw std::invalid_argument("standard_requests_weight must be strictly positive");
+    }
+    return weight;
+}
+
+int Configuration::heavy_requests_weight() const {
+    int weight = vm["GENERAL.heavy_requests_weight"].as<int>();
+    if (weight < 1) {
+        throw std::invalid_argument("heavy_requests_weight must be strictly positive");
+    }
+    return weight;
+}
+
+size_t Configuration::max_queued_requests() const {
+    int max_queued_requests = vm["GENERAL.max_queued_requests"].as<int>();
+    if (max_queued_requests < 0) {
+        throw std::invalid_argument("max_queued_requests cannot be negative");
+    }
+    return size_t(max_queued_requests);
+}
+
 size_t Configuration::raptor_cache_size() const {
     if (!vm.count("GENERAL.raptor_cache_size")) {
         return 10;
@@ -264,6 +314,42 @@ size_t Configuration::raptor_cache_size() const {
     return size_t(raptor_cache_size);
 }
 
+size_t Configuration::raptor_second_pass_threads() const {
+    int raptor_second_pass_threads = vm["GENERAL.raptor_second_pass_threads"].as<int>();
+    if (raptor_second_pass_threads < 1) {
+        throw std::invalid_argument("raptor_second_pass_threads must be strictly positive");
+    }
+    return size_t(raptor_second_pass_threads);
+}
+
+size_t Configuration::raptor_matrix_threads() const {
+    int raptor_matrix_threads = vm["GENERAL.raptor_matrix_threads"].as<int>();
+    if (raptor_matrix_threads < 1) {
+        throw std::invalid_argument("raptor_matrix_threads must be strictly positive");
+    }
+    return size_t(raptor_matrix_threads);
+}
+
+size_t Configuration::heat_map_threads() const {
+    int heat_map_threads = vm["GENERAL.heat_map_threads"].as<int>();
+    if (heat_map_threads < 1) {
+        throw std::invalid_argument("heat_map_threads must be strictly positive");
+    }
+    return size_t(heat_map_threads);
+}
+
+bool Configuration::raptor_target_pruning() const {
+    return vm["GENERAL.raptor_target_pruning"].as<bool>();
+}
+
+size_t Configuration::fallback_cache_size() const {
+    int fallback_cache_size = vm["GENERAL.fallback_cache_size"].as<int>();
+    if (fallback_cache_size < 0) {
+        throw std::invalid_argument("fallback_cache_size cannot be negative");
+    }
+    return size_t(fallback_cache_size);
+}
+
 boost::optional<std::string> Configuration::log_level() const {
     boost::optional<std::string> result;
     if (this->vm.count("GENERAL.log_level") > 0) {
@@ -67,12 +67,21 @@ public:
     int kirin_retry_timeout() const;
     bool display_contributors() const;
     size_t raptor_cache_size() const;
+    size_t raptor_second_pass_threads() const;
+    size_t raptor_matrix_threads() const;
+    size_t heat_map_threads() const;
+    bool raptor_target_pruning() const;
+    size_t fallback_cache_size() const;
     int core_file_size_limit() const;
     int slow_request_duration() const;
     boost::optional<std::string> log_level() const;
     boost::optional<std::string> log_format() const;
     boost::optional<std::string> metrics_binding() const;
     bool enable_request_deadline() const;
+    int light_requests_weight() const;
+    int standard_requests_weight() const;
+    int heavy_requests_weight() const;
+    size_t max_queued_requests() const;
 
     std::vector<std::string> rt_topics() const;
 };
@@ -68,7 +68,8 @@ private:
     }
     bool load_data_nav(boost::shared_ptr<Data>& data, const std::string& filename) {
         try {
-            data->load_nav(filename);
+            // the current data shares its georef if it didn't change
+            data->load_nav(filename, current_data.get());
             return true;
         } catch (const navitia::data::data_loading_error&) {
             data->loading = false;
@@ -98,7 +99,8 @@ public:
     bool load(const std::string& filename,
               const boost::optional<std::string>& chaos_database = boost::none,
               const std::vector<std::string>& contributors = {},
-              const size_t raptor_cache_size = 10) {
+              const size_t raptor_cache_size = 10,
+              const size_t fallback_cache_size = 0) {
         // Add logger
         log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
 
@@ -141,6 +143,7 @@ public:
         data->build_relations();
         // Build proximity list NN index
         data->build_proximity_list();
+        data->build_fallback_cache(fallback_cache_size);
         data->loading = false;
 
         // Set data
@@ -28,6 +28,7 @@ https://groups.google.com/d/forum/navitia
 www.navitia.io
 */
 #include "kraken_zmq.h"
+#include "load_balancer.h"
 
 #include "conf.h"
 #include "type/type.pb.h"
@@ -40,6 +41,7 @@ www.navitia.io
 
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <sys/resource.h>  // Posix dependencies for getrlimit
 
@@ -121,16 +123,21 @@ int main(int argn, char** argv) {
     zmq::context_t context(1);
     // Catch startup exceptions; without this, startup errors are on stdout
     std::string zmq_socket = conf.zmq_socket_path();
-    // TODO: try/catch
-    LoadBalancer lb(context);
-
     const navitia::Metrics metrics(conf.metrics_binding(), conf.instance_name());
 
+    std::unique_ptr<navitia::kraken::PriorityLoadBalancer> lb;
+    try {
+        lb = std::make_unique<navitia::kraken::PriorityLoadBalancer>(context, conf, metrics);
+    } catch (const std::invalid_argument& e) {
+        LOG4CPLUS_ERROR(logger, "invalid load balancer configuration: " << e.what());
+        return 1;
+    }
+
     threads.create_thread(navitia::MaintenanceWorker(data_manager, conf, metrics));
     //
     // Data have been loaded, we can now accept connections
     try {
-        lb.bind(zmq_socket, "inproc://workers");
+        lb->bind(zmq_socket, "inproc://workers");
     } catch (zmq::error_t& e) {
         LOG4CPLUS_ERROR(logger, "zmq::socket_t::bind( " << zmq_socket << " ) failure: " << e.what());
         threads.interrupt_all();
@@ -148,7 +155,7 @@ int main(int argn, char** argv) {
     // Connect worker threads to client threads via a queue
     do {
         try {
-            lb.run();
+            lb->run();
         } catch (const navitia::recoverable_exception& e) {
             LOG4CPLUS_ERROR(logger, e.what());
         } catch (const zmq::error_t&) {
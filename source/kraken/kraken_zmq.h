@@ -146,6 +146,8 @@ inline void doWork(zmq::context_t& context,
         respond(socket, address, w.pb_creator.get_response());
         auto duration = pt::microsec_clock::universal_time() - start;
         metrics.observe_api(api, duration.total_milliseconds() / 1000.0);
+        const auto fallback_cache_stats = w.pop_fallback_cache_stats();
+        metrics.observe_fallback_cache(fallback_cache_stats.nb_hits, fallback_cache_stats.nb_misses);
         if (duration >= slow_request_duration) {
             LOG4CPLUS_WARN(logger, "slow request! duration: " << duration.total_milliseconds()
                                                               << "ms request: " << pb_req.DebugString());
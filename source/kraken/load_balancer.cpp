@@ -0,0 +1,181 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "load_balancer.h"
+
+namespace pt = boost::posix_time;
+
+namespace navitia {
+namespace kraken {
+
+// the queued requests whose deadline expired are answered at least this often, even without any other event
+static const auto SWEEP_PERIOD = pt::milliseconds(100);
+
+PriorityLoadBalancer::PriorityLoadBalancer(zmq::context_t& context, const Configuration& conf, const Metrics& metrics)
+    : clients(context, ZMQ_ROUTER),
+      workers(context, ZMQ_ROUTER),
+      scheduler({{conf.light_requests_weight(), conf.standard_requests_weight(), conf.heavy_requests_weight()}},
+                conf.max_queued_requests()),
+      metrics(metrics),
+      enable_deadline(conf.enable_request_deadline()),
+      last_sweep(pt::microsec_clock::universal_time()) {}
+
+void PriorityLoadBalancer::bind(const std::string& clients_socket_path, const std::string& workers_socket_path) {
+    clients.bind(clients_socket_path.c_str());
+    workers.bind(workers_socket_path.c_str());
+}
+
+void PriorityLoadBalancer::run() {
+    // we always listen to the clients, even without available worker: the waiting requests are kept in the scheduler
+    zmq::pollitem_t items[] = {{static_cast<void*>(workers), 0, ZMQ_POLLIN, 0},
+                               {static_cast<void*>(clients), 0, ZMQ_POLLIN, 0}};
+    while (true) {
+        zmq::poll(items, 2, SWEEP_PERIOD.total_milliseconds());
+        if (items[0].revents & ZMQ_POLLIN) {
+            receive_from_worker();
+        }
+        if (items[1].revents & ZMQ_POLLIN) {
+            receive_from_client();
+        }
+        dispatch_to_workers();
+        sweep_expired();
+    }
+}
+
+void PriorityLoadBalancer::receive_from_worker() {
+    available_workers.push(z_recv(workers));
+    {
+        std::string empty = z_recv(workers);
+        assert(empty.size() == 0);
+    }
+    std::string client_address = z_recv(workers);
+    if (client_address == "READY") {
+        return;
+    }
+    {
+        std::string empty = z_recv(workers);
+        assert(empty.size() == 0);
+    }
+    zmq::message_t reply;
+    workers.recv(&reply);
+    z_send(clients, client_address, ZMQ_SNDMORE);
+    z_send(clients, "", ZMQ_SNDMORE);
+    clients.send(reply);
+}
+
+void PriorityLoadBalancer::receive_from_client() {
+    PendingRequest pending;
+    pending.client_address = z_recv(clients);
+    {
+        std::string empty = z_recv(clients);
+        assert(empty.size() == 0);
+    }
+    pending.message = z_recv(clients);
+    const auto now = pt::microsec_clock::universal_time();
+
+    // we only need the api and the deadline, an invalid protobuf is left to the worker that will report it
+    const auto header = read_request_header(pending.message);
+    const auto api_class = header.api ? get_api_class(*header.api) : ApiClass::Standard;
+    boost::optional<pt::ptime> deadline;
+    if (enable_deadline && header.deadline) {
+        try {
+            deadline = pt::from_iso_string(*header.deadline);
+        } catch (const std::exception&) {
+            // the worker will log it
+        }
+    }
+
+    const auto client_address = pending.client_address;
+    if (!scheduler.push(std::move(pending), api_class, deadline, now)) {
+        LOG4CPLUS_WARN(logger, "too many queued requests (" << scheduler.size() << "), rejecting a "
+                                                            << get_api_class_name(api_class) << " request");
+        reply_error(client_address, pbnavitia::Error::service_unavailable, "too many requests queued");
+    }
+}
+
+void PriorityLoadBalancer::dispatch_to_workers() {
+    std::vector<Scheduler::Item> expired;
+    while (!available_workers.empty()) {
+        const auto now = pt::microsec_clock::universal_time();
+        auto item = scheduler.pop(now, expired);
+        if (!item) {
+            break;
+        }
+        metrics.observe_queue_wait(item->api_class, (now - item->enqueued_at).total_microseconds() / 1000000.0);
+
+        const std::string worker_address = available_workers.front();
+        available_workers.pop();
+        z_send(workers, worker_address, ZMQ_SNDMORE);
+        z_send(workers, "", ZMQ_SNDMORE);
+        z_send(workers, item->request.client_address, ZMQ_SNDMORE);
+        z_send(workers, "", ZMQ_SNDMORE);
+        z_send(workers, item->request.message);
+    }
+    reply_expired(expired);
+}
+
+void PriorityLoadBalancer::sweep_expired() {
+    const auto now = pt::microsec_clock::universal_time();
+    if (now - last_sweep < SWEEP_PERIOD) {
+        return;
+    }
+    last_sweep = now;
+    std::vector<Scheduler::Item> expired;
+    scheduler.sweep_expired(now, expired);
+    reply_expired(expired);
+}
+
+void PriorityLoadBalancer::reply_expired(const std::vector<Scheduler::Item>& expired) {
+    for (const auto& item : expired) {
+        LOG4CPLUS_WARN(logger, "deadline expired while queued, dropping a " << get_api_class_name(item.api_class)
+                                                                            << " request");
+        metrics.inc_expired_in_queue(item.api_class);
+        reply_error(item.request.client_address, pbnavitia::Error::deadline_expired,
+                    "deadline expired while waiting for a worker");
+    }
+}
+
+void PriorityLoadBalancer::reply_error(const std::string& client_address,
+                                       pbnavitia::Error_error_id error_id,
+                                       const std::string& message) {
+    pbnavitia::Response response;
+    auto* error = response.mutable_error();
+    error->set_id(error_id);
+    error->set_message(message);
+
+    zmq::message_t reply(response.ByteSize());
+    response.SerializeToArray(reply.data(), response.ByteSize());
+    z_send(clients, client_address, ZMQ_SNDMORE);
+    z_send(clients, "", ZMQ_SNDMORE);
+    clients.send(reply);
+}
+
+}  // namespace kraken
+}  // namespace navitia
@@ -0,0 +1,93 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+#include "kraken/configuration.h"
+#include "kraken/metrics.h"
+#include "kraken/request_scheduler.h"
+#include "type/response.pb.h"
+#include "utils/logger.h"
+#include "utils/zmq.h"
+
+#include <boost/utility.hpp>
+
+#include <cassert>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace navitia {
+namespace kraken {
+
+/*
+ * Forward the requests received on the clients socket to the workers
+ *
+ * Requests are not handed to the workers in FIFO order: they are queued by ApiClass
+ * in a RequestScheduler, and the requests whose deadline expired while waiting are
+ * answered directly without reaching a worker.
+ * Only the header of the requests is read here, they are parsed by the workers.
+ *
+ * The workers register by sending their address, then send back the client address,
+ * an empty frame and the response for each request (see doWork()).
+ */
+class PriorityLoadBalancer : boost::noncopyable {
+    struct PendingRequest {
+        std::string client_address;
+        std::string message;
+    };
+    using Scheduler = RequestScheduler<PendingRequest>;
+
+    zmq::socket_t clients;
+    zmq::socket_t workers;
+    std::queue<std::string> available_workers;
+    Scheduler scheduler;
+    const Metrics& metrics;
+    const bool enable_deadline;
+    log4cplus::Logger logger = log4cplus::Logger::getInstance("load_balancer");
+    boost::posix_time::ptime last_sweep;
+
+    void receive_from_worker();
+    void receive_from_client();
+    void dispatch_to_workers();
+    void sweep_expired();
+    void reply_expired(const std::vector<Scheduler::Item>& expired);
+    void reply_error(const std::string& client_address,
+                     pbnavitia::Error_error_id error_id,
+                     const std::string& message);
+
+public:
+    PriorityLoadBalancer(zmq::context_t& context, const Configuration& conf, const Metrics& metrics);
+
+    void bind(const std::string& clients_socket_path, const std::string& workers_socket_path);
+    void run();
+};
+
+}  // namespace kraken
+}  // namespace navitia
@@ -62,7 +62,8 @@ void MaintenanceWorker::load_data() {
     auto contributors = conf.rt_topics();
     LOG4CPLUS_INFO(logger, "Loading database from file: " + database);
     auto start = pt::microsec_clock::universal_time();
-    if (this->data_manager.load(database, chaos_database, contributors, conf.raptor_cache_size())) {
+    if (this->data_manager.load(database, chaos_database, contributors, conf.raptor_cache_size(),
+                                conf.fallback_cache_size())) {
         auto data = data_manager.get_data();
         data->is_realtime_loaded = false;
         data->meta->instance_name = conf.instance_name();
@@ -221,6 +222,7 @@ void MaintenanceWorker::handle_rt_in_batch(const std::vector<AmqpClient::Envelop
         LOG4CPLUS_INFO(logger, "rebuilding data raptor");
         data->build_raptor(conf.raptor_cache_size());
         data->build_proximity_list();
+        data->build_fallback_cache(conf.fallback_cache_size());
         data->warmup(*data_manager.get_data());
         data->set_last_rt_data_loaded(pt::microsec_clock::universal_time());
         data_manager.set_data(std::move(data));
@@ -128,6 +128,37 @@ Metrics::Metrics(const boost::optional<std::string>& endpoint, const std::string
                                      .Labels({{"coverage", coverage}})
                                      .Register(*registry)
                                      .Add({}, create_exponential_buckets(1, 2, 10));
+
+    auto& queue_wait_family = prometheus::BuildHistogram()
+                                  .Name("kraken_request_queue_wait_seconds")
+                                  .Help("time spent by a request waiting for a worker")
+                                  .Labels({{"coverage", coverage}})
+                                  .Register(*registry);
+    auto& expired_in_queue_family = prometheus::BuildCounter()
+                                        .Name("kraken_request_expired_in_queue_total")
+                                        .Help("Number of requests dropped because their deadline expired while queued")
+                                        .Labels({{"coverage", coverage}})
+                                        .Register(*registry);
+    for (size_t i = 0; i < kraken::NB_API_CLASSES; ++i) {
+        const auto api_class_name = kraken::get_api_class_name(static_cast<kraken::ApiClass>(i));
+        this->queue_wait_histogram[i] =
+            &queue_wait_family.Add({{"api_class", api_class_name}}, create_exponential_buckets(0.001, 2, 14));
+        this->expired_in_queue_counter[i] = &expired_in_queue_family.Add({{"api_class", api_class_name}});
+    }
+
+    this->fallback_cache_hits_counter = &prometheus::BuildCounter()
+                                             .Name("kraken_fallback_cache_hits_total")
+                                             .Help("Number of street network fallbacks found in the fallback cache")
+                                             .Labels({{"coverage", coverage}})
+                                             .Register(*registry)
+                                             .Add({});
+
+    this->fallback_cache_misses_counter = &prometheus::BuildCounter()
+                                               .Name("kraken_fallback_cache_misses_total")
+                                               .Help("Number of street network fallbacks computed by a dijkstra")
+                                               .Labels({{"coverage", coverage}})
+                                               .Register(*registry)
+                                               .Add({});
 }
 
 InFlightGuard Metrics::start_in_flight() const {
@@ -171,4 +202,26 @@ void Metrics::observe_handle_rt(double duration) const {
     this->handle_rt_histogram->Observe(duration);
 }
 
+void Metrics::observe_queue_wait(kraken::ApiClass api_class, double duration) const {
+    if (!registry) {
+        return;
+    }
+    this->queue_wait_histogram[static_cast<size_t>(api_class)]->Observe(duration);
+}
+
+void Metrics::inc_expired_in_queue(kraken::ApiClass api_class) const {
+    if (!registry) {
+        return;
+    }
+    this->expired_in_queue_counter[static_cast<size_t>(api_class)]->Increment();
+}
+
+void Metrics::observe_fallback_cache(size_t nb_hits, size_t nb_misses) const {
+    if (!registry) {
+        return;
+    }
+    this->fallback_cache_hits_counter->Increment(nb_hits);
+    this->fallback_cache_misses_counter->Increment(nb_misses);
+}
+
 }  // namespace navitia
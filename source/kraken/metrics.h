@@ -31,6 +31,7 @@ www.navitia.io
 #pragma once
 
 #include "type/type.pb.h"
+#include "kraken/api_class.h"
 
 #include <boost/optional.hpp>
 #include <boost/utility.hpp>
@@ -38,6 +39,7 @@ www.navitia.io
 #include <prometheus/counter.h>
 #include <prometheus/gauge.h>
 
+#include <array>
 #include <memory>
 #include <map>
 
@@ -71,6 +73,10 @@ protected:
     prometheus::Histogram* data_loading_histogram;
     prometheus::Histogram* data_cloning_histogram;
     prometheus::Histogram* handle_rt_histogram;
+    std::array<prometheus::Histogram*, kraken::NB_API_CLASSES> queue_wait_histogram;
+    std::array<prometheus::Counter*, kraken::NB_API_CLASSES> expired_in_queue_counter;
+    prometheus::Counter* fallback_cache_hits_counter;
+    prometheus::Counter* fallback_cache_misses_counter;
 
 public:
     Metrics(const boost::optional<std::string>& endpoint, const std::string& coverage);
@@ -80,6 +86,9 @@ public:
     void observe_data_loading(double duration) const;
     void observe_data_cloning(double duration) const;
     void observe_handle_rt(double duration) const;
+    void observe_queue_wait(kraken::ApiClass api_class, double duration) const;
+    void inc_expired_in_queue(kraken::ApiClass api_class) const;
+    void observe_fallback_cache(size_t nb_hits, size_t nb_misses) const;
 };
 
 }  // namespace navitia
@@ -0,0 +1,175 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+#include "kraken/api_class.h"
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace navitia {
+namespace kraken {
+
+/*
+ * Queue the requests waiting for a worker
+ *
+ * Each ApiClass has its own FIFO queue and the queues are served with a smooth weighted round robin:
+ * with weights {4, 2, 1}, over 7 consecutive pops of a fully loaded scheduler,
+ * 4 light, 2 standard and 1 heavy requests are dequeued, and they are interleaved.
+ *
+ * Requests whose deadline is reached when they come at the front of their queue
+ * are not returned by pop() but handed back to the caller so it can answer them
+ * without wasting a worker on them. The deadlines aren't ordered in a queue, so
+ * the caller also sweeps the whole queues from time to time with sweep_expired().
+ */
+template <typename Request>
+class RequestScheduler {
+public:
+    using Weights = std::array<int, NB_API_CLASSES>;
+
+    struct Item {
+        Request request;
+        ApiClass api_class;
+        boost::optional<boost::posix_time::ptime> deadline;
+        boost::posix_time::ptime enqueued_at;
+
+        bool is_expired(const boost::posix_time::ptime& now) const { return deadline && *deadline <= now; }
+    };
+
+private:
+    std::array<std::deque<Item>, NB_API_CLASSES> queues;
+    Weights weights;
+    Weights current_weights;
+    // 0 means no limit
+    size_t max_size;
+    size_t nb_queued = 0;
+
+    void drop_expired(const boost::posix_time::ptime& now, std::vector<Item>& expired) {
+        for (auto& queue : queues) {
+            while (!queue.empty() && queue.front().is_expired(now)) {
+                expired.push_back(std::move(queue.front()));
+                queue.pop_front();
+                --nb_queued;
+            }
+        }
+    }
+
+public:
+    explicit RequestScheduler(const Weights& weights, size_t max_size = 0) : weights(weights), max_size(max_size) {
+        for (const auto w : weights) {
+            if (w < 1) {
+                throw std::invalid_argument("weights of request scheduler must be strictly positive");
+            }
+        }
+        current_weights.fill(0);
+    }
+
+    /*
+     * Add a request at the end of the queue of its class
+     *
+     * return false if the scheduler is full, the request is then not queued
+     */
+    bool push(Request request,
+              ApiClass api_class,
+              const boost::optional<boost::posix_time::ptime>& deadline,
+              const boost::posix_time::ptime& now) {
+        if (max_size != 0 && nb_queued >= max_size) {
+            return false;
+        }
+        queues[static_cast<size_t>(api_class)].push_back(Item{std::move(request), api_class, deadline, now});
+        ++nb_queued;
+        return true;
+    }
+
+    /*
+     * Dequeue the next request to process
+     *
+     * The expired requests found at the front of the queues are moved to `expired`
+     * return none if there is no request left to process
+     */
+    boost::optional<Item> pop(const boost::posix_time::ptime& now, std::vector<Item>& expired) {
+        drop_expired(now, expired);
+
+        int total_weight = 0;
+        boost::optional<size_t> best;
+        for (size_t i = 0; i < NB_API_CLASSES; ++i) {
+            if (queues[i].empty()) {
+                // an idle class must not build up credit
+                current_weights[i] = 0;
+                continue;
+            }
+            current_weights[i] += weights[i];
+            total_weight += weights[i];
+            if (!best || current_weights[i] > current_weights[*best]) {
+                best = i;
+            }
+        }
+        if (!best) {
+            return boost::none;
+        }
+        current_weights[*best] -= total_weight;
+
+        auto& queue = queues[*best];
+        boost::optional<Item> item = std::move(queue.front());
+        queue.pop_front();
+        --nb_queued;
+        return item;
+    }
+
+    /*
+     * Move every expired request to `expired`, wherever it is in its queue
+     *
+     * It's linear in the number of queued requests, unlike pop() that only looks at the front of the queues
+     */
+    void sweep_expired(const boost::posix_time::ptime& now, std::vector<Item>& expired) {
+        for (auto& queue : queues) {
+            const auto first_expired = std::stable_partition(
+                queue.begin(), queue.end(), [&](const Item& item) { return !item.is_expired(now); });
+            std::move(first_expired, queue.end(), std::back_inserter(expired));
+            nb_queued -= std::distance(first_expired, queue.end());
+            queue.erase(first_expired, queue.end());
+        }
+    }
+
+    size_t size() const { return nb_queued; }
+    size_t size(ApiClass api_class) const { return queues[static_cast<size_t>(api_class)].size(); }
+    bool empty() const { return nb_queued == 0; }
+};
+
+}  // namespace kraken
+}  // namespace navitia
@@ -41,11 +41,12 @@ namespace test {
 // mock of Data class
 class Data {
 public:
-    void load_nav(const std::string&) {}
+    void load_nav(const std::string&, const Data* = nullptr) {}
     void load_disruptions(const std::string&, const std::vector<std::string>& = {}) {}
     void build_raptor(size_t) {}
     void build_relations() {}
     void build_proximity_list() {}
+    void build_fallback_cache(size_t) {}
     void build_autocomplete_partial() {}
     mutable std::atomic<bool> loading;
     mutable std::atomic<bool> is_connected_to_rabbitmq;
@@ -35,14 +35,16 @@ www.navitia.io
 
 #include "kraken/data_manager.h"
 #include "type/data.h"
+#include "type/meta_data.h"
 #include "utils/functions.h"  // absolute_path function
 
 static const std::string fake_data_file = "fake_data.nav.lz4";
 static const std::string fake_disruption_path = "fake_disruption_path";
 
 // We create a empty data with lz4 format in current directory.
-static void create_fake_data(const std::string& fake_file_name) {
+static void create_fake_data(const std::string& fake_file_name, const std::string& georef_version = "") {
     navitia::type::Data data(0);
+    data.meta->georef_version = georef_version;
     data.save(fake_file_name);
 }
 
@@ -110,3 +112,35 @@ BOOST_AUTO_TEST_CASE(load_failed) {
     // Data has not changed.
     BOOST_CHECK_EQUAL(first_data, data_manager.get_data());
 }
+
+// test sequence :
+// 1. load a data
+// 2. reload a data built with the same georef: the georef is shared
+// 3. reload a data built with another georef
+BOOST_AUTO_TEST_CASE(georef_kept_by_reload) {
+    const std::string georef_v1_file = "fake_data_georef_v1.nav.lz4";
+    const std::string georef_v2_file = "fake_data_georef_v2.nav.lz4";
+    create_fake_data(georef_v1_file, "v1");
+    create_fake_data(georef_v2_file, "v2");
+    const std::string georef_v1_path = navitia::absolute_path() + georef_v1_file;
+    const std::string georef_v2_path = navitia::absolute_path() + georef_v2_file;
+
+    DataManager<navitia::type::Data> data_manager;
+    BOOST_REQUIRE(data_manager.load(georef_v1_path));
+    auto first_data = data_manager.get_data();
+    BOOST_CHECK(!first_data->geo_ref_shared);
+
+    BOOST_REQUIRE(data_manager.load(georef_v1_path));
+    auto second_data = data_manager.get_data();
+    BOOST_CHECK_NE(first_data, second_data);
+    BOOST_CHECK(second_data->geo_ref_shared);
+    BOOST_CHECK_EQUAL(first_data->geo_ref.get(), second_data->geo_ref.get());
+
+    BOOST_REQUIRE(data_manager.load(georef_v2_path));
+    auto third_data = data_manager.get_data();
+    BOOST_CHECK(!third_data->geo_ref_shared);
+    BOOST_CHECK_NE(second_data->geo_ref.get(), third_data->geo_ref.get());
+
+    boost::filesystem::remove(georef_v1_path);
+    boost::filesystem::remove(georef_v2_path);
+}
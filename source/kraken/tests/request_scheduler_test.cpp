@@ -0,0 +1,189 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE request_scheduler_test
+
+#include "kraken/request_scheduler.h"
+#include "type/request.pb.h"
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+
+using namespace navitia::kraken;
+namespace pt = boost::posix_time;
+
+using Scheduler = RequestScheduler<std::string>;
+
+static const pt::ptime now = pt::time_from_string("2020-01-01 08:00:00");
+
+static std::vector<std::string> pop_all(Scheduler& scheduler) {
+    std::vector<std::string> res;
+    std::vector<Scheduler::Item> expired;
+    while (auto item = scheduler.pop(now, expired)) {
+        res.push_back(item->request);
+    }
+    BOOST_CHECK(expired.empty());
+    return res;
+}
+
+BOOST_AUTO_TEST_CASE(api_classes) {
+    BOOST_CHECK(get_api_class(pbnavitia::places) == ApiClass::Light);
+    BOOST_CHECK(get_api_class(pbnavitia::METADATAS) == ApiClass::Light);
+    BOOST_CHECK(get_api_class(pbnavitia::DEPARTURE_BOARDS) == ApiClass::Standard);
+    BOOST_CHECK(get_api_class(pbnavitia::pt_planner) == ApiClass::Heavy);
+    BOOST_CHECK(get_api_class(pbnavitia::heat_map) == ApiClass::Heavy);
+}
+
+BOOST_AUTO_TEST_CASE(fifo_in_one_class) {
+    Scheduler scheduler(Scheduler::Weights{{4, 2, 1}});
+    scheduler.push("a", ApiClass::Heavy, boost::none, now);
+    scheduler.push("b", ApiClass::Heavy, boost::none, now);
+    scheduler.push("c", ApiClass::Heavy, boost::none, now);
+    BOOST_CHECK_EQUAL(scheduler.size(), 3);
+
+    const auto res = pop_all(scheduler);
+    BOOST_REQUIRE_EQUAL(res.size(), 3);
+    BOOST_CHECK_EQUAL(res[0], "a");
+    BOOST_CHECK_EQUAL(res[1], "b");
+    BOOST_CHECK_EQUAL(res[2], "c");
+    BOOST_CHECK(scheduler.empty());
+}
+
+/*
+ * a burst of heavy requests is queued before some light requests,
+ * the light requests must not wait for all the heavy ones to be processed
+ */
+BOOST_AUTO_TEST_CASE(weighted_round_robin) {
+    Scheduler scheduler(Scheduler::Weights{{4, 2, 1}});
+    for (size_t i = 0; i < 10; ++i) {
+        scheduler.push("heavy", ApiClass::Heavy, boost::none, now);
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        scheduler.push("light", ApiClass::Light, boost::none, now);
+    }
+    for (size_t i = 0; i < 2; ++i) {
+        scheduler.push("standard", ApiClass::Standard, boost::none, now);
+    }
+
+    const auto res = pop_all(scheduler);
+    BOOST_REQUIRE_EQUAL(res.size(), 16);
+    // the first 7 requests follow the weights
+    BOOST_CHECK_EQUAL(std::count(res.begin(), res.begin() + 7, "light"), 4);
+    BOOST_CHECK_EQUAL(std::count(res.begin(), res.begin() + 7, "standard"), 2);
+    BOOST_CHECK_EQUAL(std::count(res.begin(), res.begin() + 7, "heavy"), 1);
+    // then only heavy requests are left
+    BOOST_CHECK_EQUAL(std::count(res.begin() + 7, res.end(), "heavy"), 9);
+}
+
+BOOST_AUTO_TEST_CASE(expired_requests_are_dropped_at_dequeue) {
+    Scheduler scheduler(Scheduler::Weights{{1, 1, 1}});
+    scheduler.push("expired", ApiClass::Heavy, now - pt::seconds(1), now - pt::seconds(2));
+    scheduler.push("ok", ApiClass::Heavy, now + pt::seconds(10), now - pt::seconds(2));
+    scheduler.push("no_deadline", ApiClass::Light, boost::none, now - pt::seconds(2));
+
+    std::vector<Scheduler::Item> expired;
+    std::vector<std::string> res;
+    while (auto item = scheduler.pop(now, expired)) {
+        res.push_back(item->request);
+    }
+    BOOST_REQUIRE_EQUAL(expired.size(), 1);
+    BOOST_CHECK_EQUAL(expired[0].request, "expired");
+    BOOST_CHECK(expired[0].api_class == ApiClass::Heavy);
+    BOOST_REQUIRE_EQUAL(res.size(), 2);
+    BOOST_CHECK(std::find(res.begin(), res.end(), "ok") != res.end());
+    BOOST_CHECK(std::find(res.begin(), res.end(), "no_deadline") != res.end());
+    BOOST_CHECK(scheduler.empty());
+}
+
+BOOST_AUTO_TEST_CASE(max_size) {
+    Scheduler scheduler(Scheduler::Weights{{1, 1, 1}}, 2);
+    BOOST_CHECK(scheduler.push("a", ApiClass::Light, boost::none, now));
+    BOOST_CHECK(scheduler.push("b", ApiClass::Heavy, boost::none, now));
+    BOOST_CHECK(!scheduler.push("c", ApiClass::Light, boost::none, now));
+    BOOST_CHECK_EQUAL(scheduler.size(), 2);
+    BOOST_CHECK_EQUAL(scheduler.size(ApiClass::Light), 1);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_weights) {
+    BOOST_CHECK_THROW(Scheduler(Scheduler::Weights{{1, 0, 1}}), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(expired_requests_are_swept_anywhere_in_the_queues) {
+    Scheduler scheduler(Scheduler::Weights{{1, 1, 1}});
+    scheduler.push("ok", ApiClass::Heavy, now + pt::seconds(10), now - pt::seconds(2));
+    // behind a request that isn't expired, pop() doesn't see it
+    scheduler.push("expired", ApiClass::Heavy, now - pt::seconds(1), now - pt::seconds(2));
+    scheduler.push("no_deadline", ApiClass::Light, boost::none, now - pt::seconds(2));
+
+    std::vector<Scheduler::Item> expired;
+    scheduler.sweep_expired(now, expired);
+    BOOST_REQUIRE_EQUAL(expired.size(), 1);
+    BOOST_CHECK_EQUAL(expired[0].request, "expired");
+    BOOST_CHECK_EQUAL(scheduler.size(), 2);
+    BOOST_CHECK_EQUAL(scheduler.size(ApiClass::Heavy), 1);
+
+    const auto res = pop_all(scheduler);
+    BOOST_REQUIRE_EQUAL(res.size(), 2);
+    BOOST_CHECK(std::find(res.begin(), res.end(), "ok") != res.end());
+    BOOST_CHECK(scheduler.empty());
+}
+
+BOOST_AUTO_TEST_CASE(request_header) {
+    pbnavitia::Request req;
+    req.set_requested_api(pbnavitia::pt_planner);
+    req.set_deadline("20200101T080000,000000");
+    // the journeys sub message is skipped
+    auto* journeys = req.mutable_journeys();
+    for (size_t i = 0; i < 100; ++i) {
+        journeys->add_origin()->set_place("stop_area:" + std::to_string(i));
+    }
+    std::string message;
+    BOOST_REQUIRE(req.SerializeToString(&message));
+
+    const auto header = read_request_header(message);
+    BOOST_REQUIRE(header.api);
+    BOOST_CHECK(*header.api == pbnavitia::pt_planner);
+    BOOST_REQUIRE(header.deadline);
+    BOOST_CHECK_EQUAL(*header.deadline, "20200101T080000,000000");
+
+    pbnavitia::Request no_deadline;
+    no_deadline.set_requested_api(pbnavitia::places);
+    BOOST_REQUIRE(no_deadline.SerializeToString(&message));
+    const auto places_header = read_request_header(message);
+    BOOST_CHECK(places_header.api && *places_header.api == pbnavitia::places);
+    BOOST_CHECK(!places_header.deadline);
+
+    // a truncated message gives an empty header
+    BOOST_REQUIRE(req.SerializeToString(&message));
+    const auto truncated = read_request_header(message.substr(0, message.size() - 3));
+    BOOST_CHECK(!truncated.api);
+    BOOST_CHECK(!truncated.deadline);
+}
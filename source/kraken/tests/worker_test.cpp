@@ -224,6 +224,32 @@ BOOST_FIXTURE_TEST_CASE(equipment_request_tests, fixture) {
     BOOST_CHECK_EQUAL(resp.equipment_reports(1).line().uri(), "l2");
 }
 
+BOOST_FIXTURE_TEST_CASE(pt_routing_matrix_tests, fixture) {
+    navitia::PtRoutingMatrixArg arg;
+    arg.origins = {"stop_point:A", "stop_point:C"};
+    arg.destinations = {"stop_point:B", "stop_point:C"};
+    arg.datetime = navitia::test::to_posix_timestamp("20150314T080000");
+    const auto d = data_manager.get_data();
+    w.pt_routing_matrix(arg, *d);
+
+    pbnavitia::Response resp = w.pb_creator.get_response();
+    BOOST_REQUIRE(!resp.has_error());
+    BOOST_REQUIRE_EQUAL(resp.sn_routing_matrix().rows_size(), 2);
+    const auto& from_a = resp.sn_routing_matrix().rows(0);
+    BOOST_REQUIRE_EQUAL(from_a.routing_response_size(), 2);
+    // l1 arrives at 9h at B and l3 at 11h at C
+    BOOST_CHECK_EQUAL(from_a.routing_response(0).routing_status(), pbnavitia::RoutingStatus::reached);
+    BOOST_CHECK_EQUAL(from_a.routing_response(0).duration(), 60 * 60);
+    BOOST_CHECK_EQUAL(from_a.routing_response(1).routing_status(), pbnavitia::RoutingStatus::reached);
+    BOOST_CHECK_EQUAL(from_a.routing_response(1).duration(), 3 * 60 * 60);
+    // nothing leaves C
+    const auto& from_c = resp.sn_routing_matrix().rows(1);
+    BOOST_REQUIRE_EQUAL(from_c.routing_response_size(), 2);
+    BOOST_CHECK_EQUAL(from_c.routing_response(0).routing_status(), pbnavitia::RoutingStatus::unreached);
+    BOOST_CHECK_EQUAL(from_c.routing_response(1).routing_status(), pbnavitia::RoutingStatus::reached);
+    BOOST_CHECK_EQUAL(from_c.routing_response(1).duration(), 0);
+}
+
 BOOST_AUTO_TEST_CASE(make_sn_entry_point_tests) {
     ed::builder b("20150314");
     std::string place = "stop_area_A";
@@ -225,7 +225,12 @@ std::vector<std::string> vector_of_admins(const T& admin) {
 }
 
 Worker::Worker(kraken::Configuration conf)
-    : conf(std::move(conf)), logger(log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"))) {}
+    : conf(std::move(conf)),
+      logger(log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"))),
+      // the pool is shared by the parallel parts of the requests, each one using at most its own number of threads
+      thread_pool(std::make_shared<navitia::routing::ThreadPool>(
+          std::max({this->conf.raptor_second_pass_threads(), this->conf.raptor_matrix_threads(),
+                    this->conf.heat_map_threads()}))) {}
 
 Worker::~Worker() = default;
 
@@ -378,7 +383,8 @@ void Worker::init_worker_data(const navitia::type::Data* data,
                               const bool disable_disruption) {
     //@TODO should be done in data_manager
     if (data->data_identifier != this->last_data_identifier || !planner) {
-        planner = std::make_unique<routing::RAPTOR>(*data);
+        planner = std::make_unique<routing::RAPTOR>(*data, conf.raptor_second_pass_threads(),
+                                                    conf.raptor_target_pruning(), thread_pool);
         street_network_worker = std::make_unique<georef::StreetNetwork>(*data->geo_ref);
         this->last_data_identifier = data->data_identifier;
         LOG4CPLUS_INFO(logger, "Instanciate planner");
@@ -871,11 +877,12 @@ void Worker::heat_map(const pbnavitia::HeatMapRequest& request) {
     auto end_mode_iso = request_journey.clockwise() ? streetnetwork.destination_mode() : streetnetwork.origin_mode();
     auto end_mode = type::static_data::get()->modeByCaption(end_mode_iso);
     auto end_speed = get_speed(streetnetwork, end_mode);
-    navitia::routing::make_heat_map(this->pb_creator, *planner, center_and_stop_points.first,
-                                    request_journey.datetimes(0), request_journey.max_duration(),
-                                    request_journey.max_transfers(), arg.accessibilite_params, arg.forbidden,
-                                    arg.allowed, request_journey.clockwise(), arg.rt_level, *street_network_worker,
-                                    end_speed, end_mode, request.resolution(), center_and_stop_points.second);
+    // several datetimes give the heat map of their time window
+    navitia::routing::make_heat_map(this->pb_creator, *planner, center_and_stop_points.first, arg.datetimes,
+                                    request_journey.max_duration(), request_journey.max_transfers(),
+                                    arg.accessibilite_params, arg.forbidden, arg.allowed, request_journey.clockwise(),
+                                    arg.rt_level, *street_network_worker, end_speed, end_mode, request.resolution(),
+                                    center_and_stop_points.second, conf.heat_map_threads());
 }
 
 void Worker::car_co2_emission_on_crow_fly(const pbnavitia::CarCO2EmissionRequest& request) {
@@ -1020,6 +1027,13 @@ void Worker::direct_path(const pbnavitia::Request& request) {
                              dp_request.clockwise());
 }
 
+georef::FallbackCacheStats Worker::pop_fallback_cache_stats() {
+    if (!street_network_worker) {
+        return {};
+    }
+    return street_network_worker->pop_fallback_cache_stats();
+}
+
 void Worker::dispatch(const pbnavitia::Request& request, const nt::Data& data) {
     bool disable_geojson = get_geojson_state(request);
     boost::posix_time::ptime current_datetime = bt::from_time_t(request._current_datetime());
@@ -1152,6 +1166,34 @@ void Worker::nearest_stop_points(const pbnavitia::NearestStopPointsRequest& requ
     }
 }
 
+void Worker::pt_routing_matrix(const PtRoutingMatrixArg& arg, const nt::Data& data) {
+    this->init_worker_data(&data, pt::second_clock::universal_time(), null_time_period);
+    if (!data.loaded) {
+        this->pb_creator.fill_pb_error(pbnavitia::Error::service_unavailable, "The service is loading data");
+        return;
+    }
+
+    std::vector<type::EntryPoint> origins;
+    std::vector<type::EntryPoint> destinations;
+    try {
+        for (const auto& origin : arg.origins) {
+            origins.push_back(make_sn_entry_point(origin, arg.mode, arg.speed, arg.max_fallback_duration, data));
+        }
+        for (const auto& destination : arg.destinations) {
+            destinations.push_back(
+                make_sn_entry_point(destination, arg.mode, arg.speed, arg.max_fallback_duration, data));
+        }
+    } catch (const navitia::coord_conversion_exception& e) {
+        this->pb_creator.fill_pb_error(pbnavitia::Error::bad_format, e.what());
+        return;
+    }
+
+    navitia::routing::make_pt_routing_matrix(this->pb_creator, *planner, origins, destinations, arg.datetime,
+                                             arg.max_duration, arg.max_transfers, type::AccessibiliteParams(),
+                                             arg.forbidden, arg.allowed, arg.rt_level, *street_network_worker,
+                                             conf.raptor_matrix_threads());
+}
+
 void Worker::odt_stop_points(const pbnavitia::GeographicalCoord& request) {
     navitia::type::GeographicalCoord coord;
     coord.set_lon(request.lon());
@@ -34,6 +34,7 @@ www.navitia.io
 namespace navitia {
 namespace routing {
 struct RAPTOR;
+class ThreadPool;
 }
 }  // namespace navitia
 
@@ -71,6 +72,21 @@ struct JourneysArg {
     JourneysArg();
 };
 
+// arguments of the public transport routing matrix
+struct PtRoutingMatrixArg {
+    std::vector<std::string> origins;
+    std::vector<std::string> destinations;
+    uint64_t datetime = 0;
+    std::string mode = "walking";
+    float speed = 1.12;
+    int max_fallback_duration = 30 * 60;
+    int max_duration = 24 * 60 * 60;
+    uint32_t max_transfers = 10;
+    std::vector<std::string> forbidden;
+    std::vector<std::string> allowed;
+    type::RTLevel rt_level = type::RTLevel::Base;
+};
+
 class Worker {
 private:
     std::unique_ptr<navitia::routing::RAPTOR> planner;
@@ -78,6 +94,8 @@ private:
 
     const kraken::Configuration conf;
     log4cplus::Logger logger;
+    // the threads of the planner, kept when the planner is rebuilt for a new data
+    std::shared_ptr<navitia::routing::ThreadPool> thread_pool;
     size_t last_data_identifier =
         std::numeric_limits<size_t>::max();  // to check that data did not change, do not use directly
     boost::posix_time::ptime last_load_at;
@@ -92,6 +110,18 @@ public:
 
     void dispatch(const pbnavitia::Request& request, const nt::Data& data);
 
+    /*
+     * Same as street_network_routing_matrix, by public transport: the durations of the earliest arrivals
+     * leaving at the datetime, with street network fallbacks. It is filled as a street network matrix.
+     *
+     * It isn't dispatched yet: navitia-proto has no request for it. Once it has, dispatch() will only have to
+     * convert the request into a PtRoutingMatrixArg
+     * */
+    void pt_routing_matrix(const PtRoutingMatrixArg& arg, const nt::Data& data);
+
+    // hits and misses of the fallback cache since the previous call
+    georef::FallbackCacheStats pop_fallback_cache_stats();
+
 private:
     void init_worker_data(const navitia::type::Data* data,
                           const pt::ptime now,
@@ -131,6 +161,7 @@ private:
      * from origin to destination by taking street network
      * */
     void street_network_routing_matrix(const pbnavitia::StreetNetworkRoutingMatrixRequest& request);
+
     void odt_stop_points(const pbnavitia::GeographicalCoord& request);
 
     void get_matching_routes(const pbnavitia::MatchingRoute&);
@@ -32,9 +32,21 @@ www.navitia.io
 
 #include "routing.h"
 #include "routing/raptor_utils.h"
+#include "type/commercial_mode.h"
+#include "type/line.h"
+#include "type/network.h"
+#include "type/physical_mode.h"
+#include "type/route.h"
 
+#include <boost/functional/hash.hpp>
+#include <boost/range/algorithm/fill.hpp>
+#include <boost/range/algorithm/sort.hpp>
 #include <boost/range/algorithm_ext.hpp>
 
+#include <functional>
+#include <queue>
+#include <tuple>
+
 namespace navitia {
 namespace routing {
 
@@ -86,6 +98,166 @@ void dataRAPTOR::JppsFromJp::load(const JourneyPatternContainer& jp_container) {
     }
 }
 
+void dataRAPTOR::JpFilters::load(const type::PT_Data& data,
+                                 const JourneyPatternContainer& jp_container,
+                                 const JppsFromSp& jpps_from_sp) {
+    const boost::dynamic_bitset<> no_jps(jp_container.nb_jps());
+    jps_from_network.assign(data.networks, no_jps);
+    jps_from_commercial_mode.assign(data.commercial_modes, no_jps);
+    jps_from_physical_mode.assign(data.physical_modes, no_jps);
+    for (const auto jp : jp_container.get_jps()) {
+        jps_from_physical_mode[jp.second.phy_mode_idx].set(jp.first.val);
+        const auto* line = data.routes[jp.second.route_idx.val]->line;
+        if (!line) {
+            continue;
+        }
+        if (line->network) {
+            jps_from_network[Idx<type::Network>(*line->network)].set(jp.first.val);
+        }
+        if (line->commercial_mode) {
+            jps_from_commercial_mode[Idx<type::CommercialMode>(*line->commercial_mode)].set(jp.first.val);
+        }
+    }
+
+    const auto nb_properties = type::Properties().size();
+    sps_without_property.assign(nb_properties, boost::dynamic_bitset<>(data.stop_points.size()));
+    jpps_without_property.assign(nb_properties, boost::dynamic_bitset<>(jp_container.nb_jpps()));
+    for (const auto* sp : data.stop_points) {
+        const auto properties = sp->properties();
+        for (size_t p = 0; p < nb_properties; ++p) {
+            if (properties[p]) {
+                continue;
+            }
+            sps_without_property[p].set(sp->idx);
+            for (const auto& jpp : jpps_from_sp[SpIdx(*sp)]) {
+                jpps_without_property[p].set(jpp.idx.val);
+            }
+        }
+    }
+}
+
+// keep only the shortest edge to each stop point
+static void keep_min_edges(std::vector<dataRAPTOR::MinDurations::Edge>& edges) {
+    using Edge = dataRAPTOR::MinDurations::Edge;
+    boost::sort(edges, [](const Edge& lhs, const Edge& rhs) {
+        return std::tie(lhs.sp_idx, lhs.duration) < std::tie(rhs.sp_idx, rhs.duration);
+    });
+    const auto last = std::unique(edges.begin(), edges.end(),
+                                  [](const Edge& lhs, const Edge& rhs) { return lhs.sp_idx == rhs.sp_idx; });
+    edges.erase(last, edges.end());
+    edges.shrink_to_fit();
+}
+
+void dataRAPTOR::MinDurations::load(const type::PT_Data& data,
+                                    const JourneyPatternContainer& jp_container,
+                                    const Connections& connections) {
+    forward_edges.assign(data.stop_points);
+    backward_edges.assign(data.stop_points);
+    const auto add_edge = [&](const SpIdx& from, const SpIdx& to, const DateTime duration) {
+        forward_edges[from].push_back({duration, to});
+        backward_edges[to].push_back({duration, from});
+    };
+
+    for (const auto jp : jp_container.get_jps()) {
+        const auto& jpps = jp.second.jpps;
+        for (size_t i = 1; i < jpps.size(); ++i) {
+            // arrival_time - departure_time is a lower bound of alighting_time - boarding_time,
+            // and their sum along a vj is a lower bound of any ride of this vj
+            DateTime min_ride = DateTimeUtils::inf;
+            jp.second.for_each_vehicle_journey([&](const nt::VehicleJourney& vj) {
+                const auto& prev_st = vj.stop_time_list[i - 1];
+                const auto& st = vj.stop_time_list[i];
+                const DateTime ride = st.arrival_time > prev_st.departure_time
+                                          ? st.arrival_time - prev_st.departure_time
+                                          : 0;
+                min_ride = std::min(min_ride, ride);
+                return true;
+            });
+            if (min_ride != DateTimeUtils::inf) {
+                add_edge(jp_container.get(jpps[i - 1]).sp_idx, jp_container.get(jpps[i]).sp_idx, min_ride);
+            }
+        }
+        // stay in: we can stay in the vehicle from the last stop of the vj to the first one of the next vj
+        jp.second.for_each_vehicle_journey([&](const nt::VehicleJourney& vj) {
+            if (vj.next_vj && !vj.stop_time_list.empty() && !vj.next_vj->stop_time_list.empty()) {
+                add_edge(SpIdx(*vj.stop_time_list.back().stop_point),
+                         SpIdx(*vj.next_vj->stop_time_list.front().stop_point), 0);
+            }
+            return true;
+        });
+    }
+    for (const auto conns : connections.forward_connections) {
+        for (const auto& conn : conns.second) {
+            add_edge(conns.first, conn.sp_idx, conn.duration);
+        }
+    }
+
+    for (auto& edges : forward_edges.values()) {
+        keep_min_edges(edges);
+    }
+    for (auto& edges : backward_edges.values()) {
+        keep_min_edges(edges);
+    }
+}
+
+void dataRAPTOR::MinDurations::lower_bounds(const std::vector<SpIdx>& targets,
+                                            const bool clockwise,
+                                            IdxMap<type::StopPoint, DateTime>& durations) const {
+    // dijkstra from the targets, against the direction of the search
+    const auto& edges = clockwise ? backward_edges : forward_edges;
+    boost::fill(durations.values(), DateTimeUtils::inf);
+    using Elt = std::pair<DateTime, SpIdx>;
+    std::priority_queue<Elt, std::vector<Elt>, std::greater<Elt>> queue;
+    for (const auto& target : targets) {
+        durations[target] = 0;
+        queue.push({0, target});
+    }
+    while (!queue.empty()) {
+        const auto elt = queue.top();
+        queue.pop();
+        if (elt.first != durations[elt.second]) {
+            continue;  // already visited with a shorter duration
+        }
+        for (const auto& edge : edges[elt.second]) {
+            const DateTime duration = elt.first + edge.duration;
+            if (duration < durations[edge.sp_idx]) {
+                durations[edge.sp_idx] = duration;
+                queue.push({duration, edge.sp_idx});
+            }
+        }
+    }
+}
+
+static void hash_vj(size_t& seed, const nt::VehicleJourney& vj) {
+    static const auto levels = {nt::RTLevel::Base, nt::RTLevel::Adapted, nt::RTLevel::RealTime};
+    boost::hash_combine(seed, vj.idx);
+    boost::hash_combine(seed, vj._vehicle_properties.to_ulong());
+    for (const auto level : levels) {
+        const auto* vp = vj.validity_patterns[level];
+        boost::hash_combine(seed, vp ? std::hash<nt::ValidityPattern::year_bitset>()(vp->days) : 0);
+    }
+    for (const auto& st : vj.stop_time_list) {
+        boost::hash_combine(seed, st.boarding_time);
+        boost::hash_combine(seed, st.alighting_time);
+        boost::hash_combine(seed, st.properties.to_ulong());
+    }
+}
+
+static size_t compute_signature(const JourneyPattern& jp) {
+    size_t seed = 0;
+    boost::hash_combine(seed, jp.jpps.size());
+    for (const auto* vj : jp.discrete_vjs) {
+        hash_vj(seed, *vj);
+    }
+    for (const auto* vj : jp.freq_vjs) {
+        hash_vj(seed, *vj);
+        boost::hash_combine(seed, vj->start_time);
+        boost::hash_combine(seed, vj->end_time);
+        boost::hash_combine(seed, vj->headway_secs);
+    }
+    return seed;
+}
+
 void dataRAPTOR::load(const type::PT_Data& data, size_t cache_size) {
     jp_container.load(data);
     labels_const.init_inf(data.stop_points);
@@ -94,8 +266,15 @@ void dataRAPTOR::load(const type::PT_Data& data, size_t cache_size) {
     connections.load(data);
     jpps_from_sp.load(data, jp_container);
     jpps_from_jp.load(jp_container);
+    jp_filters.load(data, jp_container, jpps_from_sp);
+    min_durations.load(data, jp_container, connections);
     next_stop_time_data.load(jp_container);
 
+    jp_signatures.assign(jp_container.get_jps_values());
+    for (const auto jp : jp_container.get_jps()) {
+        jp_signatures[jp.first] = compute_signature(jp.second);
+    }
+
     for (auto level_cont : jp_validity_patterns) {
         const auto rt_level = level_cont.first;
         auto& jp_vp = level_cont.second;
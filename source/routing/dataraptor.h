@@ -96,6 +96,43 @@ struct dataRAPTOR {
     };
     JppsFromJp jpps_from_jp;
 
+    // journey patterns and journey pattern points by pt object, so that the
+    // forbidden/allowed uris and the accessibility params of a request are
+    // applied with bitset operations
+    struct JpFilters {
+        void load(const type::PT_Data&, const JourneyPatternContainer&, const JppsFromSp&);
+
+        IdxMap<type::Network, boost::dynamic_bitset<>> jps_from_network;
+        IdxMap<type::CommercialMode, boost::dynamic_bitset<>> jps_from_commercial_mode;
+        IdxMap<type::PhysicalMode, boost::dynamic_bitset<>> jps_from_physical_mode;
+        // sps_without_property[p][sp_idx] == !sp.properties()[p], and the same for their jpps
+        std::vector<boost::dynamic_bitset<>> sps_without_property;
+        std::vector<boost::dynamic_bitset<>> jpps_without_property;
+    };
+    JpFilters jp_filters;
+
+    // time independent graph of the minimal durations between stop points
+    // (ride between 2 consecutive stops of a journey pattern, connection and
+    // stay in), its shortest paths are lower bounds of the duration of a journey
+    struct MinDurations {
+        struct Edge {
+            DateTime duration;
+            SpIdx sp_idx;
+        };
+        void load(const type::PT_Data&, const JourneyPatternContainer&, const Connections&);
+
+        // Fill durations with, for each stop point, the minimal duration to reach
+        // one of the targets if clockwise, or to reach it from one of the targets
+        // otherwise.  DateTimeUtils::inf if not possible.
+        void lower_bounds(const std::vector<SpIdx>& targets,
+                          const bool clockwise,
+                          IdxMap<type::StopPoint, DateTime>& durations) const;
+
+        IdxMap<type::StopPoint, std::vector<Edge>> forward_edges;
+        IdxMap<type::StopPoint, std::vector<Edge>> backward_edges;
+    };
+    MinDurations min_durations;
+
     NextStopTimeData next_stop_time_data;
     std::unique_ptr<CachedNextStopTimeManager> cached_next_st_manager;
 
@@ -105,6 +142,11 @@ struct dataRAPTOR {
     Labels labels_const;
     Labels labels_const_reverse;
 
+    // Hash of everything in a journey pattern that is used by the raptor cache
+    // (vehicle journeys, stop times, validity patterns...), used to share the
+    // cache of the unchanged journey patterns between 2 Data generations
+    IdxMap<JourneyPattern, size_t> jp_signatures;
+
     // jp_validity_patterns[date][jp_idx] == any(vj.validity_pattern->check2(date) for vj in jp)
     flat_enum_map<type::RTLevel, std::vector<boost::dynamic_bitset<>>> jp_validity_patterns;
 
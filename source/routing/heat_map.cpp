@@ -35,6 +35,9 @@ www.navitia.io
 #include "raptor_api.h"
 #include "type/geographical_coord.h"
 
+#include <boost/property_map/property_map.hpp>
+
+#include <unordered_map>
 #include <vector>
 
 namespace navitia {
@@ -43,20 +46,18 @@ namespace routing {
 const auto source_e = georef::ProjectionData::Direction::Source;
 const auto target_e = georef::ProjectionData::Direction::Target;
 
-static std::string print_single_coord(const SingleCoord& coord, const std::string& type) {
-    std::stringstream ss;
+static void print_single_coord(std::stringstream& ss, const SingleCoord& coord, const char* type) {
     ss << R"(")"
        << "cell_" << type << R"(":{)";
     ss << R"("min_)" << type << R"(":)" << coord.min_coord;
     ss << R"(,"center_)" << type << R"(":)" << coord.min_coord + coord.step / 2;
     ss << R"(,"max_)" << type << R"(":)" << coord.min_coord + coord.step;
     ss << "}";
-    return ss.str();
 }
 
-static void print_lat(std::stringstream& ss, const SingleCoord lat) {
+static void print_lat(std::stringstream& ss, const SingleCoord& lat) {
     ss << "{";
-    ss << print_single_coord(lat, "lat");
+    print_single_coord(ss, lat, "lat");
     ss << "}";
 }
 
@@ -68,9 +69,10 @@ static void print_datetime(std::stringstream& ss, const navitia::time_duration&
     }
 }
 
-static void print_body(std::stringstream& ss, std::pair<SingleCoord, std::vector<navitia::time_duration>> pair) {
+static void print_body(std::stringstream& ss,
+                       const std::pair<SingleCoord, std::vector<navitia::time_duration>>& pair) {
     ss << "{";
-    ss << print_single_coord(pair.first, "lon");
+    print_single_coord(ss, pair.first, "lon");
     ss << R"(,"duration":[)";
     separated_by_coma(ss, print_datetime, pair.second);
     ss << R"(]})";
@@ -95,6 +97,54 @@ static std::pair<int, int> find_rank(const BoundBox& box,
     return std::make_pair(lon_rank, lat_rank);
 }
 
+// Call f(begin, end) on at most nb_threads threads of the pool, each call with its own range of rows
+// in [0, nb_rows). Without a pool, f is called once on every row.
+template <typename F>
+static void for_each_rows(const size_t nb_rows, const size_t nb_threads, ThreadPool* thread_pool, const F& f) {
+    if (!thread_pool || nb_threads <= 1) {
+        f(0, nb_rows);
+        return;
+    }
+    const size_t nb_ranges = std::max<size_t>(std::min({nb_threads, thread_pool->size(), nb_rows}), 1);
+    const size_t range_size = (nb_rows + nb_ranges - 1) / nb_ranges;
+    thread_pool->run(nb_ranges, nb_ranges, [&](size_t, const size_t r) {
+        f(std::min(r * range_size, nb_rows), std::min((r + 1) * range_size, nb_rows));
+    });
+}
+
+// read/write property map on the VertexDurations, for the dijkstra
+struct VertexDurationsMap {
+    using key_type = georef::vertex_t;
+    using value_type = navitia::time_duration;
+    using reference = navitia::time_duration;
+    using category = boost::read_write_property_map_tag;
+    VertexDurations* distances;
+};
+
+static navitia::time_duration get(const VertexDurationsMap& map, const georef::vertex_t v) {
+    return (*map.distances)[v];
+}
+
+static void put(const VertexDurationsMap& map, const georef::vertex_t v, const navitia::time_duration& duration) {
+    map.distances->durations[v] = duration;
+}
+
+// Stop the dijkstra when the closest vertex left is beyond max_duration
+struct VertexDurationsVisitor : public boost::dijkstra_visitor<> {
+    navitia::time_duration max_duration;
+    const VertexDurations& distances;
+
+    VertexDurationsVisitor(const navitia::time_duration& max_duration, const VertexDurations& distances)
+        : max_duration(max_duration), distances(distances) {}
+
+    template <typename G>
+    void examine_vertex(typename boost::graph_traits<G>::vertex_descriptor u, const G&) {
+        if (distances[u] > max_duration) {
+            throw georef::DestinationFound();
+        }
+    }
+};
+
 struct Projection {
     boost::optional<double> distance;
     georef::vertex_t source{};
@@ -138,7 +188,9 @@ static std::vector<std::vector<Projection>> find_projection(BoundBox box,
                                                             const georef::GeoRef& worker,
                                                             const double min_dist,
                                                             const HeatMap& heat_map,
-                                                            const size_t step) {
+                                                            const size_t step,
+                                                            const size_t nb_threads,
+                                                            ThreadPool* thread_pool) {
     std::vector<std::vector<Projection>> dist_pixel = {step, {step, Projection()}};
     const size_t offset_lon = floor(min_dist / (width_step * N_DEG_TO_DISTANCE)) + 1;
     const size_t offset_lat = floor(min_dist / (height_step * N_DEG_TO_DISTANCE)) + 1;
@@ -153,7 +205,12 @@ static std::vector<std::vector<Projection>> find_projection(BoundBox box,
         return {};
     }
 
-    const auto coslat = cos(objects_inside.front().second.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
+    struct EdgeCells {
+        georef::vertex_t source;
+        georef::vertex_t target;
+        Boundary boundary;
+    };
+    std::vector<EdgeCells> edges;
     for (const auto& o : objects_inside) {
         const auto element = o.first;
         const auto& source = o.second;
@@ -164,11 +221,21 @@ static std::vector<std::vector<Projection>> find_projection(BoundBox box,
         const auto rank_source = find_rank(box, source, height_step, width_step);
         BOOST_FOREACH (const georef::edge_t& e, boost::out_edges(element, worker.graph)) {
             const auto v = target(e, worker.graph);
-            const auto& target = worker.graph[v].coord;
-            const auto rank_target = find_rank(box, target, height_step, width_step);
-            const auto boundary = find_boundary(rank_source, rank_target, offset_lon, offset_lat, step);
-            for (uint lon_rank = boundary.min_lon; lon_rank <= boundary.max_lon; lon_rank++) {
-                for (uint lat_rank = boundary.min_lat; lat_rank <= boundary.max_lat; lat_rank++) {
+            const auto rank_target = find_rank(box, worker.graph[v].coord, height_step, width_step);
+            edges.push_back({element, v, find_boundary(rank_source, rank_target, offset_lon, offset_lat, step)});
+        }
+    }
+
+    // each thread handles its own lon rows, the edges are visited in the same order for every cell
+    const auto coslat = cos(objects_inside.front().second.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
+    for_each_rows(step, nb_threads, thread_pool, [&](const size_t begin, const size_t end) {
+        for (const auto& edge : edges) {
+            const auto& source = worker.graph[edge.source].coord;
+            const auto& target = worker.graph[edge.target].coord;
+            const auto min_lon = std::max(edge.boundary.min_lon, begin);
+            const auto max_lon = std::min(edge.boundary.max_lon + 1, end);
+            for (size_t lon_rank = min_lon; lon_rank < max_lon; lon_rank++) {
+                for (size_t lat_rank = edge.boundary.min_lat; lat_rank <= edge.boundary.max_lat; lat_rank++) {
                     auto center = type::GeographicalCoord(heat_map.body[lon_rank].first.min_coord + width_step / 2,
                                                           heat_map.header[lat_rank].min_coord + height_step / 2);
                     auto proj = center.approx_project(source, target, coslat);
@@ -177,13 +244,13 @@ static std::vector<std::vector<Projection>> find_projection(BoundBox box,
                         && (!dist_pixel[lon_rank][lat_rank].distance
                             || length < *dist_pixel[lon_rank][lat_rank].distance)) {
                         dist_pixel[lon_rank][lat_rank].distance = length;
-                        dist_pixel[lon_rank][lat_rank].source = element;
-                        dist_pixel[lon_rank][lat_rank].target = v;
+                        dist_pixel[lon_rank][lat_rank].source = edge.source;
+                        dist_pixel[lon_rank][lat_rank].target = edge.target;
                     }
                 }
             }
         }
-    }
+    });
     return dist_pixel;
 }
 
@@ -194,51 +261,61 @@ HeatMap fill_heat_map(const BoundBox& box,
                       const double min_dist,
                       const double max_duration,
                       const double speed,
-                      const std::vector<navitia::time_duration>& distances,
-                      const size_t step) {
+                      const VertexDurations& distances,
+                      const size_t step,
+                      const size_t nb_threads,
+                      ThreadPool* thread_pool) {
     auto heat_map = HeatMap(step, box, height_step, width_step);
-    auto projection = find_projection(box, height_step, width_step, worker, min_dist, heat_map, step);
-    for (size_t i = 0; i < step; i++) {
-        for (size_t j = 0; j < step; j++) {
-            auto& duration = heat_map.body[i].second[j];
-            if (projection[i][j].distance) {
-                auto center = type::GeographicalCoord(heat_map.body[i].first.min_coord + width_step / 2,
-                                                      heat_map.header[j].min_coord + height_step / 2);
-                const auto source = worker.graph[projection[i][j].source].coord;
-                const auto target = worker.graph[projection[i][j].target].coord;
-                const auto coslat = cos(center.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
-                const auto duration_to_source =
-                    distances[projection[i][j].source]
-                    + navitia::milliseconds(sqrt(center.approx_sqr_distance(source, coslat)) / speed * 1e3);
-                const auto duration_to_target =
-                    distances[projection[i][j].target]
-                    + navitia::milliseconds(sqrt(center.approx_sqr_distance(target, coslat)) / speed * 1e3);
-                const auto& new_duration = std::min(duration_to_source, duration_to_target);
-                if (new_duration.total_seconds() < max_duration) {
-                    duration = new_duration;
+    auto projection =
+        find_projection(box, height_step, width_step, worker, min_dist, heat_map, step, nb_threads, thread_pool);
+    if (projection.empty()) {
+        return heat_map;
+    }
+    for_each_rows(step, nb_threads, thread_pool, [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            for (size_t j = 0; j < step; j++) {
+                auto& duration = heat_map.body[i].second[j];
+                if (projection[i][j].distance) {
+                    auto center = type::GeographicalCoord(heat_map.body[i].first.min_coord + width_step / 2,
+                                                          heat_map.header[j].min_coord + height_step / 2);
+                    const auto source = worker.graph[projection[i][j].source].coord;
+                    const auto target = worker.graph[projection[i][j].target].coord;
+                    const auto coslat = cos(center.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
+                    const auto duration_to_source =
+                        distances[projection[i][j].source]
+                        + navitia::milliseconds(sqrt(center.approx_sqr_distance(source, coslat)) / speed * 1e3);
+                    const auto duration_to_target =
+                        distances[projection[i][j].target]
+                        + navitia::milliseconds(sqrt(center.approx_sqr_distance(target, coslat)) / speed * 1e3);
+                    const auto& new_duration = std::min(duration_to_source, duration_to_target);
+                    if (new_duration.total_seconds() < max_duration) {
+                        duration = new_duration;
+                    } else {
+                        duration = bt::pos_infin;
+                    }
                 } else {
                     duration = bt::pos_infin;
                 }
-            } else {
-                duration = bt::pos_infin;
             }
         }
-    }
+    });
     return heat_map;
 }
 
 static std::string build_grid(const georef::GeoRef& worker,
                               const BoundBox& box,
-                              const std::vector<navitia::time_duration>& distances,
+                              const VertexDurations& distances,
                               const double speed,
                               const double max_duration,
-                              const uint resolution) {
+                              const uint resolution,
+                              const size_t nb_threads,
+                              ThreadPool* thread_pool) {
     double width_step = (box.max.lon() - box.min.lon()) / resolution;
     double height_step = (box.max.lat() - box.min.lat()) / resolution;
     auto min_dist = std::max(500., width_step * N_DEG_TO_DISTANCE);
     min_dist = std::max(min_dist, height_step * N_DEG_TO_DISTANCE);
-    auto heat_map =
-        fill_heat_map(box, height_step, width_step, worker, min_dist, max_duration, speed, distances, resolution);
+    auto heat_map = fill_heat_map(box, height_step, width_step, worker, min_dist, max_duration, speed, distances,
+                                  resolution, nb_threads, thread_pool);
     return print_grid(heat_map);
 }
 
@@ -246,37 +323,40 @@ static double walking_distance(const DateTime& max_duration, const DateTime& dur
     return (max_duration - duration) * speed / type::GeographicalCoord::EARTH_RADIUS_IN_METERS * N_RAD_TO_DEG;
 }
 
-std::vector<navitia::time_duration> init_distance(const georef::GeoRef& worker,
-                                                  const std::vector<type::StopPoint*>& stop_points,
-                                                  const DateTime& init_dt,
-                                                  const RAPTOR& raptor,
-                                                  const type::Mode_e& mode,
-                                                  const type::GeographicalCoord& coord_origin,
-                                                  const bool clockwise,
-                                                  const DateTime& bound,
-                                                  const double speed) {
-    std::vector<navitia::time_duration> distances;
-    size_t n = boost::num_vertices(worker.graph);
-    distances.assign(n, bt::pos_infin);
+StopPointDurations make_stop_point_durations(const RAPTOR& raptor,
+                                             const DateTime& init_dt,
+                                             const bool clockwise,
+                                             const DateTime& bound) {
+    StopPointDurations sp_durations(raptor.data.pt_data->stop_points, DateTimeUtils::inf);
+    for (const auto sp_lbl : raptor.best_labels_pts) {
+        if (in_bound(sp_lbl.second, bound, clockwise)) {
+            sp_durations[sp_lbl.first] = clockwise ? sp_lbl.second - init_dt : init_dt - sp_lbl.second;
+        }
+    }
+    return sp_durations;
+}
+
+VertexDurations init_distance(const georef::GeoRef& worker,
+                              const std::vector<type::StopPoint*>& stop_points,
+                              const StopPointDurations& sp_durations,
+                              const type::Mode_e& mode,
+                              const type::GeographicalCoord& coord_origin,
+                              const double speed) {
+    VertexDurations distances;
     auto proj = georef::ProjectionData(coord_origin, worker, mode);
     if (proj.found) {
-        distances[proj[source_e]] =
-            std::min(distances[proj[source_e]], time_duration(seconds(proj.distances[source_e] / speed)));
-        distances[proj[target_e]] =
-            std::min(distances[proj[target_e]], time_duration(seconds(proj.distances[target_e] / speed)));
+        distances.set_min(proj[source_e], time_duration(seconds(proj.distances[source_e] / speed)));
+        distances.set_min(proj[target_e], time_duration(seconds(proj.distances[target_e] / speed)));
     }
     for (const type::StopPoint* sp : stop_points) {
-        SpIdx sp_idx(*sp);
-        const auto& best_lbl = raptor.best_labels_pts[sp_idx];
-        if (in_bound(best_lbl, bound, clockwise)) {
+        const auto sp_duration = sp_durations[SpIdx(*sp)];
+        if (sp_duration != DateTimeUtils::inf) {
             const auto& projections = worker.projected_stop_points[sp->idx];
             const auto& proj = projections[mode];
             if (proj.found) {
-                const double duration = clockwise ? best_lbl - init_dt : init_dt - best_lbl;
-                distances[proj[source_e]] = std::min(
-                    distances[proj[source_e]], time_duration(seconds(duration + proj.distances[source_e] / speed)));
-                distances[proj[target_e]] = std::min(
-                    distances[proj[target_e]], time_duration(seconds(duration + proj.distances[target_e] / speed)));
+                const double duration = sp_duration;
+                distances.set_min(proj[source_e], time_duration(seconds(duration + proj.distances[source_e] / speed)));
+                distances.set_min(proj[target_e], time_duration(seconds(duration + proj.distances[target_e] / speed)));
             }
         }
     }
@@ -285,11 +365,9 @@ std::vector<navitia::time_duration> init_distance(const georef::GeoRef& worker,
 
 static std::vector<georef::vertex_t> init_vertex(const georef::GeoRef& worker,
                                                  const std::vector<type::StopPoint*>& stop_points,
-                                                 const RAPTOR& raptor,
+                                                 const StopPointDurations& sp_durations,
                                                  const type::Mode_e& mode,
-                                                 const type::GeographicalCoord& coord_origin,
-                                                 const bool clockwise,
-                                                 const DateTime& bound) {
+                                                 const type::GeographicalCoord& coord_origin) {
     std::vector<georef::vertex_t> initialized_points;
     auto proj = georef::ProjectionData(coord_origin, worker, mode);
     if (proj.found) {
@@ -297,9 +375,7 @@ static std::vector<georef::vertex_t> init_vertex(const georef::GeoRef& worker,
         initialized_points.push_back(proj[target_e]);
     }
     for (const type::StopPoint* sp : stop_points) {
-        SpIdx sp_idx(*sp);
-        const auto& best_lbl = raptor.best_labels_pts[sp_idx];
-        if (in_bound(best_lbl, bound, clockwise)) {
+        if (sp_durations[SpIdx(*sp)] != DateTimeUtils::inf) {
             const auto& projections = worker.projected_stop_points[sp->idx];
             const auto& proj = projections[mode];
             if (proj.found) {
@@ -313,12 +389,9 @@ static std::vector<georef::vertex_t> init_vertex(const georef::GeoRef& worker,
 
 static BoundBox find_boundary_box(const georef::GeoRef& worker,
                                   const std::vector<type::StopPoint*>& stop_points,
-                                  const DateTime& init_dt,
-                                  const RAPTOR& raptor,
+                                  const StopPointDurations& sp_durations,
                                   const type::Mode_e& mode,
                                   const type::GeographicalCoord& coord_origin,
-                                  const bool clockwise,
-                                  const DateTime& bound,
                                   const DateTime& max_duration,
                                   const double speed) {
     auto box = BoundBox();
@@ -328,13 +401,11 @@ static BoundBox find_boundary_box(const georef::GeoRef& worker,
         box.set_box(coord_origin, walking_distance(max_duration, 0, speed) + distance_500m);
     }
     for (const type::StopPoint* sp : stop_points) {
-        SpIdx sp_idx(*sp);
-        const auto& best_lbl = raptor.best_labels_pts[sp_idx];
-        if (in_bound(best_lbl, bound, clockwise)) {
+        const auto duration = sp_durations[SpIdx(*sp)];
+        if (duration != DateTimeUtils::inf) {
             const auto& projections = worker.projected_stop_points[sp->idx];
             const auto& proj = projections[mode];
             if (proj.found) {
-                const double duration = clockwise ? best_lbl - init_dt : init_dt - best_lbl;
                 box.set_box(sp->coord, walking_distance(max_duration, duration, speed) + distance_500m);
             }
         }
@@ -351,29 +422,45 @@ std::string build_raster_isochrone(const georef::GeoRef& worker,
                                    const DateTime duration,
                                    const bool clockwise,
                                    const DateTime bound,
-                                   const uint resolution) {
-    const auto& stop_points = raptor.data.pt_data->stop_points;
-    std::vector<georef::vertex_t> predecessors;
-    size_t n = boost::num_vertices(worker.graph);
-    predecessors.resize(n);
-    auto box =
-        find_boundary_box(worker, stop_points, init_dt, raptor, mode, coord_origin, clockwise, bound, duration, speed);
-    auto init_points = init_vertex(worker, stop_points, raptor, mode, coord_origin, clockwise, bound);
-    auto distances = init_distance(worker, stop_points, init_dt, raptor, mode, coord_origin, clockwise, bound, speed);
+                                   const uint resolution,
+                                   const size_t nb_threads) {
+    return build_raster_isochrone(worker, speed, mode, raptor.data.pt_data->stop_points,
+                                  make_stop_point_durations(raptor, init_dt, clockwise, bound), coord_origin, duration,
+                                  resolution, nb_threads, raptor.thread_pool.get());
+}
+
+std::string build_raster_isochrone(const georef::GeoRef& worker,
+                                   const double& speed,
+                                   const type::Mode_e& mode,
+                                   const std::vector<type::StopPoint*>& stop_points,
+                                   const StopPointDurations& sp_durations,
+                                   const type::GeographicalCoord& coord_origin,
+                                   const DateTime duration,
+                                   const uint resolution,
+                                   const size_t nb_threads,
+                                   ThreadPool* thread_pool) {
+    auto box = find_boundary_box(worker, stop_points, sp_durations, mode, coord_origin, duration, speed);
+    auto init_points = init_vertex(worker, stop_points, sp_durations, mode, coord_origin);
+    auto distances = init_distance(worker, stop_points, sp_durations, mode, coord_origin, speed);
     auto start = init_points.begin();
     auto end = init_points.end();
     float speed_factor = float(speed) / georef::default_speed[mode];
-    auto visitor = georef::dijkstra_distance_visitor(navitia::seconds(duration), distances);
+    auto visitor = VertexDurationsVisitor(navitia::seconds(duration), distances);
     auto index_map = boost::identity_property_map();
+    // the colors are sparse too: a vertex not in the map is white (not reached yet)
+    std::unordered_map<georef::vertex_t, boost::default_color_type> colors;
     using filtered_graph = boost::filtered_graph<georef::Graph, boost::keep_all, georef::TransportationModeFilter>;
     try {
         boost::dijkstra_shortest_paths_no_init(
             filtered_graph(worker.graph, {}, georef::TransportationModeFilter(mode, worker)), start, end,
-            &predecessors[0], &distances[0], boost::get(&georef::Edge::duration, worker.graph), index_map,
-            std::less<>(), georef::SpeedDistanceCombiner(speed_factor), navitia::seconds(0), visitor);
+            boost::dummy_property_map(), VertexDurationsMap{&distances},
+            boost::get(&georef::Edge::duration, worker.graph), index_map, std::less<>(),
+            georef::SpeedDistanceCombiner(speed_factor), navitia::seconds(0), visitor,
+            boost::make_assoc_property_map(colors));
     } catch (georef::DestinationFound) {
     }
-    return build_grid(worker, box, distances, speed, duration, resolution);
+    // the grid is computed with the threads kept by the worker
+    return build_grid(worker, box, distances, speed, duration, resolution, nb_threads, thread_pool);
 }
 
 }  // namespace routing
@@ -33,6 +33,8 @@ www.navitia.io
 #include "isochrone.h"
 #include "raptor.h"
 
+#include <unordered_map>
+
 namespace navitia {
 namespace routing {
 
@@ -98,15 +100,35 @@ struct HeatMap {
 constexpr static double N_DEG_TO_DISTANCE =
     type::GeographicalCoord::N_DEG_TO_RAD * type::GeographicalCoord::EARTH_RADIUS_IN_METERS;
 
-std::vector<navitia::time_duration> init_distance(const georef::GeoRef& worker,
-                                                  const std::vector<type::StopPoint*>& stop_points,
-                                                  const DateTime& init_dt,
-                                                  const RAPTOR& raptor,
-                                                  const type::Mode_e& mode,
-                                                  const type::GeographicalCoord& coord_origin,
-                                                  const bool clockwise,
-                                                  const DateTime& bound,
-                                                  const double speed);
+// Durations of the vertices reached by the street network search of a heat map, bt::pos_infin for the others.
+// The search is bounded by the duration of the heat map, so only a small part of the graph is stored.
+struct VertexDurations {
+    std::unordered_map<georef::vertex_t, navitia::time_duration> durations;
+
+    navitia::time_duration operator[](const georef::vertex_t v) const {
+        const auto it = durations.find(v);
+        return it == durations.end() ? navitia::time_duration(bt::pos_infin) : it->second;
+    }
+    void set_min(const georef::vertex_t v, const navitia::time_duration& duration) {
+        auto it = durations.emplace(v, duration).first;
+        it->second = std::min(it->second, duration);
+    }
+};
+
+// Durations of the stop points reached by the public transport search, DateTimeUtils::inf for the others.
+using StopPointDurations = IdxMap<type::StopPoint, DateTime>;
+
+StopPointDurations make_stop_point_durations(const RAPTOR& raptor,
+                                             const DateTime& init_dt,
+                                             const bool clockwise,
+                                             const DateTime& bound);
+
+VertexDurations init_distance(const georef::GeoRef& worker,
+                              const std::vector<type::StopPoint*>& stop_points,
+                              const StopPointDurations& sp_durations,
+                              const type::Mode_e& mode,
+                              const type::GeographicalCoord& coord_origin,
+                              const double speed);
 
 HeatMap fill_heat_map(const BoundBox& box,
                       const double height_step,
@@ -115,9 +137,12 @@ HeatMap fill_heat_map(const BoundBox& box,
                       const double min_dist,
                       const double max_duration,
                       const double speed,
-                      const std::vector<navitia::time_duration>& distances,
-                      const size_t step);
+                      const VertexDurations& distances,
+                      const size_t step,
+                      const size_t nb_threads = 1,
+                      ThreadPool* thread_pool = nullptr);
 
+// The grid is sent as a json string in the heat map response, the response proto has no message for it
 std::string print_grid(const HeatMap& heat_map);
 
 std::string build_raster_isochrone(const georef::GeoRef& worker,
@@ -129,7 +154,20 @@ std::string build_raster_isochrone(const georef::GeoRef& worker,
                                    const DateTime duration,
                                    const bool clockwise,
                                    const DateTime bound,
-                                   const uint resolution);
+                                   const uint resolution,
+                                   const size_t nb_threads = 1);
+
+// Same with the durations of the stop points, e.g. the percentiles of an isochrone profile
+std::string build_raster_isochrone(const georef::GeoRef& worker,
+                                   const double& speed,
+                                   const type::Mode_e& mode,
+                                   const std::vector<type::StopPoint*>& stop_points,
+                                   const StopPointDurations& sp_durations,
+                                   const type::GeographicalCoord& coord_origin,
+                                   const DateTime duration,
+                                   const uint resolution,
+                                   const size_t nb_threads = 1,
+                                   ThreadPool* thread_pool = nullptr);
 
 }  // namespace routing
 }  // namespace navitia
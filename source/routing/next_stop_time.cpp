@@ -40,6 +40,8 @@ www.navitia.io
 #include <boost/range/algorithm/sort.hpp>
 #include <boost/range/algorithm_ext/push_back.hpp>
 
+#include <unordered_map>
+
 namespace navitia {
 namespace routing {
 
@@ -91,15 +93,64 @@ void NextStopTimeData::TimesStopTimes<Getter>::init(const JourneyPattern& jp, co
     }
 }
 
+void NextStopTimeData::FreqIndex::init(const JourneyPattern& jp,
+                                       const JourneyPatternPoint& jpp,
+                                       const StopEvent stop_event) {
+    for (const auto* freq_vj : jp.freq_vjs) {
+        const auto& st = get_corresponding_stop_time(*freq_vj, jpp.order);
+        if (stop_event == StopEvent::pick_up && !st.pick_up_allowed()) {
+            continue;
+        }
+        if (stop_event == StopEvent::drop_off && !st.drop_off_allowed()) {
+            continue;
+        }
+        // the same bounds as get_next_stop_time and get_previous_stop_time
+        const uint32_t considered_time = (stop_event == StopEvent::pick_up) ? st.boarding_time : st.alighting_time;
+        const Interval interval = {DateTimeUtils::hour(freq_vj->start_time + considered_time),
+                                   DateTimeUtils::hour(freq_vj->end_time + considered_time), freq_vj, &st};
+        if (interval.upper < interval.lower) {
+            overnight.push_back(interval);
+        } else {
+            by_lower.push_back(interval);
+        }
+    }
+
+    // stable, so that equal occurrences are given by the first vj of the journey pattern, as before
+    by_upper = by_lower;
+    std::stable_sort(by_lower.begin(), by_lower.end(),
+                     [](const Interval& lhs, const Interval& rhs) { return lhs.lower < rhs.lower; });
+    std::stable_sort(by_upper.begin(), by_upper.end(),
+                     [](const Interval& lhs, const Interval& rhs) { return lhs.upper < rhs.upper; });
+    max_upper.resize(by_lower.size());
+    for (size_t i = 0; i < by_lower.size(); ++i) {
+        max_upper[i] = i == 0 ? by_lower[i].upper : std::max(max_upper[i - 1], by_lower[i].upper);
+    }
+    min_lower.resize(by_upper.size());
+    for (size_t i = by_upper.size(); i-- > 0;) {
+        min_lower[i] = i + 1 == by_upper.size() ? by_upper[i].lower : std::min(min_lower[i + 1], by_upper[i].lower);
+    }
+}
+
 void NextStopTimeData::load(const JourneyPatternContainer& jp_container) {
     departure.assign(jp_container.get_jpps_values());
     arrival.assign(jp_container.get_jpps_values());
+    freq_departure.assign(jp_container.get_jpps_values());
+    freq_arrival.assign(jp_container.get_jpps_values());
 
     for (const auto jp : jp_container.get_jps()) {
         for (const auto& jpp_idx : jp.second.jpps) {
             const auto& jpp = jp_container.get(jpp_idx);
             departure[jpp_idx].init(jp.second, jpp);
             arrival[jpp_idx].init(jp.second, jpp);
+            if (jp.second.freq_vjs.empty()) {
+                continue;
+            }
+            auto freq_dep = std::make_shared<FreqIndex>();
+            freq_dep->init(jp.second, jpp, StopEvent::pick_up);
+            freq_departure[jpp_idx] = std::move(freq_dep);
+            auto freq_arr = std::make_shared<FreqIndex>();
+            freq_arr->init(jp.second, jpp, StopEvent::drop_off);
+            freq_arrival[jpp_idx] = std::move(freq_arr);
         }
     }
 }
@@ -156,32 +207,43 @@ static std::pair<const type::StopTime*, DateTime> next_valid_frequency(const Sto
                                                                        const type::RTLevel rt_level,
                                                                        const type::VehicleProperties& vehicle_props,
                                                                        const DateTime bound) {
-    // to find the next frequency VJ, for the moment we loop through all frequency VJ of the JP
-    // and for each jp, get compute the datetime on the jpp
-    const auto& jpp = dataRaptor.jp_container.get(jpp_idx);
-    const auto& jp = dataRaptor.jp_container.get(jpp.jp_idx);
+    using Interval = NextStopTimeData::FreqIndex::Interval;
     std::pair<const type::StopTime*, DateTime> best = {nullptr, DateTimeUtils::inf};
+    const auto* index = dataRaptor.next_stop_time_data.freq_index(jpp_idx, stop_event);
+    if (index == nullptr) {
+        return best;
+    }
     auto base_dt = dt;
+    // true if the vj has an occurrence after base_dt (even if it doesn't improve best)
+    const auto check = [&](const Interval& interval) {
+        if (!interval.vj->accessible(vehicle_props)) {
+            return false;
+        }
+        const auto next_dt = get_next_stop_time(stop_event, base_dt, *interval.vj, *interval.st, rt_level);
+        if (next_dt < best.second && next_dt <= bound) {
+            best = {interval.st, next_dt};
+        }
+        return next_dt != DateTimeUtils::inf;
+    };
 
     while (best.first == nullptr && base_dt <= bound) {
-        for (const auto& freq_vj : jp.freq_vjs) {
-            const auto& st = get_corresponding_stop_time(*freq_vj, jpp.order);
-
-            if (!freq_vj->accessible(vehicle_props)) {
-                continue;
-            }
-            if (stop_event == StopEvent::pick_up && !st.pick_up_allowed()) {
-                continue;
-            }
-            if (stop_event == StopEvent::drop_off && !st.drop_off_allowed()) {
-                continue;
-            }
-
-            const auto next_dt = get_next_stop_time(stop_event, base_dt, *freq_vj, st, rt_level);
-            if (next_dt < best.second && next_dt <= bound) {
-                best = {&st, next_dt};
+        const auto hour = DateTimeUtils::hour(base_dt);
+        const auto& by_lower = index->by_lower;
+        const auto first_after = std::lower_bound(by_lower.begin(), by_lower.end(), hour,
+                                                  [](const Interval& i, const DateTime h) { return i.lower < h; });
+        // the vjs starting after hour: their next occurrence is their first one, the first valid is the best
+        for (auto it = first_after; it != by_lower.end(); ++it) {
+            if (check(*it)) {
+                break;
             }
         }
+        // the vjs running at hour: the max of upper of the previous ones stops the search
+        for (size_t i = first_after - by_lower.begin(); i-- > 0 && index->max_upper[i] >= hour;) {
+            check(by_lower[i]);
+        }
+        for (const auto& interval : index->overnight) {
+            check(interval);
+        }
         base_dt = DateTimeUtils::set(DateTimeUtils::date(base_dt) + 1, 0);
     }
 
@@ -195,34 +257,46 @@ static std::pair<const type::StopTime*, DateTime> previous_valid_frequency(const
                                                                            const type::RTLevel rt_level,
                                                                            const type::VehicleProperties& vehicle_props,
                                                                            const DateTime bound) {
-    const auto& jpp = dataRaptor.jp_container.get(jpp_idx);
-    const auto& jp = dataRaptor.jp_container.get(jpp.jp_idx);
+    using Interval = NextStopTimeData::FreqIndex::Interval;
     std::pair<const type::StopTime*, DateTime> best = {nullptr, DateTimeUtils::not_valid};
+    const auto* index = dataRaptor.next_stop_time_data.freq_index(jpp_idx, stop_event);
+    if (index == nullptr) {
+        return best;
+    }
     auto base_dt = dt;
+    // true if the vj has an occurrence before base_dt (even if it doesn't improve best)
+    const auto check = [&](const Interval& interval) {
+        if (!interval.vj->accessible(vehicle_props)) {
+            return false;
+        }
+        const auto previous_dt = get_previous_stop_time(stop_event, base_dt, *interval.vj, *interval.st, rt_level);
+        if (previous_dt == DateTimeUtils::not_valid) {
+            return false;
+        }
+        if (previous_dt >= bound && (best.second == DateTimeUtils::not_valid || previous_dt > best.second)) {
+            best = {interval.st, previous_dt};
+        }
+        return true;
+    };
 
     while (best.first == nullptr && base_dt >= bound) {
-        for (const auto& freq_vj : jp.freq_vjs) {
-            const auto& st = get_corresponding_stop_time(*freq_vj, jpp.order);
-
-            if (!freq_vj->accessible(vehicle_props)) {
-                continue;
-            }
-            if (stop_event == StopEvent::pick_up && !st.pick_up_allowed()) {
-                continue;
-            }
-            if (stop_event == StopEvent::drop_off && !st.drop_off_allowed()) {
-                continue;
-            }
-
-            const auto previous_dt = get_previous_stop_time(stop_event, base_dt, *freq_vj, st, rt_level);
-
-            if (previous_dt == DateTimeUtils::not_valid || previous_dt < bound) {
-                continue;
-            }
-            if (best.second == DateTimeUtils::not_valid || previous_dt > best.second) {
-                best = {&st, previous_dt};
+        const auto hour = DateTimeUtils::hour(base_dt);
+        const auto& by_upper = index->by_upper;
+        const auto first_after = std::upper_bound(by_upper.begin(), by_upper.end(), hour,
+                                                  [](const DateTime h, const Interval& i) { return h < i.upper; });
+        // the vjs ended before hour: their previous occurrence is their upper, the last valid is the best
+        for (size_t i = first_after - by_upper.begin(); i-- > 0;) {
+            if (check(by_upper[i])) {
+                break;
             }
         }
+        // the vjs running at hour: the min of lower of the next ones stops the search
+        for (size_t i = first_after - by_upper.begin(); i < by_upper.size() && index->min_lower[i] <= hour; ++i) {
+            check(by_upper[i]);
+        }
+        for (const auto& interval : index->overnight) {
+            check(interval);
+        }
         auto date = DateTimeUtils::date(base_dt);
         if (date == 0) {
             return best;
@@ -330,47 +404,18 @@ std::pair<const type::StopTime*, DateTime> NextStopTime::tardiest_stop_time(
     return first_discrete_st_pair;
 }
 
-/*
- * Discrete VJs and Frequency VJs are looped differently when computing the next stop time
- *
- * For Frequency VJs, we need to loop over its active period since several vjs are instantiated actually
- *
- * For Discrete VJs, there is no need to do that, because we get only one VJ.
- *
- * */
-template <typename F>
-static void vj_loop(const nt::DiscreteVehicleJourney* /*unused*/, F f) {
-    f(0);
-}
-
-template <typename F>
-static void vj_loop(const nt::FrequencyVehicleJourney* vj, F f) {
-    int start_time = vj->start_time;
-    int end_time = vj->end_time;
-    // start date is relative to the production begin date
-    // end_time may be smaller than start_time because of the UTC conversion
-    if (vj->start_time > vj->end_time) {
-        // In this case, the vj passes midnight
-        end_time += static_cast<int>(DateTimeUtils::SECONDS_PER_DAY);
-    }
-    for (auto freq_shift = start_time; freq_shift <= end_time; freq_shift += vj->headway_secs) {
-        f(freq_shift);
-    }
-}
-
-template <typename VJ_T>
 static void fill_cache(const DateTime from,
                        const DateTime to,
                        const type::RTLevel rt_level,
                        const type::AccessibiliteParams& accessibilite_params,
-                       const JourneyPattern& jp,
-                       const std::vector<const VJ_T*>& vjs,
-                       IdxMap<JourneyPatternPoint, std::vector<CachedNextStopTime::DtSt>>& arrival_cache,
-                       IdxMap<JourneyPatternPoint, std::vector<CachedNextStopTime::DtSt>>& departure_cache) {
+                       const std::vector<const nt::DiscreteVehicleJourney*>& vjs,
+                       std::vector<JpCachedNextStopTime::vDtVj>& arrival_cache,
+                       std::vector<JpCachedNextStopTime::vDtVj>& departure_cache) {
     const auto to_int = static_cast<int>(DateTimeUtils::date(to));
     // In case of Vj that passes midnight, we should compute one day before "from"
     const int from_int = std::max(static_cast<int>(DateTimeUtils::date(from)) - 1, 0);
-    for (const auto* vj : vjs) {
+    for (uint32_t vj_rank = 0; vj_rank < vjs.size(); ++vj_rank) {
+        const auto* vj = vjs[vj_rank];
         if (!vj->accessible(accessibilite_params.vehicle_properties)) {
             continue;
         }
@@ -381,31 +426,119 @@ static void fill_cache(const DateTime from,
                 continue;
             }
             const auto shift = navitia::DateTimeUtils::SECONDS_PER_DAY * day;
-            RankJourneyPatternPoint i{0};
+            size_t i = 0;
             for (const auto& st : vj->stop_time_list) {
-                auto jpp_idx = jp.get_jpp_idx(i);
-                auto loop_impl = [&](long freq_shift) {
-                    if (st.drop_off_allowed()) {
-                        auto arrival_time = st.alighting_time + shift + freq_shift;
-                        if (from <= arrival_time && arrival_time <= to) {
-                            arrival_cache[jpp_idx].emplace_back(arrival_time, &st);
-                        }
+                if (st.drop_off_allowed()) {
+                    auto arrival_time = st.alighting_time + shift;
+                    if (from <= arrival_time && arrival_time <= to) {
+                        arrival_cache[i].push_back({DateTime(arrival_time), vj_rank});
                     }
-                    if (st.pick_up_allowed()) {
-                        auto departure_time = st.boarding_time + shift + freq_shift;
-                        if (departure_time <= to && from <= departure_time) {
-                            departure_cache[jpp_idx].emplace_back(departure_time, &st);
-                        }
+                }
+                if (st.pick_up_allowed()) {
+                    auto departure_time = st.boarding_time + shift;
+                    if (departure_time <= to && from <= departure_time) {
+                        departure_cache[i].push_back({DateTime(departure_time), vj_rank});
                     }
-                };
-                // loop is done differently according to the type of Vehicle Journey
-                vj_loop(vj, loop_impl);
+                }
                 ++i;
             }
         }
     }
 }
 
+/*
+ * A frequency vj runs every headway_secs between start_time and end_time.
+ * Instead of enumerating these occurrences, one FreqBlock is stored by vj,
+ * day and stop time, restricted to the occurrences in [from, to]
+ */
+static void fill_freq_cache(const DateTime from,
+                            const DateTime to,
+                            const type::RTLevel rt_level,
+                            const type::AccessibiliteParams& accessibilite_params,
+                            const std::vector<const nt::FrequencyVehicleJourney*>& vjs,
+                            std::vector<JpCachedNextStopTime::vFreqBlock>& arrival_cache,
+                            std::vector<JpCachedNextStopTime::vFreqBlock>& departure_cache) {
+    const auto to_int = static_cast<int>(DateTimeUtils::date(to));
+    // In case of Vj that passes midnight, we should compute one day before "from"
+    const int from_int = std::max(static_cast<int>(DateTimeUtils::date(from)) - 1, 0);
+    for (uint32_t vj_rank = 0; vj_rank < vjs.size(); ++vj_rank) {
+        const auto* vj = vjs[vj_rank];
+        if (!vj->accessible(accessibilite_params.vehicle_properties)) {
+            continue;
+        }
+        const int64_t headway = vj->headway_secs;
+        const int64_t start_time = vj->start_time;
+        int64_t end_time = vj->end_time;
+        // end_time may be smaller than start_time because of the UTC conversion
+        if (vj->start_time > vj->end_time) {
+            // In this case, the vj passes midnight
+            end_time += DateTimeUtils::SECONDS_PER_DAY;
+        }
+        const auto add_block = [&](const int64_t first, const int64_t last, JpCachedNextStopTime::vFreqBlock& cache) {
+            // the occurrences are first + k * headway, keep the ones in [from, to]
+            int64_t begin = first;
+            if (begin < int64_t(from)) {
+                begin += (int64_t(from) - begin + headway - 1) / headway * headway;
+            }
+            const int64_t end = std::min(last, int64_t(to));
+            if (end < begin) {
+                return;
+            }
+            const auto last_occurrence = begin + (end - begin) / headway * headway;
+            cache.push_back({DateTime(begin), DateTime(last_occurrence), uint32_t(headway), vj_rank, 0});
+        };
+        // test validity pattern of vj
+        const auto* vp = vj->validity_patterns[rt_level];
+        for (int day = from_int; day <= to_int; ++day) {
+            if (!vp->check(day)) {
+                continue;
+            }
+            const int64_t shift = navitia::DateTimeUtils::SECONDS_PER_DAY * day;
+            size_t i = 0;
+            for (const auto& st : vj->stop_time_list) {
+                if (st.drop_off_allowed()) {
+                    const int64_t arrival_time = st.alighting_time + shift;
+                    add_block(arrival_time + start_time, arrival_time + end_time, arrival_cache[i]);
+                }
+                if (st.pick_up_allowed()) {
+                    const int64_t departure_time = st.boarding_time + shift;
+                    add_block(departure_time + start_time, departure_time + end_time, departure_cache[i]);
+                }
+                ++i;
+            }
+        }
+    }
+}
+
+static std::shared_ptr<const JpCachedNextStopTime> make_jp_cache(const CachedNextStopTimeKey& key,
+                                                                 const JourneyPattern& jp,
+                                                                 const size_t signature) {
+    std::vector<JpCachedNextStopTime::vDtVj> departure(jp.jpps.size()), arrival(jp.jpps.size());
+    std::vector<JpCachedNextStopTime::vFreqBlock> freq_departure, freq_arrival;
+    DateTime dt_from = DateTimeUtils::set(key.from, 0);
+    DateTime dt_to = DateTimeUtils::set(key.from + 2, 0);  // cache window is 2-days wide (journeys : 24h max)
+
+    // a journey pattern has either discrete or frequency vjs, see get_vj()
+    fill_cache(dt_from, dt_to, key.rt_level, key.accessibilite_params, jp.discrete_vjs, arrival, departure);
+    if (!jp.freq_vjs.empty()) {
+        freq_departure.resize(jp.jpps.size());
+        freq_arrival.resize(jp.jpps.size());
+        fill_freq_cache(dt_from, dt_to, key.rt_level, key.accessibilite_params, jp.freq_vjs, freq_arrival,
+                        freq_departure);
+    }
+
+    return std::make_shared<JpCachedNextStopTime>(key, jp, signature, departure, arrival, freq_departure,
+                                                  freq_arrival);
+}
+
+// the ranks come from a cache that may have been built by a previous Data generation, hence the bound checks
+static const type::VehicleJourney& get_vj(const JourneyPattern& jp, const uint32_t vj_rank) {
+    if (jp.discrete_vjs.empty()) {
+        return *jp.freq_vjs.at(vj_rank);
+    }
+    return *jp.discrete_vjs.at(vj_rank);
+}
+
 bool CachedNextStopTimeKey::operator<(const CachedNextStopTimeKey& other) const {
     if (from != other.from) {
         return from < other.from;
@@ -416,66 +549,309 @@ bool CachedNextStopTimeKey::operator<(const CachedNextStopTimeKey& other) const
     return accessibilite_params < other.accessibilite_params;
 }
 
+std::shared_ptr<const JpCaches> CachedNextStopTimeManager::Generation::get(const CachedNextStopTimeKey& key) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = jp_caches.find(key);
+    if (it == jp_caches.end()) {
+        return nullptr;
+    }
+    return it->second.lock();
+}
+
 CachedNextStopTime CachedNextStopTimeManager::CacheCreator::operator()(const CachedNextStopTimeKey& key) const {
-    CachedNextStopTime::vDtStByJpp departure, arrival;
     const auto& jp_container = dataRaptor.jp_container;
+    auto jp_caches = std::make_shared<JpCaches>(key, jp_container.nb_jps());
 
-    departure.assign(jp_container.get_jpps_values());
-    arrival.assign(jp_container.get_jpps_values());
-    DateTime dt_from = DateTimeUtils::set(key.from, 0);
-    DateTime dt_to = DateTimeUtils::set(key.from + 2, 0);  // cache window is 2-days wide (journeys : 24h max)
+    std::shared_ptr<const Generation> previous_generation;
+    {
+        std::lock_guard<std::mutex> lock(generation->mutex);
+        previous_generation = generation->previous;
+    }
+    const auto previous = previous_generation ? previous_generation->get(key) : nullptr;
+    if (previous) {
+        // the caches already built by the previous Data generation, by signature
+        std::unordered_multimap<size_t, std::shared_ptr<const JpCachedNextStopTime>> previous_jp_caches;
+        for (JpIdx jp_idx = JpIdx(0); jp_idx.val < previous->nb_jps(); ++jp_idx.val) {
+            if (auto jp_cache = previous->get_if_built(jp_idx)) {
+                previous_jp_caches.emplace(jp_cache->signature, std::move(jp_cache));
+            }
+        }
+        for (const auto jp : jp_container.get_jps()) {
+            const auto range = previous_jp_caches.equal_range(dataRaptor.jp_signatures[jp.first]);
+            for (auto it = range.first; it != range.second; ++it) {
+                // a signature match alone could be a hash collision
+                if (it->second->is_built_from(key, jp.second)) {
+                    jp_caches->share(jp.first, it->second);
+                    break;
+                }
+            }
+        }
+        auto logger = log4cplus::Logger::getInstance("log");
+        LOG4CPLUS_DEBUG(logger, "raptor cache warmup: " << jp_caches->nb_built() << " / " << previous->nb_built()
+                                                        << " journey patterns shared with the previous data");
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(generation->mutex);
+        // forget the caches evicted from the lru
+        for (auto it = generation->jp_caches.begin(); it != generation->jp_caches.end();) {
+            if (it->second.expired()) {
+                it = generation->jp_caches.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        generation->jp_caches[key] = jp_caches;
+    }
+    return {dataRaptor, jp_caches};
+}
+
+JpCaches::JpCaches(const CachedNextStopTimeKey& key, const size_t nb_jps)
+    : key(key), jp_caches(nb_jps), owned_jp_caches(nb_jps) {
+    for (auto& jp_cache : jp_caches) {
+        jp_cache.store(nullptr, std::memory_order_relaxed);
+    }
+}
 
-    for (const auto& jp : jp_container.get_jps_values()) {
-        fill_cache(dt_from, dt_to, key.rt_level, key.accessibilite_params, jp, jp.discrete_vjs, arrival, departure);
-        fill_cache(dt_from, dt_to, key.rt_level, key.accessibilite_params, jp, jp.freq_vjs, arrival, departure);
+const JpCachedNextStopTime& JpCaches::get(const dataRAPTOR& dataRaptor, const JpIdx& jp_idx) const {
+    if (const auto* jp_cache = jp_caches[jp_idx.val].load(std::memory_order_acquire)) {
+        return *jp_cache;
     }
-    auto compare = [](const CachedNextStopTime::DtSt& lhs, const CachedNextStopTime::DtSt& rhs) noexcept {
-        return lhs.first < rhs.first;
+    // built without holding the lock, so that the other journey patterns can be built meanwhile
+    const auto& jp = dataRaptor.jp_container.get(jp_idx);
+    return publish(jp_idx, make_jp_cache(key, jp, dataRaptor.jp_signatures[jp_idx]));
+}
+
+std::shared_ptr<const JpCachedNextStopTime> JpCaches::get_if_built(const JpIdx& jp_idx) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return owned_jp_caches[jp_idx.val];
+}
+
+void JpCaches::share(const JpIdx& jp_idx, std::shared_ptr<const JpCachedNextStopTime> jp_cache) const {
+    publish(jp_idx, std::move(jp_cache));
+}
+
+const JpCachedNextStopTime& JpCaches::publish(const JpIdx& jp_idx,
+                                              std::shared_ptr<const JpCachedNextStopTime> jp_cache) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (const auto* existing = jp_caches[jp_idx.val].load(std::memory_order_relaxed)) {
+        // another thread was faster
+        return *existing;
+    }
+    const auto* res = jp_cache.get();
+    memory += res->memory_usage();
+    ++nb_jp_caches;
+    owned_jp_caches[jp_idx.val] = std::move(jp_cache);
+    jp_caches[jp_idx.val].store(res, std::memory_order_release);
+    return *res;
+}
+
+bool JpCachedNextStopTime::Source::StTimes::operator==(const StTimes& other) const {
+    return boarding_time == other.boarding_time && alighting_time == other.alighting_time
+           && pick_up_allowed == other.pick_up_allowed && drop_off_allowed == other.drop_off_allowed;
+}
+
+bool JpCachedNextStopTime::Source::Vj::operator==(const Vj& other) const {
+    return idx == other.idx && days == other.days && start_time == other.start_time && end_time == other.end_time
+           && headway_secs == other.headway_secs;
+}
+
+JpCachedNextStopTime::Source::Source(const CachedNextStopTimeKey& key, const JourneyPattern& jp)
+    : nb_jpps(jp.jpps.size()) {
+    // the days read by fill_cache and fill_freq_cache
+    const int from_int = std::max(static_cast<int>(key.from) - 1, 0);
+    const int to_int = static_cast<int>(key.from) + 2;
+    const auto add_vj = [&](const nt::VehicleJourney& vj, const uint32_t start_time, const uint32_t end_time,
+                            const uint32_t headway_secs) {
+        uint8_t days = 0;
+        if (vj.accessible(key.accessibilite_params.vehicle_properties)) {
+            const auto* vp = vj.validity_patterns[key.rt_level];
+            for (int day = from_int; day <= to_int; ++day) {
+                if (vp->check(day)) {
+                    days |= uint8_t(1) << (day - from_int);
+                }
+            }
+        }
+        vjs.push_back({vj.idx, days, start_time, end_time, headway_secs});
+        for (const auto& st : vj.stop_time_list) {
+            stop_times.push_back({st.boarding_time, st.alighting_time, st.pick_up_allowed(), st.drop_off_allowed()});
+        }
     };
-    for (const auto jpp_dtst : arrival) {
-        boost::sort(jpp_dtst.second, compare);
+    vjs.reserve(jp.discrete_vjs.size() + jp.freq_vjs.size());
+    stop_times.reserve(vjs.capacity() * nb_jpps);
+    for (const auto* vj : jp.discrete_vjs) {
+        add_vj(*vj, 0, 0, 0);
+    }
+    for (const auto* vj : jp.freq_vjs) {
+        add_vj(*vj, vj->start_time, vj->end_time, vj->headway_secs);
     }
-    for (const auto jpp_dtst : departure) {
-        boost::sort(jpp_dtst.second, compare);
+}
+
+bool JpCachedNextStopTime::Source::operator==(const Source& other) const {
+    return nb_jpps == other.nb_jpps && vjs == other.vjs && stop_times == other.stop_times;
+}
+
+size_t JpCachedNextStopTime::Source::memory_usage() const {
+    return vjs.capacity() * sizeof(Vj) + stop_times.capacity() * sizeof(StTimes);
+}
+
+JpCachedNextStopTime::JpCachedNextStopTime(const CachedNextStopTimeKey& key,
+                                           const JourneyPattern& jp,
+                                           size_t signature,
+                                           std::vector<vDtVj>& departure,
+                                           std::vector<vDtVj>& arrival,
+                                           std::vector<vFreqBlock>& freq_departure,
+                                           std::vector<vFreqBlock>& freq_arrival)
+    : signature(signature),
+      source(key, jp),
+      departure(departure),
+      arrival(arrival),
+      freq_departure(freq_departure),
+      freq_arrival(freq_arrival) {}
+
+size_t JpCachedNextStopTime::memory_usage() const {
+    return sizeof(JpCachedNextStopTime) + source.memory_usage() + departure.memory_usage() + arrival.memory_usage()
+           + freq_departure.memory_usage() + freq_arrival.memory_usage();
+}
+
+bool JpCachedNextStopTime::is_built_from(const CachedNextStopTimeKey& key, const JourneyPattern& jp) const {
+    return source == Source(key, jp);
+}
+
+static void finalize_sorted(std::vector<JpCachedNextStopTime::DtVj>& /*unused*/) {}
+
+static void finalize_sorted(std::vector<JpCachedNextStopTime::FreqBlock>& blocks) {
+    DateTime max_last = 0;
+    for (auto& block : blocks) {
+        max_last = std::max(max_last, block.last);
+        block.max_last = max_last;
     }
-    return {departure, arrival};
 }
 
-CachedNextStopTime::DtStFromJpp::DtStFromJpp(const vDtStByJpp& map) {
+template <typename T>
+JpCachedNextStopTime::ByRank<T>::ByRank(std::vector<std::vector<T>>& by_rank) {
+    auto compare = [](const T& lhs, const T& rhs) noexcept { return lhs.dt < rhs.dt; };
     size_t s = 0;
-    for (const auto elt : map) {
-        s += elt.second.size();
+    for (auto& v : by_rank) {
+        boost::sort(v, compare);
+        finalize_sorted(v);
+        s += v.size();
     }
-    dtsts.reserve(s);
-    until.assign(map, 0);
-    for (const auto elt : map) {
-        boost::push_back(dtsts, elt.second);
-        until[elt.first] = dtsts.size();
+    elts.reserve(s);
+    until.reserve(by_rank.size());
+    for (const auto& v : by_rank) {
+        boost::push_back(elts, v);
+        until.push_back(elts.size());
+    }
+}
+
+template <typename T>
+boost::iterator_range<typename std::vector<T>::const_iterator> JpCachedNextStopTime::ByRank<T>::operator[](
+    const RankJourneyPatternPoint& order) const {
+    if (order.val >= until.size()) {
+        return boost::make_iterator_range(elts.end(), elts.end());
     }
-    dtsts.shrink_to_fit();
+    const auto from = order.val == 0 ? 0 : until[order.val - 1];
+    const auto begin = elts.begin();
+    return boost::make_iterator_range(begin + from, begin + until[order.val]);
 }
 
-boost::iterator_range<CachedNextStopTime::vDtSt::const_iterator> CachedNextStopTime::DtStFromJpp::operator[](
-    const JppIdx& jpp_idx) const {
-    const auto from = jpp_idx.val == 0 ? 0 : until[JppIdx(jpp_idx.val - 1)];
-    const auto begin = dtsts.begin();
-    return boost::make_iterator_range(begin + from, begin + until[jpp_idx]);
+template <typename T>
+size_t JpCachedNextStopTime::ByRank<T>::memory_usage() const {
+    return elts.capacity() * sizeof(T) + until.capacity() * sizeof(uint32_t);
+}
+
+template struct JpCachedNextStopTime::ByRank<JpCachedNextStopTime::DtVj>;
+template struct JpCachedNextStopTime::ByRank<JpCachedNextStopTime::FreqBlock>;
+
+using FreqBlockRange = boost::iterator_range<JpCachedNextStopTime::vFreqBlock::const_iterator>;
+
+/*
+ * The blocks are sorted by first occurrence: the first block starting at or
+ * after dt is found by binary search, then the blocks started before dt are
+ * looked at while one of them can still be running (see FreqBlock::max_last)
+ *
+ * Worst case: max_last never decreases, so a block started early and running
+ * after dt (a vj running all day) keeps the scan going back to the first block
+ * of the jpp, the lookup is then linear in the number of blocks started before dt.
+ * The blocks of a jpp are one by vj and by day of the cache, so it stays small.
+ */
+static std::pair<const JpCachedNextStopTime::FreqBlock*, DateTime> next_freq_occurrence(const FreqBlockRange& blocks,
+                                                                                        const DateTime dt) {
+    std::pair<const JpCachedNextStopTime::FreqBlock*, DateTime> best = {nullptr, DateTimeUtils::inf};
+    const auto it = std::lower_bound(blocks.begin(), blocks.end(), dt,
+                                     [](const JpCachedNextStopTime::FreqBlock& b, DateTime d) { return b.dt < d; });
+    if (it != blocks.end()) {
+        best = {&*it, it->dt};
+    }
+    const auto rend = std::make_reverse_iterator(blocks.begin());
+    for (auto rit = std::make_reverse_iterator(it); rit != rend && rit->max_last >= dt; ++rit) {
+        if (rit->last < dt) {
+            continue;
+        }
+        const auto next = rit->dt + (dt - rit->dt + rit->headway - 1) / rit->headway * rit->headway;
+        if (next < best.second) {
+            best = {&*rit, next};
+        }
+    }
+    return best;
+}
+
+/*
+ * The blocks started at or before dt are looked at from the latest one, until
+ * no block left can end after the best occurrence found (see FreqBlock::max_last)
+ *
+ * Same worst case as next_freq_occurrence: an early block running until dt keeps
+ * max_last above any occurrence found, every block started before dt is then visited.
+ */
+static std::pair<const JpCachedNextStopTime::FreqBlock*, DateTime> previous_freq_occurrence(
+    const FreqBlockRange& blocks,
+    const DateTime dt) {
+    std::pair<const JpCachedNextStopTime::FreqBlock*, DateTime> best = {nullptr, 0};
+    // the blocks that started at or before dt
+    const auto it = std::upper_bound(blocks.begin(), blocks.end(), dt,
+                                     [](DateTime d, const JpCachedNextStopTime::FreqBlock& b) { return d < b.dt; });
+    const auto rend = std::make_reverse_iterator(blocks.begin());
+    for (auto rit = std::make_reverse_iterator(it); rit != rend; ++rit) {
+        if (best.first && rit->max_last <= best.second) {
+            // no block from here can have an occurrence later than the best one
+            break;
+        }
+        const auto previous =
+            rit->last <= dt ? rit->last : rit->dt + (dt - rit->dt) / rit->headway * rit->headway;
+        if (!best.first || previous > best.second) {
+            best = {&*rit, previous};
+        }
+    }
+    return best;
 }
 
 std::pair<const type::StopTime*, DateTime> CachedNextStopTime::next_stop_time(const StopEvent stop_event,
                                                                               const JppIdx jpp_idx,
                                                                               const DateTime dt,
                                                                               const bool clockwise) const {
-    const auto& v = (stop_event == StopEvent::pick_up ? departure[jpp_idx] : arrival[jpp_idx]);
-    const type::StopTime* null_st = nullptr;
+    const auto& jpp = dataRaptor.jp_container.get(jpp_idx);
+    const auto& jp_cache = jp_caches->get(dataRaptor, jpp.jp_idx);
+    const auto& jp = dataRaptor.jp_container.get(jpp.jp_idx);
+    if (!jp.freq_vjs.empty()) {
+        const auto blocks =
+            (stop_event == StopEvent::pick_up ? jp_cache.freq_departure[jpp.order] : jp_cache.freq_arrival[jpp.order]);
+        const auto found = clockwise ? next_freq_occurrence(blocks, dt) : previous_freq_occurrence(blocks, dt);
+        if (found.first) {
+            const auto& vj = get_vj(jp, found.first->vj_rank);
+            return {&get_corresponding_stop_time(vj, jpp.order), found.second};
+        }
+        return {nullptr, 0};
+    }
+    const auto v = (stop_event == StopEvent::pick_up ? jp_cache.departure[jpp.order] : jp_cache.arrival[jpp.order]);
     decltype(v.begin()) search;
-    auto cmp = [](const CachedNextStopTime::DtSt& a, const CachedNextStopTime::DtSt& b) noexcept {
-        return a.first < b.first;
+    auto cmp = [](const JpCachedNextStopTime::DtVj& a, const JpCachedNextStopTime::DtVj& b) noexcept {
+        return a.dt < b.dt;
     };
     if (clockwise) {
-        search = boost::lower_bound(v, std::make_pair(dt, null_st), cmp);
+        search = boost::lower_bound(v, JpCachedNextStopTime::DtVj{dt, 0}, cmp);
     } else {
-        search = boost::upper_bound(v, std::make_pair(dt, null_st), cmp);
+        search = boost::upper_bound(v, JpCachedNextStopTime::DtVj{dt, 0}, cmp);
         if (search == v.begin()) {
             search = v.end();
         } else if (!v.empty()) {
@@ -483,14 +859,17 @@ std::pair<const type::StopTime*, DateTime> CachedNextStopTime::next_stop_time(co
         }
     }
     if (search != v.end()) {
-        return {search->second, search->first};
+        const auto& vj = get_vj(jp, search->vj_rank);
+        return {&get_corresponding_stop_time(vj, jpp.order), search->dt};
     }
     return {nullptr, 0};
 }
 
 CachedNextStopTimeManager::~CachedNextStopTimeManager() {
     auto logger = log4cplus::Logger::getInstance("log");
-    LOG4CPLUS_INFO(logger, "Cache miss : " << lru.get_nb_cache_miss() << " / " << lru.get_nb_calls());
+    LOG4CPLUS_INFO(logger, "Cache miss : " << lru.get_nb_cache_miss() << " / " << lru.get_nb_calls()
+                                            << ", memory used: " << memory_usage() << " bytes");
+    log_memory_usage();
 }
 
 std::shared_ptr<const CachedNextStopTime> CachedNextStopTimeManager::load(
@@ -501,6 +880,47 @@ std::shared_ptr<const CachedNextStopTime> CachedNextStopTimeManager::load(
     return lru(key);
 }
 
+std::vector<std::shared_ptr<const JpCaches>> CachedNextStopTimeManager::Generation::alive() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::shared_ptr<const JpCaches>> res;
+    for (const auto& key_jp_caches : jp_caches) {
+        if (auto caches = key_jp_caches.second.lock()) {
+            res.push_back(std::move(caches));
+        }
+    }
+    return res;
+}
+
+size_t CachedNextStopTimeManager::memory_usage() const {
+    size_t res = 0;
+    for (const auto& jp_caches : generation->alive()) {
+        res += jp_caches->memory_usage();
+    }
+    return res;
+}
+
+void CachedNextStopTimeManager::log_memory_usage() const {
+    // logged out of the generation lock, the cache creation needs it
+    auto logger = log4cplus::Logger::getInstance("log");
+    for (const auto& jp_caches : generation->alive()) {
+        LOG4CPLUS_DEBUG(logger, "raptor cache of day " << jp_caches->key.from << ": " << jp_caches->nb_built()
+                                                       << " journey patterns, " << jp_caches->memory_usage()
+                                                       << " bytes");
+    }
+}
+
+void CachedNextStopTimeManager::warmup(const CachedNextStopTimeManager& other) {
+    {
+        std::lock_guard<std::mutex> lock(generation->mutex);
+        generation->previous = other.generation;
+    }
+    lru.warmup(other.lru);
+    {
+        std::lock_guard<std::mutex> lock(generation->mutex);
+        generation->previous.reset();
+    }
+}
+
 inline static bool within(u_int32_t val, std::pair<u_int32_t, u_int32_t> bound) {
     return val >= bound.first && val <= bound.second;
 }
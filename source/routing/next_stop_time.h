@@ -32,6 +32,7 @@ www.navitia.io
 
 #include "routing/stop_event.h"
 #include "routing/raptor_utils.h"
+#include "routing/journey_pattern_container.h"
 #include "utils/idx_map.h"
 #include "utils/lru.h"
 #include "type/rt_level.h"
@@ -45,6 +46,11 @@ www.navitia.io
 #include <boost/optional.hpp>
 #include <boost/dynamic_bitset.hpp>
 
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+
 namespace navitia {
 
 namespace type {
@@ -57,7 +63,6 @@ struct AccessibiliteParams;
 
 namespace routing {
 
-struct JourneyPatternContainer;
 struct dataRAPTOR;
 
 struct NextStopTimeData {
@@ -103,6 +108,33 @@ struct NextStopTimeData {
         }
     }
 
+    // The frequency vjs of a jpp indexed by the interval [lower, upper] of their occurrences in the day
+    // (see get_next_stop_time), so that the next and previous occurrences are found with a binary search
+    // instead of a loop on every vj of the journey pattern.
+    struct FreqIndex {
+        struct Interval {
+            DateTime lower;  // first occurrence
+            DateTime upper;  // end of the occurrences
+            const type::FrequencyVehicleJourney* vj;
+            const type::StopTime* st;
+        };
+        // sorted by lower, max_upper[i] is the max of upper over by_lower[0..i]
+        std::vector<Interval> by_lower;
+        std::vector<DateTime> max_upper;
+        // sorted by upper, min_lower[i] is the min of lower over by_upper[i..]
+        std::vector<Interval> by_upper;
+        std::vector<DateTime> min_lower;
+        // the vjs running over midnight (upper < lower), always checked
+        std::vector<Interval> overnight;
+
+        void init(const JourneyPattern& jp, const JourneyPatternPoint& jpp, const StopEvent stop_event);
+    };
+    // nullptr if the journey pattern has no frequency vj
+    inline const FreqIndex* freq_index(const JppIdx jpp_idx, const StopEvent stop_event) const {
+        const auto& index = stop_event == StopEvent::pick_up ? freq_departure[jpp_idx] : freq_arrival[jpp_idx];
+        return index.get();
+    }
+
 private:
     struct Departure {
         DateTime get_time(const type::StopTime& st) const;
@@ -145,6 +177,9 @@ private:
     };
     IdxMap<JourneyPatternPoint, TimesStopTimes<Departure>> departure;
     IdxMap<JourneyPatternPoint, TimesStopTimes<Arrival>> arrival;
+    // only allocated for the jpps of the journey patterns with frequency vjs
+    IdxMap<JourneyPatternPoint, std::shared_ptr<const FreqIndex>> freq_departure;
+    IdxMap<JourneyPatternPoint, std::shared_ptr<const FreqIndex>> freq_arrival;
 };
 
 struct NextStopTime {
@@ -214,12 +249,148 @@ struct CachedNextStopTimeKey {
     bool operator<(const CachedNextStopTimeKey& other) const;
 };
 
-struct CachedNextStopTime {
-    using DtSt = std::pair<DateTime, const type::StopTime*>;
-    using vDtSt = std::vector<DtSt>;
-    using vDtStByJpp = IdxMap<JourneyPatternPoint, vDtSt>;
+/*
+ * Stop times of one journey pattern, sorted by datetime, for a given CachedNextStopTimeKey
+ *
+ * The stop times are referenced by the rank of their vehicle journey in the
+ * journey pattern and not by pointer: a JpCachedNextStopTime only depends on
+ * the content of its journey pattern.  It can thus be shared between 2 Data
+ * generations as long as the journey pattern didn't change (see
+ * dataRAPTOR::jp_signatures), and the realtime updates only need to rebuild the
+ * journey patterns they impacted.
+ */
+struct JpCachedNextStopTime {
+    struct DtVj {
+        DateTime dt;
+        uint32_t vj_rank;  // rank of the vj in the journey pattern
+    };
+    using vDtVj = std::vector<DtVj>;
+
+    // The occurrences of a frequency vj at a stop point: dt, dt + headway, ..., last
+    // Stored as is instead of one DtVj by occurrence
+    struct FreqBlock {
+        DateTime dt;  // first occurrence
+        DateTime last;
+        uint32_t headway;
+        uint32_t vj_rank;
+        DateTime max_last;  // max of last over this block and the previous ones of the jpp
+    };
+    using vFreqBlock = std::vector<FreqBlock>;
+
+    // Condensed view of a vector<vector<T>> indexed by the rank of the jpp in the
+    // journey pattern, works like CachedNextStopTime::DtStFromJpp.
+    // The elements of each jpp are sorted by dt.
+    template <typename T>
+    struct ByRank {
+        ByRank() = default;
+        explicit ByRank(std::vector<std::vector<T>>& by_rank);
+
+        boost::iterator_range<typename std::vector<T>::const_iterator> operator[](
+            const RankJourneyPatternPoint& order) const;
+        size_t memory_usage() const;
+
+    private:
+        std::vector<T> elts;
+        std::vector<uint32_t> until;
+    };
+    using DtVjByRank = ByRank<DtVj>;
+    using FreqBlockByRank = ByRank<FreqBlock>;
+
+    // What the cache has been computed from: the journey patterns with the same source give the same cache.
+    // The signatures being only hashes, a journey pattern is compared with it before sharing the cache.
+    struct Source {
+        struct StTimes {
+            uint32_t boarding_time;
+            uint32_t alighting_time;
+            bool pick_up_allowed;
+            bool drop_off_allowed;
+            bool operator==(const StTimes& other) const;
+        };
+        struct Vj {
+            idx_t idx;
+            uint8_t days;  // the days of the cache window the vj runs on, by bit, 0 if it is not accessible
+            // only for the frequency vjs
+            uint32_t start_time;
+            uint32_t end_time;
+            uint32_t headway_secs;
+            bool operator==(const Vj& other) const;
+        };
+
+        Source(const CachedNextStopTimeKey& key, const JourneyPattern& jp);
+        bool operator==(const Source& other) const;
+        size_t memory_usage() const;
+
+        size_t nb_jpps;
+        std::vector<Vj> vjs;              // by rank
+        std::vector<StTimes> stop_times;  // of every vj, by rank of the vj then of the jpp
+    };
+
+    JpCachedNextStopTime(const CachedNextStopTimeKey& key,
+                         const JourneyPattern& jp,
+                         size_t signature,
+                         std::vector<vDtVj>& departure,
+                         std::vector<vDtVj>& arrival,
+                         std::vector<vFreqBlock>& freq_departure,
+                         std::vector<vFreqBlock>& freq_arrival);
+
+    size_t memory_usage() const;
+
+    // true if the cache of jp for key would be the same as this one: same vjs, stop times and validity patterns
+    bool is_built_from(const CachedNextStopTimeKey& key, const JourneyPattern& jp) const;
+
+    size_t signature;  // signature of the journey pattern used to build this cache
+    Source source;
+    DtVjByRank departure;
+    DtVjByRank arrival;
+    // only for the journey patterns of frequency vjs
+    FreqBlockByRank freq_departure;
+    FreqBlockByRank freq_arrival;
+};
+
+/*
+ * The JpCachedNextStopTime of every journey pattern for a CachedNextStopTimeKey
+ *
+ * The journey pattern caches are only built when a journey pattern is first
+ * used by a request, a request usually only explores a small part of the
+ * journey patterns.  Once built, a journey pattern cache never changes, so the
+ * lookups only cost an atomic load.
+ */
+struct JpCaches {
+    JpCaches(const CachedNextStopTimeKey& key, size_t nb_jps);
+
+    // Returns the cache of the journey pattern, building it if needed.  Can be
+    // called concurrently, if 2 threads build the same journey pattern only the
+    // first one is kept.
+    const JpCachedNextStopTime& get(const dataRAPTOR& dataRaptor, const JpIdx& jp_idx) const;
 
-    CachedNextStopTime(const vDtStByJpp& d, const vDtStByJpp& a) : departure(d), arrival(a) {}
+    // Returns the cache of the journey pattern if it has already been built
+    std::shared_ptr<const JpCachedNextStopTime> get_if_built(const JpIdx& jp_idx) const;
+
+    // Use a journey pattern cache built elsewhere (i.e. by the previous Data generation)
+    void share(const JpIdx& jp_idx, std::shared_ptr<const JpCachedNextStopTime> jp_cache) const;
+
+    size_t nb_jps() const { return jp_caches.size(); }
+    size_t nb_built() const { return nb_jp_caches; }
+    // memory used by the journey pattern caches, the shared ones included
+    size_t memory_usage() const { return memory; }
+
+    const CachedNextStopTimeKey key;
+
+private:
+    const JpCachedNextStopTime& publish(const JpIdx& jp_idx,
+                                        std::shared_ptr<const JpCachedNextStopTime> jp_cache) const;
+
+    // jp_caches[jp_idx] is null until owned_jp_caches[jp_idx] is set
+    mutable std::vector<std::atomic<const JpCachedNextStopTime*>> jp_caches;
+    mutable std::mutex mutex;
+    mutable std::vector<std::shared_ptr<const JpCachedNextStopTime>> owned_jp_caches;
+    mutable std::atomic<size_t> nb_jp_caches{0};
+    mutable std::atomic<size_t> memory{0};
+};
+
+struct CachedNextStopTime {
+    CachedNextStopTime(const dataRAPTOR& dataRaptor, std::shared_ptr<const JpCaches> jp_caches)
+        : dataRaptor(dataRaptor), jp_caches(std::move(jp_caches)) {}
     // Returns the next stop time at given journey pattern point
     // either a vehicle that leaves or that arrives depending on
     // clockwise.
@@ -228,46 +399,16 @@ struct CachedNextStopTime {
                                                               const DateTime dt,
                                                               const bool clockwise) const;
 
-private:
-    // This structure provide the same interface as a vDtStByJpp, but
-    // in a condensed and read only view.
-    struct DtStFromJpp {
-        DtStFromJpp(const vDtStByJpp& map);
-
-        // Returns the range corresponding to map[jpp_idx], i.e. from
-        // dtsts[until[prev(jpp_idx)]] to dtsts[until[jpp_idx]]
-        // (excluded).
-        boost::iterator_range<vDtSt::const_iterator> operator[](const JppIdx& jpp_idx) const;
+    const std::shared_ptr<const JpCaches>& get_jp_caches() const { return jp_caches; }
 
-    private:
-        // let map[JppIdx(40)] == []
-        //     map[JppIdx(41)] == [a, l]
-        //     map[JppIdx(42)] == [x, y, z]
-        //
-        // until: [..., JppIdx(39), JppIdx(40), JppIdx(41), JppIdx(42), ...]
-        //                  |           |            |        |
-        //                  ------------+------,     |        |
-        //                                     V     V        V
-        // dtsts: [...................... , o, a, l, x, y, z, p, q, ...]
-        //                                           ^^^^^^^
-        //                                      range of values
-        //                                      corresponding to
-        //                                      map[JppIdx(42)]
-        //
-        // Every vectors of map concatenated in order
-        // (flatten(map.values())).
-        vDtSt dtsts;
-
-        // dtsts[until[jpp_idx]] correspond to the end of
-        // map[jpp_idx], and to the begin of map[next(jpp_idx)]
-        IdxMap<JourneyPatternPoint, uint32_t> until;
-    };
-    DtStFromJpp departure;
-    DtStFromJpp arrival;
+private:
+    const dataRAPTOR& dataRaptor;
+    std::shared_ptr<const JpCaches> jp_caches;
 };
 
 struct CachedNextStopTimeManager {
-    explicit CachedNextStopTimeManager(const dataRAPTOR& dataRaptor, size_t max_cache) : lru({dataRaptor}, max_cache) {}
+    explicit CachedNextStopTimeManager(const dataRAPTOR& dataRaptor, size_t max_cache)
+        : generation(std::make_shared<Generation>()), lru({dataRaptor, generation}, max_cache) {}
     CachedNextStopTimeManager& operator=(CachedNextStopTimeManager&&) = default;
     ~CachedNextStopTimeManager();
 
@@ -275,17 +416,40 @@ struct CachedNextStopTimeManager {
                                                    const type::RTLevel rt_level,
                                                    const type::AccessibiliteParams& accessibilite_params);
 
-    void warmup(const CachedNextStopTimeManager& other) { this->lru.warmup(other.lru); }
+    // Load the keys of `other` in this cache.  The journey pattern caches of
+    // `other` whose journey pattern didn't change are shared, the other ones
+    // will be built on demand.
+    void warmup(const CachedNextStopTimeManager& other);
+
+    // memory used by the caches of the keys currently loaded
+    size_t memory_usage() const;
+    // log the memory used by the cache of each key currently loaded
+    void log_memory_usage() const;
 
 private:
+    // The journey pattern caches built by a manager, by key, so that the
+    // manager of the next Data generation can reuse them during its warmup
+    struct Generation {
+        mutable std::mutex mutex;
+        std::map<CachedNextStopTimeKey, std::weak_ptr<const JpCaches>> jp_caches;
+        // only set during a warmup
+        std::shared_ptr<const Generation> previous;
+
+        std::shared_ptr<const JpCaches> get(const CachedNextStopTimeKey& key) const;
+        // the caches of the keys still loaded
+        std::vector<std::shared_ptr<const JpCaches>> alive() const;
+    };
+
     struct CacheCreator {
         typedef CachedNextStopTimeKey const& argument_type;
         typedef CachedNextStopTime result_type;
         const dataRAPTOR& dataRaptor;
-        CacheCreator(const dataRAPTOR& d) : dataRaptor(d) {}
+        std::shared_ptr<Generation> generation;
+        CacheCreator(const dataRAPTOR& d, std::shared_ptr<Generation> g) : dataRaptor(d), generation(std::move(g)) {}
         CachedNextStopTime operator()(const CachedNextStopTimeKey& key) const;
     };
 
+    std::shared_ptr<Generation> generation;
     ConcurrentLru<CacheCreator> lru;
 };
 
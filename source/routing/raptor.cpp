@@ -40,6 +40,8 @@ www.navitia.io
 #include <boost/range/algorithm_ext/push_back.hpp>
 
 #include <chrono>
+#include <cmath>
+#include <numeric>
 
 namespace navitia {
 namespace routing {
@@ -65,6 +67,7 @@ bool RAPTOR::apply_vj_extension(const Visitor& v,
                                 const uint16_t l_zone,
                                 DateTime base_dt) {
     auto& working_labels = labels[count];
+    const bool prune = !pruning_targets.empty();
     bool result = false;
     while (vj) {
         base_dt = v.get_base_dt_extension(base_dt, vj);
@@ -93,9 +96,15 @@ bool RAPTOR::apply_vj_extension(const Visitor& v,
             if (!v.comp(workingDt, best_labels_pts[sp_idx])) {
                 continue;
             }
+            if (prune && is_pruned(v, sp_idx, workingDt)) {
+                continue;
+            }
 
-            working_labels.mut_dt_pt(sp_idx) = workingDt;
+            working_labels.set_dt_pt(sp_idx, workingDt);
             best_labels_pts[sp_idx] = workingDt;
+            if (prune && target_lower_bounds[sp_idx] == 0) {
+                update_target_bound(v.clockwise());
+            }
             result = true;
         }
         vj = v.get_extension_vj(vj);
@@ -129,13 +138,13 @@ bool RAPTOR::foot_path(const Visitor& v) {
             }
 
             // if we can improve the best label, we mark it
-            working_labels.mut_dt_transfer(destination_sp_idx) = next;
+            working_labels.set_dt_transfer(destination_sp_idx, next);
             best_labels_transfers[destination_sp_idx] = next;
             result = true;
         }
     }
 
-    for (const auto sp_jpps : jpps_from_sp) {
+    for (const auto sp_jpps : *jpps_from_sp) {
         if (!working_labels.transfer_is_initialized(sp_jpps.first)) {
             continue;
         }
@@ -152,18 +161,22 @@ bool RAPTOR::foot_path(const Visitor& v) {
 }
 
 void RAPTOR::clear(const bool clockwise, const DateTime bound) {
+    clear_rounds(clockwise);
+    boost::fill(best_labels_pts.values(), bound);
+    boost::fill(best_labels_transfers.values(), bound);
+}
+
+void RAPTOR::clear_rounds(const bool clockwise) {
     const int queue_value = clockwise ? std::numeric_limits<int>::max() : -1;
     Q.assign(data.dataRaptor->jp_container.get_jps_values(), queue_value);
+    const Labels& clean_labels = clockwise ? data.dataRaptor->labels_const : data.dataRaptor->labels_const_reverse;
     if (labels.empty()) {
-        labels.resize(5);
+        labels.push_back(clean_labels);
     }
-    const Labels& clean_labels = clockwise ? data.dataRaptor->labels_const : data.dataRaptor->labels_const_reverse;
+    // only the stop points reached by the previous search are reset, whatever its direction
     for (auto& lbl_list : labels) {
         lbl_list.clear(clean_labels);
     }
-
-    boost::fill(best_labels_pts.values(), bound);
-    boost::fill(best_labels_transfers.values(), bound);
 }
 
 void RAPTOR::init(const map_stop_point_duration& dep,
@@ -176,9 +189,9 @@ void RAPTOR::init(const map_stop_point_duration& dep,
         }
         const DateTime sn_dur = sp_dt.second.total_seconds();
         const DateTime begin_dt = bound + (clockwise ? sn_dur : -sn_dur);
-        labels[0].mut_dt_transfer(sp_dt.first) = begin_dt;
+        labels[0].set_dt_transfer(sp_dt.first, begin_dt);
         best_labels_transfers[sp_dt.first] = begin_dt;
-        for (const auto& jpp : jpps_from_sp[sp_dt.first]) {
+        for (const auto& jpp : (*jpps_from_sp)[sp_dt.first]) {
             if (clockwise && Q[jpp.jp_idx] > jpp.order) {
                 Q[jpp.jp_idx] = jpp.order;
             } else if (!clockwise && Q[jpp.jp_idx] < jpp.order) {
@@ -194,7 +207,8 @@ void RAPTOR::first_raptor_loop(const map_stop_point_duration& departures,
                                const DateTime& bound_limit,
                                const uint32_t max_transfers,
                                const type::AccessibiliteParams& accessibilite_params,
-                               const bool clockwise) {
+                               const bool clockwise,
+                               const map_stop_point_duration& targets) {
     const DateTime bound = limit_bound(clockwise, departure_datetime, bound_limit);
 
     assert(data.dataRaptor->cached_next_st_manager);
@@ -203,8 +217,38 @@ void RAPTOR::first_raptor_loop(const map_stop_point_duration& departures,
 
     clear(clockwise, bound);
     init(departures, departure_datetime, clockwise, accessibilite_params.properties);
+    init_target_pruning(targets, clockwise, bound);
 
     boucleRAPTOR(clockwise, rt_level, max_transfers);
+    pruning_targets.clear();
+}
+
+void RAPTOR::init_target_pruning(const map_stop_point_duration& targets, const bool clockwise, const DateTime bound) {
+    pruning_targets.clear();
+    if (!target_pruning || targets.empty()) {
+        return;
+    }
+    std::vector<SpIdx> target_sps;
+    for (const auto& sp_dur : targets) {
+        pruning_targets.emplace_back(sp_dur.first, sp_dur.second.total_seconds());
+        target_sps.push_back(sp_dur.first);
+    }
+    data.dataRaptor->min_durations.lower_bounds(target_sps, clockwise, target_lower_bounds);
+    pruning_bound = bound;
+    update_target_bound(clockwise);
+}
+
+void RAPTOR::update_target_bound(const bool clockwise) {
+    target_bound = pruning_bound;
+    for (const auto& target : pruning_targets) {
+        const DateTime dt = best_labels_pts[target.first];
+        // a target not reached yet doesn't bound anything
+        if (dt == pruning_bound) {
+            continue;
+        }
+        target_bound = clockwise ? std::min(target_bound, dt + target.second)
+                                 : std::max(target_bound, dt - std::min(dt, target.second));
+    }
 }
 
 namespace {
@@ -403,13 +447,39 @@ RAPTOR::Journeys RAPTOR::compute_all_journeys(const map_stop_point_duration& dep
                                               bool clockwise,
                                               const boost::optional<navitia::time_duration>& direct_path_dur,
                                               const size_t max_extra_second_pass) {
+    return compute_all_journeys(departures, destinations, departure_datetime, rt_level, transfer_penalty, bound,
+                                max_transfers, accessibilite_params, clockwise,
+                                DirectPathDuration([&]() { return direct_path_dur; }), max_extra_second_pass);
+}
+
+RAPTOR::Journeys RAPTOR::compute_all_journeys(const map_stop_point_duration& departures,
+                                              const map_stop_point_duration& destinations,
+                                              const DateTime& departure_datetime,
+                                              const nt::RTLevel rt_level,
+                                              const navitia::time_duration& transfer_penalty,
+                                              const DateTime& bound,
+                                              const uint32_t max_transfers,
+                                              const type::AccessibiliteParams& accessibilite_params,
+                                              bool clockwise,
+                                              const DirectPathDuration& direct_path_dur,
+                                              const size_t max_extra_second_pass) {
     auto start_raptor = std::chrono::system_clock::now();
 
+    const auto& calc_dep = clockwise ? departures : destinations;
+    const auto& calc_dest = clockwise ? destinations : departures;
+
+    first_raptor_loop(calc_dep, departure_datetime, rt_level, bound, max_transfers, accessibilite_params, clockwise,
+                      calc_dest);
+
+    auto end_first_pass = std::chrono::system_clock::now();
+
     auto solutions = ParetoFront<Journey, Dominates /*, JourneyParetoFrontVisitor*/>(Dominates(clockwise));
 
-    if (direct_path_dur) {
+    // the direct path is only needed by the solutions of the second pass
+    const auto direct_path_duration = direct_path_dur();
+    if (direct_path_duration) {
         Journey j;
-        j.sn_dur = *direct_path_dur;
+        j.sn_dur = *direct_path_duration;
         if (clockwise) {
             j.departure_dt = departure_datetime;
             j.arrival_dt = j.departure_dt + j.sn_dur;
@@ -420,13 +490,6 @@ RAPTOR::Journeys RAPTOR::compute_all_journeys(const map_stop_point_duration& dep
         solutions.add(j);
     }
 
-    const auto& calc_dep = clockwise ? departures : destinations;
-    const auto& calc_dest = clockwise ? destinations : departures;
-
-    first_raptor_loop(calc_dep, departure_datetime, rt_level, bound, max_transfers, accessibilite_params, clockwise);
-
-    auto end_first_pass = std::chrono::system_clock::now();
-
     // Now, we do the second pass.  In case of clockwise (resp
     // anticlockwise) search, the goal of the second pass is to find
     // the earliest (resp. tardiest) departure (resp arrival)
@@ -440,7 +503,6 @@ RAPTOR::Journeys RAPTOR::compute_all_journeys(const map_stop_point_duration& dep
     // these bounds, modulo an off by one because of strict comparison
     // on best_labels.
     auto starting_points = make_starting_points_snd_phase(*this, calc_dest, accessibilite_params, clockwise);
-    swap(labels, first_pass_labels);
     auto best_labels_pts_for_snd_pass = snd_pass_best_labels(clockwise, best_labels_transfers);
     init_best_pts_snd_pass(calc_dep, departure_datetime, clockwise, best_labels_pts_for_snd_pass);
     auto best_labels_transfers_for_snd_pass = snd_pass_best_labels(clockwise, best_labels_pts);
@@ -450,42 +512,101 @@ RAPTOR::Journeys RAPTOR::compute_all_journeys(const map_stop_point_duration& dep
         lower_bound_fb = std::min(lower_bound_fb, unsigned(pair_sp_dt.second.seconds()));
     }
 
-    size_t nb_snd_pass = 0, nb_useless = 0, last_usefull_2nd_pass = 0, supplementary_2nd_pass = 0;
-    for (const auto& start : starting_points) {
-        Journey fake_journey =
-            convert_to_bound(start, lower_bound_fb, data.dataRaptor->min_connection_time, transfer_penalty, clockwise);
-        if (solutions.contains_better_than(fake_journey)) {
-            continue;
-        }
+    // a backward search from one starting point, run by `worker`, its journeys are added to `sols`
+    const auto snd_pass = [&](RAPTOR& worker, const StartingPointSndPhase& start, Solutions& sols,
+                              const Solutions* known_solutions) {
+        worker.clear(!clockwise, departure_datetime + (clockwise ? -1 : 1));
+        map_stop_point_duration init_map;
+        init_map[start.sp_idx] = 0_s;
+        worker.best_labels_pts = best_labels_pts_for_snd_pass;
+        worker.best_labels_transfers = best_labels_transfers_for_snd_pass;
+        // the labels of the first pass have been reused by the previous searches, its datetime at the starting
+        // point is the end_dt of the starting point without the fallback
+        const DateTime first_pass_dt =
+            clockwise ? start.end_dt - start.fallback_dur : start.end_dt + start.fallback_dur;
+        worker.init(init_map, first_pass_dt, !clockwise, accessibilite_params.properties);
+        worker.boucleRAPTOR(!clockwise, rt_level, max_transfers);
+        read_solutions(worker, sols, !clockwise, departure_datetime, departures, destinations, rt_level,
+                       accessibilite_params, transfer_penalty, start, known_solutions);
+    };
+    const auto is_useless = [&](const StartingPointSndPhase& start) {
+        const Journey fake_journey = convert_to_bound(start, lower_bound_fb, data.dataRaptor->min_connection_time,
+                                                      transfer_penalty, clockwise);
+        return solutions.contains_better_than(fake_journey);
+    };
+    const size_t nb_threads = std::min(nb_snd_pass_threads, thread_pool->size());
+    if (nb_threads > 1) {
+        prepare_snd_pass_workers(nb_threads);
+    }
 
-        if (!start.has_priority) {
-            ++supplementary_2nd_pass;
+    // The starting points are processed by batches of nb_threads, in parallel.
+    // A batch is made of the next starting points that are useful with the
+    // solutions known before it.  The journeys of each starting point are then
+    // merged in order, as the sequential second pass would have done: a
+    // starting point made useless by the previous ones of its batch is
+    // discarded, and only the merged ones count in max_extra_second_pass.
+    // The searches of a batch find at least the journeys that the sequential
+    // ones would have found, and the others are dominated, so the solutions
+    // don't depend on the number of threads.  With 1 thread, it's the plain
+    // sequential second pass.
+    snd_pass_stats = SndPassStats();
+    snd_pass_stats.nb_starting_points = starting_points.size();
+    size_t nb_useless = 0, last_usefull_2nd_pass = 0, supplementary_2nd_pass = 0;
+    std::vector<const StartingPointSndPhase*> batch;
+    std::vector<Solutions> batch_solutions;
+    auto it_start = starting_points.cbegin();
+    bool max_extra_second_pass_reached = false;
+    while (!max_extra_second_pass_reached) {
+        batch.clear();
+        for (; it_start != starting_points.cend() && batch.size() < nb_threads; ++it_start) {
+            if (!is_useless(*it_start)) {
+                batch.push_back(&*it_start);
+            }
         }
-        if (supplementary_2nd_pass > max_extra_second_pass) {
+        if (batch.empty()) {
             break;
         }
 
-        const auto& working_labels = first_pass_labels[start.count];
-
-        clear(!clockwise, departure_datetime + (clockwise ? -1 : 1));
-        map_stop_point_duration init_map;
-        init_map[start.sp_idx] = 0_s;
-        best_labels_pts = best_labels_pts_for_snd_pass;
-        best_labels_transfers = best_labels_transfers_for_snd_pass;
-        init(init_map, working_labels.dt_pt(start.sp_idx), !clockwise, accessibilite_params.properties);
-        boucleRAPTOR(!clockwise, rt_level, max_transfers);
-        read_solutions(*this, solutions, !clockwise, departure_datetime, departures, destinations, rt_level,
-                       accessibilite_params, transfer_penalty, start);
-
-        ++nb_snd_pass;
+        if (batch.size() > 1) {
+            // the journeys of each search are kept apart, the searches are pruned with the solutions of the
+            // previous batches
+            batch_solutions.assign(batch.size(), Solutions(Dominates(clockwise)));
+            run_on_workers(nb_threads, batch.size(), [&](RAPTOR& worker, size_t i) {
+                snd_pass(worker, *batch[i], batch_solutions[i], &solutions);
+            });
+        }
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const auto& start = *batch[i];
+            // the first one has just been checked with the same solutions
+            if (i > 0 && is_useless(start)) {
+                ++snd_pass_stats.nb_discarded;
+                continue;
+            }
+            if (!start.has_priority) {
+                ++supplementary_2nd_pass;
+            }
+            if (supplementary_2nd_pass > max_extra_second_pass) {
+                max_extra_second_pass_reached = true;
+                break;
+            }
+            ++snd_pass_stats.nb_snd_pass;
+            if (batch.size() == 1) {
+                snd_pass(*this, start, solutions, nullptr);
+                continue;
+            }
+            for (const auto& journey : batch_solutions[i].get_pool()) {
+                solutions.add(journey);
+            }
+        }
     }
     log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
     LOG4CPLUS_DEBUG(logger, "[2nd pass] lower bound fallback duration = "
                                 << lower_bound_fb << " s, lower bound connection duration = "
                                 << data.dataRaptor->min_connection_time << " s");
     LOG4CPLUS_DEBUG(logger, "[2nd pass] number of 2nd pass = "
-                                << nb_snd_pass << " / " << starting_points.size() << " (nb useless = " << nb_useless
-                                << ", last usefull try = " << last_usefull_2nd_pass << ")");
+                                << snd_pass_stats.nb_snd_pass << " / " << starting_points.size()
+                                << " (nb useless = " << nb_useless << ", last usefull try = " << last_usefull_2nd_pass
+                                << ", nb discarded = " << snd_pass_stats.nb_discarded << ")");
     auto end_raptor = std::chrono::system_clock::now();
     LOG4CPLUS_DEBUG(logger,
                     "[2nd pass] Run times: 1st pass = "
@@ -511,6 +632,117 @@ void RAPTOR::isochrone(const map_stop_point_duration& departures,
     first_raptor_loop(departures, departure_datetime, rt_level, b, max_transfers, accessibilite_params, clockwise);
 }
 
+RAPTOR::IsochroneProfile RAPTOR::isochrone_profile(const map_stop_point_duration& departures,
+                                                   const std::vector<DateTime>& departure_datetimes,
+                                                   const DateTime& b,
+                                                   const uint32_t max_transfers,
+                                                   const type::AccessibiliteParams& accessibilite_params,
+                                                   const std::vector<std::string>& forbidden,
+                                                   const std::vector<std::string>& allowed,
+                                                   const bool clockwise,
+                                                   const nt::RTLevel rt_level) {
+    IsochroneProfile profile(data.pt_data->stop_points);
+    if (departure_datetimes.empty()) {
+        return profile;
+    }
+    for (auto& durations : profile.values()) {
+        durations.assign(departure_datetimes.size(), DateTimeUtils::inf);
+    }
+
+    // the worst departure datetime first
+    std::vector<size_t> order(departure_datetimes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](const size_t lhs, const size_t rhs) {
+        return clockwise ? departure_datetimes[lhs] > departure_datetimes[rhs]
+                         : departure_datetimes[lhs] < departure_datetimes[rhs];
+    });
+    const DateTime best_datetime = departure_datetimes[order.back()];
+    // the bound is limited to a day after each departure datetime: the labels are initialized with the
+    // loosest one, the one of the worst departure datetime, and each profile is cut by its own bound
+    const DateTime loosest_bound = limit_bound(clockwise, departure_datetimes[order.front()], b);
+
+    set_valid_jp_and_jpp(DateTimeUtils::date(best_datetime), accessibilite_params, forbidden, allowed, rt_level);
+    assert(data.dataRaptor->cached_next_st_manager);
+    next_st = data.dataRaptor->cached_next_st_manager->load(clockwise ? best_datetime : loosest_bound, rt_level,
+                                                            accessibilite_params);
+    // raptor_loop does at most max_transfers + 1 rounds
+    const size_t nb_rounds = size_t(max_transfers) + 1;
+    clear(clockwise, loosest_bound);
+    range_best_labels.assign(nb_rounds + 1, RoundBestLabels{best_labels_pts, best_labels_transfers});
+    for (const auto i : order) {
+        const DateTime departure_datetime = departure_datetimes[i];
+        const DateTime bound = limit_bound(clockwise, departure_datetime, b);
+        clear(clockwise, loosest_bound);
+        init(departures, departure_datetime, clockwise, accessibilite_params.properties);
+        boucleRAPTOR(clockwise, rt_level, max_transfers);
+        // the rounds that weren't needed by this search are improved by its labels too
+        for (count = count + 1; count <= nb_rounds; ++count) {
+            merge_range_best_labels(clockwise);
+            keep_range_best_labels();
+        }
+
+        for (const auto sp_dt : range_best_labels[nb_rounds].pts) {
+            if (clockwise && sp_dt.second < bound) {
+                profile[sp_dt.first][i] = sp_dt.second - departure_datetime;
+            } else if (!clockwise && sp_dt.second > bound) {
+                profile[sp_dt.first][i] = departure_datetime - sp_dt.second;
+            }
+        }
+    }
+    range_best_labels = {};
+    return profile;
+}
+
+DateTime duration_percentile(std::vector<DateTime> durations, const double percentile) {
+    if (durations.empty()) {
+        return DateTimeUtils::inf;
+    }
+    const auto rank = size_t(std::ceil(percentile / 100. * durations.size()));
+    const auto nth = durations.begin() + std::min(std::max<size_t>(rank, 1), durations.size()) - 1;
+    std::nth_element(durations.begin(), nth, durations.end());
+    return *nth;
+}
+
+RAPTOR::Matrix RAPTOR::compute_matrix(const std::vector<map_stop_point_duration>& origins,
+                                      const std::vector<map_stop_point_duration>& destinations,
+                                      const DateTime& departure_datetime,
+                                      const nt::RTLevel rt_level,
+                                      const DateTime& bound,
+                                      const uint32_t max_transfers,
+                                      const type::AccessibiliteParams& accessibilite_params,
+                                      const std::vector<std::string>& forbidden,
+                                      const std::vector<std::string>& allowed,
+                                      const size_t nb_threads) {
+    Matrix matrix(origins.size(), MatrixRow(destinations.size()));
+    if (origins.empty() || destinations.empty()) {
+        return matrix;
+    }
+    set_valid_jp_and_jpp(DateTimeUtils::date(departure_datetime), accessibilite_params, forbidden, allowed, rt_level);
+    const size_t nb_matrix_threads = std::min(std::max<size_t>(nb_threads, 1), thread_pool->size());
+    prepare_snd_pass_workers(nb_matrix_threads);
+
+    // a row by task
+    run_on_workers(nb_matrix_threads, origins.size(), [&](RAPTOR& planner, size_t o) {
+        planner.first_raptor_loop(origins[o], departure_datetime, rt_level, bound, max_transfers, accessibilite_params,
+                                  true);
+        for (size_t d = 0; d < destinations.size(); ++d) {
+            DateTime best_arrival = DateTimeUtils::inf;
+            for (const auto& sp_dur : destinations[d]) {
+                const auto arrival =
+                    std::min(planner.best_labels_pts[sp_dur.first], planner.best_labels_transfers[sp_dur.first]);
+                // the labels of the stop points that haven't been reached are the bound of the search
+                if (arrival < bound) {
+                    best_arrival = std::min(best_arrival, arrival + DateTime(sp_dur.second.total_seconds()));
+                }
+            }
+            if (best_arrival != DateTimeUtils::inf) {
+                matrix[o][d] = navitia::seconds(best_arrival - departure_datetime);
+            }
+        }
+    });
+    return matrix;
+}
+
 namespace {
 struct ObjsFromIds {
     boost::dynamic_bitset<> jps;
@@ -518,6 +750,7 @@ struct ObjsFromIds {
     boost::dynamic_bitset<> sps;
     ObjsFromIds(const std::vector<std::string>& ids, const JourneyPatternContainer& jp_container, const nt::Data& data)
         : jps(jp_container.nb_jps()), jpps(jp_container.nb_jpps()), sps(data.pt_data->stop_points.size()) {
+        const auto& jp_filters = data.dataRaptor->jp_filters;
         for (const auto& id : ids) {
             const auto it_line = data.pt_data->lines_map.find(id);
             if (it_line != data.pt_data->lines_map.end()) {
@@ -537,32 +770,17 @@ struct ObjsFromIds {
             }
             const auto it_commercial_mode = data.pt_data->commercial_modes_map.find(id);
             if (it_commercial_mode != data.pt_data->commercial_modes_map.end()) {
-                for (const auto line : it_commercial_mode->second->line_list) {
-                    for (auto route : line->route_list) {
-                        for (const auto& jp_idx : jp_container.get_jps_from_route()[RouteIdx(*route)]) {
-                            jps.set(jp_idx.val, true);
-                        }
-                    }
-                }
+                jps |= jp_filters.jps_from_commercial_mode[Idx<type::CommercialMode>(*it_commercial_mode->second)];
                 continue;
             }
             const auto it_physical_mode = data.pt_data->physical_modes_map.find(id);
             if (it_physical_mode != data.pt_data->physical_modes_map.end()) {
-                const auto phy_mode_idx = PhyModeIdx(*it_physical_mode->second);
-                for (const auto& jp_idx : jp_container.get_jps_from_phy_mode()[phy_mode_idx]) {
-                    jps.set(jp_idx.val, true);
-                }
+                jps |= jp_filters.jps_from_physical_mode[PhyModeIdx(*it_physical_mode->second)];
                 continue;
             }
             const auto it_network = data.pt_data->networks_map.find(id);
             if (it_network != data.pt_data->networks_map.end()) {
-                for (const auto line : it_network->second->line_list) {
-                    for (const auto route : line->route_list) {
-                        for (const auto& jp_idx : jp_container.get_jps_from_route()[RouteIdx(*route)]) {
-                            jps.set(jp_idx.val, true);
-                        }
-                    }
-                }
+                jps |= jp_filters.jps_from_network[Idx<type::Network>(*it_network->second)];
                 continue;
             }
             const auto it_sp = data.pt_data->stop_points_map.find(id);
@@ -600,10 +818,10 @@ void RAPTOR::set_valid_jp_and_jpp(uint32_t date,
     valid_journey_pattern_points.set();
     valid_stop_points.set();
 
-    auto forbidden_objs = ObjsFromIds(forbidden, jp_container, data);
-    valid_journey_patterns &= forbidden_objs.jps.flip();
-    valid_journey_pattern_points &= forbidden_objs.jpps.flip();
-    valid_stop_points &= forbidden_objs.sps.flip();
+    const auto forbidden_objs = ObjsFromIds(forbidden, jp_container, data);
+    valid_journey_patterns -= forbidden_objs.jps;
+    valid_journey_pattern_points -= forbidden_objs.jpps;
+    valid_stop_points -= forbidden_objs.sps;
 
     const auto allowed_objs = ObjsFromIds(allowed, jp_container, data);
     if (allowed_objs.jps.any()) {
@@ -620,17 +838,14 @@ void RAPTOR::set_valid_jp_and_jpp(uint32_t date,
         valid_stop_points &= allowed_objs.sps;
     }
 
-    // filter accessibility
-    if (accessibilite_params.properties.any()) {
-        for (const auto* sp : data.pt_data->stop_points) {
-            if (sp->accessible(accessibilite_params.properties)) {
-                continue;
-            }
-            valid_stop_points.set(sp->idx, false);
-            for (const auto& jpp : data.dataRaptor->jpps_from_sp[SpIdx(*sp)]) {
-                valid_journey_pattern_points.set(jpp.idx.val, false);
-            }
+    // filter accessibility: a stop point missing one of the required properties is invalid
+    const auto& jp_filters = data.dataRaptor->jp_filters;
+    for (size_t p = 0; p < accessibilite_params.properties.size(); ++p) {
+        if (!accessibilite_params.properties[p]) {
+            continue;
         }
+        valid_stop_points -= jp_filters.sps_without_property[p];
+        valid_journey_pattern_points -= jp_filters.jpps_without_property[p];
     }
 
     // propagate the invalid jp in their jpp
@@ -648,27 +863,33 @@ void RAPTOR::set_valid_jp_and_jpp(uint32_t date,
     // jpps.  Thanks to that, we don't need to check
     // valid_journey_pattern[_point]s as we iterate only on the
     // feasible ones.
-    jpps_from_sp = data.dataRaptor->jpps_from_sp;
-    jpps_from_sp.filter_jpps(valid_journey_pattern_points);
+    auto valid_jpps_from_sp = std::make_shared<dataRAPTOR::JppsFromSp>(data.dataRaptor->jpps_from_sp);
+    valid_jpps_from_sp->filter_jpps(valid_journey_pattern_points);
+    jpps_from_sp = std::move(valid_jpps_from_sp);
 }
 
 template <typename Visitor>
 void RAPTOR::raptor_loop(Visitor visitor, const nt::RTLevel rt_level, uint32_t max_transfers) {
     bool continue_algorithm = true;
     count = 0;  //< Count iteration of raptor algorithm
+    const bool prune = !pruning_targets.empty();
 
     while (continue_algorithm && count <= max_transfers) {
         ++count;
         continue_algorithm = false;
-        if (count == labels.size()) {
+        if (!range_best_labels.empty()) {
+            merge_range_best_labels(visitor.clockwise());
+        }
+        auto& rounds = labels;
+        if (count == rounds.size()) {
             if (visitor.clockwise()) {
-                this->labels.push_back(this->data.dataRaptor->labels_const);
+                rounds.push_back(this->data.dataRaptor->labels_const);
             } else {
-                this->labels.push_back(this->data.dataRaptor->labels_const_reverse);
+                rounds.push_back(this->data.dataRaptor->labels_const_reverse);
             }
         }
-        const auto& prec_labels = labels[count - 1];
-        auto& working_labels = labels[this->count];
+        const auto& prec_labels = rounds[count - 1];
+        auto& working_labels = rounds[this->count];
         /*
          * We need to store it so we can apply stay_in after applying normal vjs
          * We want to do it, to favoritize normal vj against stay_in vjs
@@ -695,10 +916,14 @@ void RAPTOR::raptor_loop(Visitor visitor, const nt::RTLevel rt_level, uint32_t m
                         if (st.valid_end(visitor.clockwise())
                             && (l_zone == std::numeric_limits<uint16_t>::max() || l_zone != st.local_traffic_zone)
                             && visitor.comp(workingDt, best_labels_pts[jpp.sp_idx])
-                            && valid_stop_points[jpp.sp_idx.val])  // we need to check the accessibility
-                        {
-                            working_labels.mut_dt_pt(jpp.sp_idx) = workingDt;
+                            && valid_stop_points[jpp.sp_idx.val]  // we need to check the accessibility
+                            && !(prune && is_pruned(visitor, jpp.sp_idx, workingDt))) {
+                            working_labels.set_dt_pt(jpp.sp_idx, workingDt);
                             best_labels_pts[jpp.sp_idx] = working_labels.dt_pt(jpp.sp_idx);
+                            // only the targets (and the stop points next to them) have a null lower bound
+                            if (prune && target_lower_bounds[jpp.sp_idx] == 0) {
+                                update_target_bound(visitor.clockwise());
+                            }
                             continue_algorithm = true;
                         }
                     }
@@ -748,9 +973,31 @@ void RAPTOR::raptor_loop(Visitor visitor, const nt::RTLevel rt_level, uint32_t m
             q_elt.second = visitor.init_queue_item();
         }
         continue_algorithm = continue_algorithm && this->foot_path(visitor);
+        if (!range_best_labels.empty()) {
+            keep_range_best_labels();
+        }
     }
 }
 
+void RAPTOR::merge_range_best_labels(const bool clockwise) {
+    const auto merge = [&](const IdxMap<type::StopPoint, DateTime>& kept, IdxMap<type::StopPoint, DateTime>& best) {
+        for (const auto sp_dt : kept) {
+            if (clockwise ? sp_dt.second < best[sp_dt.first] : sp_dt.second > best[sp_dt.first]) {
+                best[sp_dt.first] = sp_dt.second;
+            }
+        }
+    };
+    merge(range_best_labels[count].pts, best_labels_pts);
+    merge(range_best_labels[count].transfers, best_labels_transfers);
+}
+
+void RAPTOR::keep_range_best_labels() {
+    // called after merge_range_best_labels: the best labels are at least as good as the kept ones
+    auto& kept = range_best_labels[count];
+    kept.pts = best_labels_pts;
+    kept.transfers = best_labels_transfers;
+}
+
 void RAPTOR::boucleRAPTOR(const bool clockwise, const nt::RTLevel rt_level, uint32_t max_transfers) {
     if (clockwise) {
         raptor_loop(raptor_visitor(), rt_level, max_transfers);
@@ -786,6 +1033,27 @@ std::vector<Path> RAPTOR::compute(const type::StopArea* departure,
                        direct_path_dur);
 }
 
+void RAPTOR::run_on_workers(size_t nb_threads,
+                            size_t nb_tasks,
+                            const std::function<void(RAPTOR&, size_t)>& task) {
+    thread_pool->run(nb_threads, nb_tasks, [&](size_t thread_rank, size_t i) {
+        task(thread_rank == 0 ? *this : *snd_pass_workers.at(thread_rank - 1), i);
+    });
+}
+
+void RAPTOR::prepare_snd_pass_workers(const size_t nb_threads) {
+    while (snd_pass_workers.size() + 1 < nb_threads) {
+        snd_pass_workers.push_back(std::make_unique<RAPTOR>(data));
+    }
+    for (size_t i = 0; i + 1 < nb_threads; ++i) {
+        auto& worker = snd_pass_workers[i];
+        worker->next_st = next_st;
+        worker->valid_journey_patterns = valid_journey_patterns;
+        worker->jpps_from_sp = jpps_from_sp;
+        worker->valid_stop_points = valid_stop_points;
+    }
+}
+
 int RAPTOR::best_round(SpIdx sp_idx) {
     for (size_t i = 0; i <= this->count; ++i) {
         if (labels[i].dt_pt(sp_idx) == best_labels_pts[sp_idx]) {
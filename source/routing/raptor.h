@@ -47,17 +47,23 @@ www.navitia.io
 #include "utils/timer.h"
 #include "dataraptor.h"
 #include "raptor_utils.h"
+#include "thread_pool.h"
 
 #include "dataraptor.h"
 #include <unordered_map>
 #include <queue>
 #include <limits>
+#include <functional>
+#include <memory>
 
 namespace navitia {
 namespace routing {
 
 DateTime limit_bound(const bool clockwise, const DateTime departure_datetime, const DateTime bound);
 
+/// The nearest rank percentile (in [0, 100]) of the durations, DateTimeUtils::inf if empty
+DateTime duration_percentile(std::vector<DateTime> durations, const double percentile);
+
 struct StartingPointSndPhase {
     SpIdx sp_idx;
     unsigned count;
@@ -66,6 +72,12 @@ struct StartingPointSndPhase {
     bool has_priority;
 };
 
+struct SndPassStats {
+    size_t nb_starting_points = 0;
+    size_t nb_snd_pass = 0;  // starting points whose journeys have been kept
+    size_t nb_discarded = 0;  // computed in parallel, but made useless by the previous ones of their batch
+};
+
 /** Worker Raptor : une instance par thread, les données sont modifiées par le calcul */
 struct RAPTOR {
     typedef std::list<Journey> Journeys;
@@ -76,36 +88,79 @@ struct RAPTOR {
 
     /// Contains the different labels used by raptor.
     /// Each element of index i in this vector represents the labels with i transfers
+    /// The rounds are allocated on demand, according to the max_transfers of the requests
+    /// They are shared by the searches of both directions (see Labels::clear)
     std::vector<Labels> labels;
-    std::vector<Labels> first_pass_labels;
     /// Contains the best arrival (or departure time) for each stoppoint
     IdxMap<type::StopPoint, DateTime> best_labels_pts;
     IdxMap<type::StopPoint, DateTime> best_labels_transfers;
 
+    struct RoundBestLabels {
+        IdxMap<type::StopPoint, DateTime> pts;
+        IdxMap<type::StopPoint, DateTime> transfers;
+    };
+    /// Range raptor (isochrone_profile): range_best_labels[i] are the best labels with at most i rounds of the
+    /// departure datetimes already done, they are kept from one departure datetime to the next one.
+    /// Empty for the other searches
+    std::vector<RoundBestLabels> range_best_labels;
+
     /// Number of transfers done for the moment
     unsigned int count;
     /// Are the journey pattern valid
     boost::dynamic_bitset<> valid_journey_patterns;
-    dataRAPTOR::JppsFromSp jpps_from_sp;
+    /// The valid jpps by stop point, shared with the second pass workers
+    std::shared_ptr<const dataRAPTOR::JppsFromSp> jpps_from_sp;
     /// Order of the first journey_pattern point of each journey_pattern
     IdxMap<JourneyPattern, int> Q;
 
     // set to store if the stop_point is valid
     boost::dynamic_bitset<> valid_stop_points;
 
-    explicit RAPTOR(const navitia::type::Data& data)
+    /// Number of threads running the backward searches of the second pass
+    size_t nb_snd_pass_threads;
+    /// The threads running the parallel parts of the requests, kept alive between the requests
+    std::shared_ptr<ThreadPool> thread_pool;
+    /// The RAPTOR used by the other threads of the pool, each one
+    /// with its own labels, kept from one request to another
+    std::vector<std::unique_ptr<RAPTOR>> snd_pass_workers;
+    /// Statistics of the last second pass
+    SndPassStats snd_pass_stats;
+
+    /// Prune the first pass of the journeys with dataRAPTOR::min_durations
+    bool target_pruning;
+    /// The targets of the current pruned search with their fallback duration, empty if the search isn't pruned
+    std::vector<std::pair<SpIdx, DateTime>> pruning_targets;
+    /// Lower bound of the duration between each stop point and the targets
+    IdxMap<type::StopPoint, DateTime> target_lower_bounds;
+    /// The bound of the current pruned search: the best label of a target not reached yet
+    DateTime pruning_bound;
+    /// The best arrival (with its fallback) among the reached targets: a label that can't improve it even
+    /// with its lower bound is useless
+    DateTime target_bound;
+
+    /// Without a thread_pool, the RAPTOR creates its own one of nb_snd_pass_threads threads
+    explicit RAPTOR(const navitia::type::Data& data,
+                    size_t nb_snd_pass_threads = 1,
+                    bool target_pruning = false,
+                    std::shared_ptr<ThreadPool> thread_pool = nullptr)
         : data(data),
           best_labels_pts(data.pt_data->stop_points),
           best_labels_transfers(data.pt_data->stop_points),
           count(0),
           valid_journey_patterns(data.dataRaptor->jp_container.nb_jps()),
+          jpps_from_sp(std::make_shared<const dataRAPTOR::JppsFromSp>()),
           Q(data.dataRaptor->jp_container.get_jps_values()),
-          valid_stop_points(data.pt_data->stop_points.size()) {
-        labels.assign(10, data.dataRaptor->labels_const);
-        first_pass_labels.assign(10, data.dataRaptor->labels_const);
-    }
+          valid_stop_points(data.pt_data->stop_points.size()),
+          nb_snd_pass_threads(std::max<size_t>(nb_snd_pass_threads, 1)),
+          thread_pool(thread_pool ? std::move(thread_pool) : std::make_shared<ThreadPool>(nb_snd_pass_threads)),
+          target_pruning(target_pruning),
+          target_lower_bounds(data.pt_data->stop_points),
+          pruning_bound(DateTimeUtils::inf),
+          target_bound(DateTimeUtils::inf) {}
 
     void clear(const bool clockwise, const DateTime bound);
+    /// Clear the labels of the rounds and the queue, but not the best labels
+    void clear_rounds(const bool clockwise);
 
     /// Initialize starting points
     void init(const map_stop_point_duration& dep,
@@ -160,6 +215,23 @@ struct RAPTOR {
                                   const boost::optional<navitia::time_duration>& direct_path_dur = boost::none,
                                   const size_t max_extra_second_pass = 0);
 
+    /// Gives the duration of the direct path, boost::none if there is none
+    using DirectPathDuration = std::function<boost::optional<navitia::time_duration>()>;
+
+    /// Same, the duration of the direct path is only asked for once the first pass is done, so that
+    /// it can be computed meanwhile
+    Journeys compute_all_journeys(const map_stop_point_duration& departures,
+                                  const map_stop_point_duration& destinations,
+                                  const DateTime& departure_datetime,
+                                  const nt::RTLevel rt_level,
+                                  const navitia::time_duration& transfer_penalty,
+                                  const DateTime& bound,
+                                  const uint32_t max_transfers,
+                                  const type::AccessibiliteParams& accessibilite_params,
+                                  bool clockwise,
+                                  const DirectPathDuration& direct_path_dur,
+                                  const size_t max_extra_second_pass = 0);
+
     template <class T>
     std::vector<Path> from_journeys_to_path(const T& journeys) const {
         std::vector<Path> result;
@@ -186,6 +258,45 @@ struct RAPTOR {
                    const bool clockwise = true,
                    const nt::RTLevel rt_level = nt::RTLevel::Base);
 
+    /// profile[sp][i]: duration to reach sp from departure_datetimes[i], DateTimeUtils::inf if not reached
+    using IsochroneProfile = IdxMap<type::StopPoint, std::vector<DateTime>>;
+
+    /** Isochrone for several departure datetimes (of a time window), as a range raptor.
+     *  The departure datetimes are processed from the latest to the earliest (the opposite if
+     *  not clockwise), keeping the best labels of each round: they are still reachable by waiting,
+     *  with as many rounds, so each search only explores what it improves.
+     *  The labels of the whole search are bounded by the worst departure datetime, each profile is
+     *  then cut like for isochrone(): b limited to a day after (before if not clockwise) its departure datetime.
+     */
+    IsochroneProfile isochrone_profile(
+        const map_stop_point_duration& departures,
+        const std::vector<DateTime>& departure_datetimes,
+        const DateTime& b = DateTimeUtils::min,
+        const uint32_t max_transfers = 10,
+        const type::AccessibiliteParams& accessibilite_params = type::AccessibiliteParams(),
+        const std::vector<std::string>& forbidden = std::vector<std::string>(),
+        const std::vector<std::string>& allowed = std::vector<std::string>(),
+        const bool clockwise = true,
+        const nt::RTLevel rt_level = nt::RTLevel::Base);
+
+    using MatrixRow = std::vector<boost::optional<navitia::time_duration>>;
+    using Matrix = std::vector<MatrixRow>;
+
+    /** Earliest arrival duration from each origin to each destination, boost::none if not reached.
+     *  Only the first pass is done for each origin, the origins are dispatched on nb_threads
+     *  threads of the pool (at most), between this planner and its workers, reusing their labels.
+     */
+    Matrix compute_matrix(const std::vector<map_stop_point_duration>& origins,
+                          const std::vector<map_stop_point_duration>& destinations,
+                          const DateTime& departure_datetime,
+                          const nt::RTLevel rt_level,
+                          const DateTime& bound = DateTimeUtils::inf,
+                          const uint32_t max_transfers = 10,
+                          const type::AccessibiliteParams& accessibilite_params = type::AccessibiliteParams(),
+                          const std::vector<std::string>& forbidden = std::vector<std::string>(),
+                          const std::vector<std::string>& allowed = std::vector<std::string>(),
+                          const size_t nb_threads = 1);
+
     /// Désactive les journey_patterns qui n'ont pas de vj valides la veille, le jour, et le lendemain du calcul
     /// Gère également les lignes, modes, journey_patterns et VJ interdits
     void set_valid_jp_and_jpp(uint32_t date,
@@ -210,12 +321,42 @@ struct RAPTOR {
                             const uint16_t l_zone,
                             DateTime base_dt);
 
+    /// Range raptor: improve the best labels of the current round with the ones of the previous departure
+    /// datetimes, and keep them for the next ones
+    void merge_range_best_labels(const bool clockwise);
+    void keep_range_best_labels();
+
     /// Main loop
     template <typename Visitor>
     void raptor_loop(Visitor visitor,
                      const nt::RTLevel rt_level,
                      uint32_t max_transfers = std::numeric_limits<uint32_t>::max());
 
+    /// Give the workers of the first nb_threads - 1 threads of the pool the filters and the cache of the
+    /// current request
+    void prepare_snd_pass_workers(size_t nb_threads);
+
+    /// Run task(raptor, i) for i in [0, nb_tasks) on at most nb_threads threads of the pool, raptor being
+    /// *this or the worker of the thread.  The workers must have been prepared for these threads.
+    /// The first exception thrown by a task is rethrown once they are all done
+    void run_on_workers(size_t nb_threads, size_t nb_tasks, const std::function<void(RAPTOR&, size_t)>& task);
+
+    /// Compute the lower bounds to the targets if target_pruning is enabled
+    void init_target_pruning(const map_stop_point_duration& targets, const bool clockwise, const DateTime bound);
+    void update_target_bound(const bool clockwise);
+
+    /// True if a label at this stop point can't improve the targets, even with its lower bound.
+    /// The comparison is strict, so every stop point of a journey reaching a target keeps its labels
+    /// and the second pass can still use them as bounds.
+    template <typename Visitor>
+    bool is_pruned(const Visitor& v, const SpIdx sp_idx, const DateTime dt) const {
+        const DateTime lower_bound = target_lower_bounds[sp_idx];
+        if (lower_bound == DateTimeUtils::inf || (!v.clockwise() && dt < lower_bound)) {
+            return true;
+        }
+        return v.comp(target_bound, v.combine(dt, lower_bound));
+    }
+
     /// Return the round that has found the best solution for this stop point
     /// Return -1 if no solution found
     int best_round(SpIdx sp_idx);
@@ -228,7 +369,8 @@ struct RAPTOR {
                            const DateTime& bound_limit,
                            const uint32_t max_transfers,
                            const type::AccessibiliteParams& accessibilite_params,
-                           const bool clockwise);
+                           const bool clockwise,
+                           const map_stop_point_duration& targets = map_stop_point_duration());
 
     ~RAPTOR() = default;
 };
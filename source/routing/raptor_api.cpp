@@ -44,6 +44,7 @@ www.navitia.io
 #include <boost/range/algorithm/count.hpp>
 
 #include <chrono>
+#include <future>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -125,9 +126,8 @@ static std::vector<Path> call_raptor(navitia::PbCreator& pb_creator,
                                      const std::vector<std::string>& forbidden_uri,
                                      const std::vector<std::string>& allowed_ids,
                                      const bool clockwise,
-                                     const boost::optional<navitia::time_duration>& direct_path_duration,
+                                     const RAPTOR::DirectPathDuration& direct_path_duration,
                                      const boost::optional<uint32_t>& min_nb_journeys,
-                                     const uint32_t nb_direct_path,
                                      const uint32_t max_duration,
                                      const uint32_t max_transfers,
                                      const size_t max_extra_second_pass,
@@ -174,6 +174,9 @@ static std::vector<Path> call_raptor(navitia::PbCreator& pb_creator,
 
             LOG4CPLUS_DEBUG(logger, "raptor found " << raptor_journeys.size() << " solutions");
 
+            // the direct path is known once raptor is done with its first pass
+            const uint32_t nb_direct_path = direct_path_duration() ? 1 : 0;
+
             // Remove direct path
             filter_direct_path(raptor_journeys);
 
@@ -1087,7 +1090,7 @@ boost::optional<routing::map_stop_point_duration> get_stop_points(const type::En
             }
             const auto admin = data.geo_ref->admins[it_admin->second];
 
-            for (auto stop_area : admin->main_stop_areas) {
+            for (auto stop_area : data.pt_data->get_main_stop_areas(*admin)) {
                 for (auto stop_point : stop_area->stop_point_list) {
                     add_free_stop_point(stop_point, concerned_path_finder, result);
                 }
@@ -1106,7 +1109,7 @@ boost::optional<routing::map_stop_point_duration> get_stop_points(const type::En
     // we need to check if the admin has zone odt
     const auto& admins = find_admins(ep, data);
     for (const auto* admin : admins) {
-        for (const auto* odt_admin_stop_point : admin->odt_stop_points) {
+        for (const auto* odt_admin_stop_point : data.pt_data->get_odt_stop_points(*admin)) {
             add_free_stop_point(odt_admin_stop_point, concerned_path_finder, result);
         }
     }
@@ -1259,12 +1262,12 @@ void make_pt_response(navitia::PbCreator& pb_creator,
     auto arrivals = make_map_stop_point_duration(destinations, raptor.data.pt_data->stop_points_map);
 
     // Call Raptor loop
-    const auto pathes =
-        call_raptor(pb_creator, raptor, departures, arrivals, datetimes, rt_level, transfer_penalty,
-                    accessibilite_params, forbidden, allowed, clockwise, direct_path_duration, min_nb_journeys,
-                    // nb_direct_path = 0 for distributed if direct_path_duration is none
-                    direct_path_duration ? 1 : 0, max_duration, max_transfers, max_extra_second_pass,
-                    night_bus_filter_max_factor, night_bus_filter_base_factor, timeframe_duration);
+    // no direct path is counted for distributed if direct_path_duration is none
+    const auto pathes = call_raptor(
+        pb_creator, raptor, departures, arrivals, datetimes, rt_level, transfer_penalty, accessibilite_params,
+        forbidden, allowed, clockwise, [&]() { return direct_path_duration; }, min_nb_journeys, max_duration,
+        max_transfers, max_extra_second_pass, night_bus_filter_max_factor, night_bus_filter_base_factor,
+        timeframe_duration);
 
     // Create pb response
     make_pt_pathes(pb_creator, pathes, depth);
@@ -1370,18 +1373,32 @@ void make_response(navitia::PbCreator& pb_creator,
     // Initialize street network
     worker.init(origin, {destination});
 
+    // The departure, arrival and direct path street network searches use their own path finder,
+    // so the arrival fallback and the direct path are computed in the background while this thread
+    // handles the departure fallback. Raptor only needs the direct path after its first pass, it goes on
+    // computing meanwhile.
+    auto destinations_future = std::async(std::launch::async, [&]() {
+        return get_stop_points(destination, raptor.data, worker, free_radius_to, true);
+    });
+    const auto direct_path_future =
+        std::async(std::launch::async, [&]() { return get_direct_path(worker, origin, destination); }).share();
+
     // Get stop points for departure and destination
     const auto departures = get_stop_points(origin, raptor.data, worker, free_radius_from);
-    const auto destinations = get_stop_points(destination, raptor.data, worker, free_radius_to, true);
+    const auto destinations = destinations_future.get();
 
     // case 1 : departure no exist
     if (!departures) {
+        // waited before any return, so that the errors of the direct path are raised by this request and the
+        // street network worker is free again
+        direct_path_future.get();
         pb_creator.fill_pb_error(pbnavitia::Error::unknown_object, "The entry point: " + origin.uri + " is not valid");
         return;
     }
 
     // case 2 : destination no exist
     if (!destinations) {
+        direct_path_future.get();
         pb_creator.fill_pb_error(pbnavitia::Error::unknown_object,
                                  "The entry point: " + destination.uri + " is not valid");
         return;
@@ -1389,8 +1406,8 @@ void make_response(navitia::PbCreator& pb_creator,
 
     // case 3 : departure or destination are emtpy
     if (departures->empty() || destinations->empty()) {
-        make_pathes(pb_creator, std::vector<Path>(), worker, get_direct_path(worker, origin, destination), origin,
-                    destination, datetimes, clockwise, depth);
+        make_pathes(pb_creator, std::vector<Path>(), worker, direct_path_future.get(), origin, destination, datetimes,
+                    clockwise, depth);
 
         if (pb_creator.empty_journeys()) {
             if (departures->empty() && destinations->empty()) {
@@ -1409,23 +1426,25 @@ void make_response(navitia::PbCreator& pb_creator,
 
     // classical case : We have departures and destinations
 
-    // Compute direct path
-    using OptTimeDur = boost::optional<navitia::time_duration>;
-    const auto direct_path = get_direct_path(worker, origin, destination);
-    const OptTimeDur direct_path_dur =
-        direct_path.path_items.empty() ? OptTimeDur()
-                                       : OptTimeDur(direct_path.duration / origin.streetnetwork_params.speed_factor);
-    const uint32_t nb_direct_path = direct_path.path_items.empty() ? 0 : 1;
+    // the duration of the direct path bounds the second pass of raptor, it is joined once the first pass is done
+    const auto direct_path_dur = [&]() {
+        using OptTimeDur = boost::optional<navitia::time_duration>;
+        const auto& direct_path = direct_path_future.get();
+        return direct_path.path_items.empty()
+                   ? OptTimeDur()
+                   : OptTimeDur(direct_path.duration / origin.streetnetwork_params.speed_factor);
+    };
 
     // Call Raptor loop
-    const auto pathes = call_raptor(
-        pb_creator, raptor, *departures, *destinations, datetimes, rt_level, transfer_penalty, accessibilite_params,
-        forbidden, allowed, clockwise, direct_path_dur, min_nb_journeys, nb_direct_path, max_duration, max_transfers,
-        max_extra_second_pass, night_bus_filter_max_factor, night_bus_filter_base_factor, timeframe_duration);
+    const auto pathes = call_raptor(pb_creator, raptor, *departures, *destinations, datetimes, rt_level,
+                                    transfer_penalty, accessibilite_params, forbidden, allowed, clockwise,
+                                    direct_path_dur, min_nb_journeys, max_duration, max_transfers,
+                                    max_extra_second_pass, night_bus_filter_max_factor, night_bus_filter_base_factor,
+                                    timeframe_duration);
 
     // Create pb response
-    make_pathes(pb_creator, pathes, worker, direct_path, origin, destination, datetimes, clockwise, free_radius_from,
-                free_radius_to, depth);
+    make_pathes(pb_creator, pathes, worker, direct_path_future.get(), origin, destination, datetimes, clockwise,
+                free_radius_from, free_radius_to, depth);
 
     // Add error field
     if (pb_creator.empty_journeys()) {
@@ -1624,10 +1643,69 @@ void make_graphical_isochrone(navitia::PbCreator& pb_creator,
     }
 }
 
+// Heat map of a time window: the percentile of the durations to each stop point over the departure datetimes
+static void make_heat_map_profile(navitia::PbCreator& pb_creator,
+                                  RAPTOR& raptor,
+                                  const type::EntryPoint& center,
+                                  const std::vector<uint64_t>& departure_datetimes,
+                                  const DateTime max_duration,
+                                  const uint32_t max_transfers,
+                                  const type::AccessibiliteParams& accessibilite_params,
+                                  const std::vector<std::string>& forbidden,
+                                  const std::vector<std::string>& allowed,
+                                  const bool clockwise,
+                                  const nt::RTLevel rt_level,
+                                  georef::StreetNetwork& worker,
+                                  const double& end_speed,
+                                  const navitia::type::Mode_e end_mode,
+                                  const uint32_t resolution,
+                                  const boost::optional<const type::EntryPoints&>& stop_points,
+                                  const size_t nb_threads,
+                                  const double percentile) {
+    // sorted from the worst datetime to the best one
+    const auto datetimes = parse_datetimes(raptor, departure_datetimes, pb_creator, clockwise);
+    if (pb_creator.has_error() || datetimes.empty() || pb_creator.has_response_type(pbnavitia::DATE_OUT_OF_BOUNDS)) {
+        return;
+    }
+    const auto departures = get_stop_points_if_not_already_done(center, raptor.data, worker, stop_points);
+    if (!departures) {
+        pb_creator.fill_pb_error(pbnavitia::Error::unknown_object, "The entry point: " + center.uri + " is not valid");
+        return;
+    }
+    if (worker.geo_ref.nb_vertex_by_mode == 0) {
+        pb_creator.fill_pb_error(pbnavitia::Error::no_solution, pbnavitia::NO_SOLUTION,
+                                 "no street network data, impossible to compute a heat_map");
+        return;
+    }
+
+    std::vector<DateTime> init_dts;
+    for (const auto& datetime : datetimes) {
+        init_dts.push_back(to_datetime(datetime, raptor.data));
+    }
+    const auto bound = build_bound(clockwise, max_duration, init_dts.front());
+    const auto profile = raptor.isochrone_profile(*departures, init_dts, bound, max_transfers, accessibilite_params,
+                                                  forbidden, allowed, clockwise, rt_level);
+    StopPointDurations sp_durations(raptor.data.pt_data->stop_points, DateTimeUtils::inf);
+    for (const auto sp_profile : profile) {
+        auto durations = sp_profile.second;
+        for (auto& duration : durations) {
+            if (duration > max_duration) {
+                duration = DateTimeUtils::inf;
+            }
+        }
+        sp_durations[sp_profile.first] = duration_percentile(std::move(durations), percentile);
+    }
+
+    auto heat_map = build_raster_isochrone(worker.geo_ref, end_speed, end_mode, raptor.data.pt_data->stop_points,
+                                           sp_durations, center.coordinates, max_duration, resolution, nb_threads,
+                                           raptor.thread_pool.get());
+    add_heat_map(heat_map, pb_creator, center, clockwise, datetimes.back());
+}
+
 void make_heat_map(navitia::PbCreator& pb_creator,
                    RAPTOR& raptor,
                    const type::EntryPoint& center,
-                   const uint64_t departure_datetime,
+                   const std::vector<uint64_t>& departure_datetimes,
                    const DateTime max_duration,
                    const uint32_t max_transfers,
                    const type::AccessibiliteParams& accessibilite_params,
@@ -1639,10 +1717,22 @@ void make_heat_map(navitia::PbCreator& pb_creator,
                    const double& end_speed,
                    const navitia::type::Mode_e end_mode,
                    const uint32_t resolution,
-                   const boost::optional<const type::EntryPoints&>& stop_points) {
-    const auto isochrone_common =
-        make_isochrone_common(raptor, center, departure_datetime, max_duration, max_transfers, accessibilite_params,
-                              forbidden, allowed, clockwise, rt_level, worker, pb_creator, stop_points);
+                   const boost::optional<const type::EntryPoints&>& stop_points,
+                   const size_t nb_threads,
+                   const double percentile) {
+    if (departure_datetimes.size() > 1) {
+        make_heat_map_profile(pb_creator, raptor, center, departure_datetimes, max_duration, max_transfers,
+                              accessibilite_params, forbidden, allowed, clockwise, rt_level, worker, end_speed,
+                              end_mode, resolution, stop_points, nb_threads, percentile);
+        return;
+    }
+    if (departure_datetimes.empty()) {
+        pb_creator.fill_pb_error(pbnavitia::Error::bad_format, "no departure datetime for the heat_map");
+        return;
+    }
+    const auto isochrone_common = make_isochrone_common(raptor, center, departure_datetimes.front(), max_duration,
+                                                        max_transfers, accessibilite_params, forbidden, allowed,
+                                                        clockwise, rt_level, worker, pb_creator, stop_points);
     if (!isochrone_common) {
         return;
     }
@@ -1656,9 +1746,72 @@ void make_heat_map(navitia::PbCreator& pb_creator,
 
     auto heat_map = build_raster_isochrone(worker.geo_ref, end_speed, end_mode, isochrone_common->init_dt, raptor,
                                            isochrone_common->coord_origin, max_duration, clockwise,
-                                           isochrone_common->bound, resolution);
+                                           isochrone_common->bound, resolution, nb_threads);
     add_heat_map(heat_map, pb_creator, center, clockwise, isochrone_common->datetime);
 }
 
+void make_pt_routing_matrix(navitia::PbCreator& pb_creator,
+                            RAPTOR& raptor,
+                            const std::vector<type::EntryPoint>& origins,
+                            const std::vector<type::EntryPoint>& destinations,
+                            const uint64_t departure_datetime,
+                            const DateTime max_duration,
+                            const uint32_t max_transfers,
+                            const type::AccessibiliteParams& accessibilite_params,
+                            const std::vector<std::string>& forbidden,
+                            const std::vector<std::string>& allowed,
+                            const nt::RTLevel rt_level,
+                            georef::StreetNetwork& worker,
+                            const size_t nb_threads) {
+    const auto datetimes = parse_datetimes(raptor, {departure_datetime}, pb_creator, true);
+    if (pb_creator.has_error() || datetimes.empty() || pb_creator.has_response_type(pbnavitia::DATE_OUT_OF_BOUNDS)) {
+        return;
+    }
+    const auto init_dt = to_datetime(datetimes.front(), raptor.data);
+
+    std::vector<map_stop_point_duration> origins_sps;
+    origins_sps.reserve(origins.size());
+    for (const auto& origin : origins) {
+        worker.init(origin);
+        const auto sps = get_stop_points(origin, raptor.data, worker);
+        if (!sps) {
+            pb_creator.fill_pb_error(pbnavitia::Error::unknown_object,
+                                     "The entry point: " + origin.uri + " is not valid");
+            return;
+        }
+        origins_sps.push_back(*sps);
+    }
+    std::vector<map_stop_point_duration> destinations_sps;
+    destinations_sps.reserve(destinations.size());
+    for (const auto& destination : destinations) {
+        // the fallbacks of a destination are computed by the arrival path finder
+        worker.init(destination, destination);
+        const auto sps = get_stop_points(destination, raptor.data, worker, 0, true);
+        if (!sps) {
+            pb_creator.fill_pb_error(pbnavitia::Error::unknown_object,
+                                     "The entry point: " + destination.uri + " is not valid");
+            return;
+        }
+        destinations_sps.push_back(*sps);
+    }
+
+    const auto bound = build_bound(true, max_duration, init_dt);
+    const auto matrix = raptor.compute_matrix(origins_sps, destinations_sps, init_dt, rt_level, bound, max_transfers,
+                                              accessibilite_params, forbidden, allowed, nb_threads);
+    for (const auto& row : matrix) {
+        auto* pb_row = pb_creator.mutable_sn_routing_matrix()->add_rows();
+        for (const auto& duration : row) {
+            auto* routing_response = pb_row->add_routing_response();
+            if (duration) {
+                routing_response->set_duration(duration->total_seconds());
+                routing_response->set_routing_status(pbnavitia::RoutingStatus::reached);
+            } else {
+                routing_response->set_duration(0);
+                routing_response->set_routing_status(pbnavitia::RoutingStatus::unreached);
+            }
+        }
+    }
+}
+
 }  // namespace routing
 }  // namespace navitia
@@ -207,10 +207,16 @@ void make_graphical_isochrone(navitia::PbCreator& pb_creator,
                               const double& speed,
                               const boost::optional<const type::EntryPoints&>& stop_points = boost::none);
 
+/**
+ * @brief Heat map of the durations from (to if not clockwise) the center
+ *
+ * With several departure datetimes, the heat map of a time window: the durations to the stop points are the
+ * percentile of their durations from each departure datetime, computed by RAPTOR::isochrone_profile.
+ */
 void make_heat_map(navitia::PbCreator& pb_creator,
                    RAPTOR& raptor,
                    const type::EntryPoint& center,
-                   const uint64_t departure_datetime,
+                   const std::vector<uint64_t>& departure_datetimes,
                    const DateTime max_duration,
                    const uint32_t max_transfers,
                    const type::AccessibiliteParams& accessibilite_params,
@@ -222,7 +228,29 @@ void make_heat_map(navitia::PbCreator& pb_creator,
                    const double& end_speed,
                    const navitia::type::Mode_e end_mode,
                    const uint32_t resolution,
-                   const boost::optional<const type::EntryPoints&>& stop_points = boost::none);
+                   const boost::optional<const type::EntryPoints&>& stop_points = boost::none,
+                   const size_t nb_threads = 1,
+                   const double percentile = 50);
+
+/**
+ * @brief Public transport durations from each origin to each destination, leaving at departure_datetime
+ *
+ * The fallbacks of each place are computed with its streetnetwork_params, the matrix is then
+ * computed by RAPTOR::compute_matrix on nb_threads threads and filled as a street network matrix.
+ */
+void make_pt_routing_matrix(navitia::PbCreator& pb_creator,
+                            RAPTOR& raptor,
+                            const std::vector<type::EntryPoint>& origins,
+                            const std::vector<type::EntryPoint>& destinations,
+                            const uint64_t departure_datetime,
+                            const DateTime max_duration,
+                            const uint32_t max_transfers,
+                            const type::AccessibiliteParams& accessibilite_params,
+                            const std::vector<std::string>& forbidden,
+                            const std::vector<std::string>& allowed,
+                            const nt::RTLevel rt_level,
+                            georef::StreetNetwork& worker,
+                            const size_t nb_threads = 1);
 
 void make_pathes(PbCreator& pb_creator,
                  const std::vector<navitia::routing::Path>& paths,
@@ -535,7 +535,7 @@ struct RaptorSolutionReader {
                       Transfers& transfers) {
         const unsigned transfer_t = v.clockwise() ? begin_dt - end_st_dt.second : end_st_dt.second - begin_dt;
         const DateTime begin_limit = raptor.labels[count].dt_pt(begin_sp_idx);
-        for (const auto& jpp : raptor.jpps_from_sp[begin_sp_idx]) {
+        for (const auto& jpp : (*raptor.jpps_from_sp)[begin_sp_idx]) {
             // trying to begin
             const auto begin_st_dt = raptor.next_st->next_stop_time(v.stop_event(), jpp.idx, begin_dt, v.clockwise());
             if (begin_st_dt.first == nullptr) {
@@ -569,7 +569,7 @@ struct RaptorSolutionReader {
 
     void begin_pt(const unsigned count, const SpIdx begin_sp_idx, const DateTime begin_dt) {
         const DateTime begin_limit = raptor.labels[count].dt_pt(begin_sp_idx);
-        for (const auto& jpp : raptor.jpps_from_sp[begin_sp_idx]) {
+        for (const auto& jpp : (*raptor.jpps_from_sp)[begin_sp_idx]) {
             // trying to begin
             const auto begin_st_dt = raptor.next_st->next_stop_time(v.stop_event(), jpp.idx, begin_dt, v.clockwise());
             if (begin_st_dt.first == nullptr) {
@@ -595,7 +595,8 @@ void read_solutions(const RAPTOR& raptor,
                     const type::RTLevel rt_level,
                     const type::AccessibiliteParams& accessibilite_params,
                     const navitia::time_duration& transfer_penalty,
-                    const StartingPointSndPhase& end_point) {
+                    const StartingPointSndPhase& end_point,
+                    const Solutions* known_solutions) {
     auto reader = RaptorSolutionReader<Visitor>(raptor, solutions, v, departure_datetime, deps, arrs, rt_level,
                                                 accessibilite_params, transfer_penalty, end_point);
 
@@ -615,7 +616,8 @@ void read_solutions(const RAPTOR& raptor,
                                         navitia::seconds(end_point.fallback_dur), count,
                                         raptor.data.dataRaptor->min_connection_time, transfer_penalty, v.clockwise());
 
-            if (reader.solutions.contains_better_than(j)) {
+            if (reader.solutions.contains_better_than(j)
+                || (known_solutions && known_solutions->contains_better_than(j))) {
                 continue;
             }
             try {
@@ -658,13 +660,14 @@ void read_solutions(const RAPTOR& raptor,
                     const type::RTLevel rt_level,
                     const type::AccessibiliteParams& accessibilite_params,
                     const navitia::time_duration& transfer_penalty,
-                    const StartingPointSndPhase& end_point) {
+                    const StartingPointSndPhase& end_point,
+                    const Solutions* known_solutions) {
     if (clockwise) {
         return read_solutions(raptor, solutions, raptor_reverse_visitor(), departure_datetime, deps, arrs, rt_level,
-                              accessibilite_params, transfer_penalty, end_point);
+                              accessibilite_params, transfer_penalty, end_point, known_solutions);
     }
     return read_solutions(raptor, solutions, raptor_visitor(), departure_datetime, deps, arrs, rt_level,
-                          accessibilite_params, transfer_penalty, end_point);
+                          accessibilite_params, transfer_penalty, end_point, known_solutions);
 }
 
 Path make_path(const Journey& journey, const type::Data& data) {
@@ -65,7 +65,9 @@ void read_solutions(const RAPTOR& raptor,
                     const type::RTLevel rt_level,
                     const type::AccessibiliteParams& accessibilite_params,
                     const navitia::time_duration& transfer_penalty,
-                    const StartingPointSndPhase& end_point);
+                    const StartingPointSndPhase& end_point,
+                    // other solutions, only used to prune the search
+                    const Solutions* known_solutions = nullptr);
 
 Path make_path(const Journey& journey, const type::Data& data);
 
@@ -35,6 +35,8 @@ www.navitia.io
 
 #include <boost/container/flat_map.hpp>
 
+#include <vector>
+
 namespace navitia {
 
 namespace type {
@@ -64,41 +66,87 @@ inline bool is_dt_initialized(const DateTime dt) {
     return dt != DateTimeUtils::inf && dt != DateTimeUtils::min;
 }
 
+/*
+ * Arrival (or departure) datetimes of a raptor round, by stop point
+ *
+ * The public transport and the transfer datetimes of a stop point are stored
+ * side by side, as they are often read together.
+ *
+ * A Labels is reset to its clean state (all inf or all min, see init_inf and
+ * init_min) after each request.  A request only reaches a small part of the
+ * stop points, so instead of copying the whole clean Labels we only reset the
+ * stop points modified since the previous clear.
+ *
+ * The datetimes of a Labels cleaned with min are stored complemented, so that
+ * a clean stop point is stored as inf in both kinds of Labels: a Labels can be
+ * cleaned with the other kind without resetting all its stop points, and the
+ * same Labels are used by the searches of both directions.
+ */
 struct Labels {
     inline friend void swap(Labels& lhs, Labels& rhs) {
-        swap(lhs.dt_pts, rhs.dt_pts);
-        swap(lhs.dt_transfers, rhs.dt_transfers);
+        using std::swap;
+        swap(lhs.dts, rhs.dts);
+        swap(lhs.modified, rhs.modified);
+        swap(lhs.mask, rhs.mask);
     }
     // initialize the structure according to the number of jpp
     inline void init_inf(const std::vector<type::StopPoint*>& stops) { init(stops, DateTimeUtils::inf); }
     // initialize the structure according to the number of jpp
     inline void init_min(const std::vector<type::StopPoint*>& stops) { init(stops, DateTimeUtils::min); }
     // clear the structure according to a given structure. Same as a
-    // copy without touching the boarding_jpp fields
-    inline void clear(const Labels& clean) {
-        dt_pts = clean.dt_pts;
-        dt_transfers = clean.dt_transfers;
+    // copy of clean, but only the modified stop points are copied if
+    // we were already cleared once.
+    // Returns the number of labels reset
+    inline size_t clear(const Labels& clean) {
+        size_t nb_reset = modified.size();
+        if (dts.size() == clean.dts.size()) {
+            for (const auto sp_idx : modified) {
+                dts[sp_idx] = clean.dts[sp_idx];
+            }
+        } else {
+            dts = clean.dts;
+            nb_reset = dts.size();
+        }
+        mask = clean.mask;
+        modified.clear();
+        return nb_reset;
     }
-    inline const DateTime& dt_transfer(SpIdx sp_idx) const { return dt_transfers[sp_idx]; }
-    inline const DateTime& dt_pt(SpIdx sp_idx) const { return dt_pts[sp_idx]; }
-    inline DateTime& mut_dt_transfer(SpIdx sp_idx) { return dt_transfers[sp_idx]; }
-    inline DateTime& mut_dt_pt(SpIdx sp_idx) { return dt_pts[sp_idx]; }
+    inline DateTime dt_transfer(SpIdx sp_idx) const { return dts[sp_idx].transfer ^ mask; }
+    inline DateTime dt_pt(SpIdx sp_idx) const { return dts[sp_idx].pt ^ mask; }
+    inline void set_dt_transfer(SpIdx sp_idx, const DateTime dt) { mut_dts(sp_idx).transfer = dt ^ mask; }
+    inline void set_dt_pt(SpIdx sp_idx, const DateTime dt) { mut_dts(sp_idx).pt = dt ^ mask; }
 
     inline bool pt_is_initialized(SpIdx sp_idx) const { return is_dt_initialized(dt_pt(sp_idx)); }
     inline bool transfer_is_initialized(SpIdx sp_idx) const { return is_dt_initialized(dt_transfer(sp_idx)); }
 
 private:
+    struct Dts {
+        // At what time can we reach this label with public transport
+        DateTime pt;
+        // At what time can we reach this label with a transfer
+        DateTime transfer;
+    };
+
     inline void init(const std::vector<type::StopPoint*>& stops, DateTime val) {
-        dt_pts.assign(stops, val);
-        dt_transfers.assign(stops, val);
+        mask = val ^ DateTimeUtils::inf;
+        dts.assign(stops, Dts{DateTimeUtils::inf, DateTimeUtils::inf});
+        modified.clear();
+    }
+    inline Dts& mut_dts(SpIdx sp_idx) {
+        auto& res = dts[sp_idx];
+        // a stop point that isn't clean anymore is already in modified
+        if (res.pt == DateTimeUtils::inf && res.transfer == DateTimeUtils::inf) {
+            modified.push_back(sp_idx);
+        }
+        return res;
     }
 
-    // All these vectors are indexed by sp_idx
-    //
-    // At what time can we reach this label with public transport
-    IdxMap<type::StopPoint, DateTime> dt_pts;
-    // At what time wan we reach this label with a transfer
-    IdxMap<type::StopPoint, DateTime> dt_transfers;
+    // indexed by sp_idx, the datetimes xor mask
+    IdxMap<type::StopPoint, Dts> dts;
+    // the stop points to reset on clear(), may contain duplicates
+    std::vector<SpIdx> modified;
+    // 0 for a Labels cleaned with inf, all bits set for one cleaned with min
+    DateTime mask = 0;
 };
 
 }  // namespace routing
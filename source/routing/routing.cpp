@@ -77,9 +77,10 @@ bool use_crow_fly(const type::EntryPoint& point,
         // we want a crowfly for all main_stop_areas of an admin,
         // even if the stop_area is not in the admin
         auto admin = data.geo_ref->admins[data.geo_ref->admin_map[point.uri]];
-        auto it = find_if(begin(admin->main_stop_areas), end(admin->main_stop_areas),
+        const auto& main_stop_areas = data.pt_data->get_main_stop_areas(*admin);
+        auto it = find_if(begin(main_stop_areas), end(main_stop_areas),
                           [stop_point](const type::StopArea* stop_area) { return stop_area == stop_point.stop_area; });
-        return it != end(admin->main_stop_areas);
+        return it != end(main_stop_areas);
     }
     // if the request is on any other type we don't want a crowfly section
     return false;
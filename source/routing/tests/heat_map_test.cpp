@@ -195,7 +195,12 @@ BOOST_AUTO_TEST_CASE(heat_map_test) {
     const auto body = R"(],"lines":[{"cell_lon":)";
     std::size_t found_body = isochrone.find(body);
     BOOST_CHECK(found_body != std::string::npos);
-    auto distances = init_distance(*b.data->geo_ref, stop_points, init_dt, raptor, mode, E, true, bound, speed);
+    // the same from the durations of the stop points, as for a time window
+    const auto sp_durations = make_stop_point_durations(raptor, init_dt, true, bound);
+    BOOST_CHECK_EQUAL(build_raster_isochrone(*b.data->geo_ref, speed, mode, stop_points, sp_durations, A,
+                                             max_duration, resolution),
+                      isochrone);
+    auto distances = init_distance(*b.data->geo_ref, stop_points, sp_durations, mode, E, speed);
     auto heat_map =
         fill_heat_map(box, height_step, width_step, *b.data->geo_ref, min_dist, max_duration, speed, distances, step);
     std::vector<navitia::time_duration> result;
@@ -210,4 +215,16 @@ BOOST_AUTO_TEST_CASE(heat_map_test) {
     for (size_t i = 3; i < result.size(); i++) {
         BOOST_CHECK(result[i].is_pos_infinity());
     }
+
+    // the rows are split between the threads of the pool, the result is the same
+    ThreadPool thread_pool(3);
+    for (const size_t nb_threads : {2, 3, 8}) {
+        const auto parallel_heat_map = fill_heat_map(box, height_step, width_step, *b.data->geo_ref, min_dist,
+                                                     max_duration, speed, distances, step, nb_threads, &thread_pool);
+        for (size_t i = 0; i < step; i++) {
+            for (size_t j = 0; j < step; j++) {
+                BOOST_CHECK_EQUAL(parallel_heat_map.body[i].second[j], heat_map.body[i].second[j]);
+            }
+        }
+    }
 }
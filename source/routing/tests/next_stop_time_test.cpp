@@ -2592,3 +2592,256 @@ BOOST_AUTO_TEST_CASE(freq_next_stop_time_with_distant_bounds) {
         BOOST_CHECK_EQUAL(st->stop_point->stop_area->name, spa2);
     }
 }
+
+/*
+ * A new Data generation is built with the vj B delayed
+ * The cache of the journey pattern of A must be shared with the previous generation
+ * during the warmup, the one of B must be rebuilt.
+ */
+BOOST_AUTO_TEST_CASE(cache_shared_between_data_generations) {
+    auto build = [](const DateTime b_delay, const std::string& a_validity_pattern = "11111111") {
+        auto b = std::make_unique<ed::builder>("20120614");
+        b->vj("A", a_validity_pattern)("stop1", 8000, 8050)("stop2", 8100, 8150);
+        b->vj("B")("stop3", 9000 + b_delay, 9050 + b_delay)("stop4", 9100 + b_delay, 9150 + b_delay);
+        b->finish();
+        b->data->pt_data->sort_and_index();
+        b->data->build_uri();
+        b->data->build_raptor();
+        return b;
+    };
+    const auto b = build(0);
+    const auto b_delayed = build(300);
+
+    const auto old_cache =
+        b->data->dataRaptor->cached_next_st_manager->load(DateTimeUtils::set(0, 0), nt::RTLevel::Base, {});
+    // the journey pattern caches are only built when used
+    for (const auto& sa : {"stop1", "stop3"}) {
+        old_cache->next_stop_time(StopEvent::pick_up, get_first_jpp_idx(*b, sa), DateTimeUtils::set(0, 7000), true);
+    }
+    BOOST_CHECK_EQUAL(old_cache->get_jp_caches()->nb_built(), 2);
+
+    b_delayed->data->warmup(*b->data);
+    const auto new_cache =
+        b_delayed->data->dataRaptor->cached_next_st_manager->load(DateTimeUtils::set(0, 0), nt::RTLevel::Base, {});
+
+    const auto get_jp_cache = [](const ed::builder& b, const CachedNextStopTime& cache, const std::string& sa) {
+        const auto jpp_idx = get_first_jpp_idx(b, sa);
+        const auto jp_idx = b.data->dataRaptor->jp_container.get(jpp_idx).jp_idx;
+        return cache.get_jp_caches()->get_if_built(jp_idx);
+    };
+    BOOST_CHECK(get_jp_cache(*b, *old_cache, "stop1") == get_jp_cache(*b_delayed, *new_cache, "stop1"));
+    // a cache is only shared with the journey pattern it has been built from, even on a signature collision
+    const auto get_jp = [](const ed::builder& b, const std::string& sa) -> const JourneyPattern& {
+        const auto& jp_container = b.data->dataRaptor->jp_container;
+        return jp_container.get(jp_container.get(get_first_jpp_idx(b, sa)).jp_idx);
+    };
+    const CachedNextStopTimeKey key(0, nt::RTLevel::Base, {});
+    BOOST_CHECK(get_jp_cache(*b, *old_cache, "stop1")->is_built_from(key, get_jp(*b_delayed, "stop1")));
+    BOOST_CHECK(!get_jp_cache(*b, *old_cache, "stop1")->is_built_from(key, get_jp(*b_delayed, "stop3")));
+    // same vjs, but other stop times
+    BOOST_CHECK(get_jp_cache(*b, *old_cache, "stop3")->is_built_from(key, get_jp(*b, "stop3")));
+    BOOST_CHECK(!get_jp_cache(*b, *old_cache, "stop3")->is_built_from(key, get_jp(*b_delayed, "stop3")));
+    // same vjs and stop times, but other validity patterns
+    const auto b_other_days = build(0, "11111100");
+    BOOST_CHECK(!get_jp_cache(*b, *old_cache, "stop1")->is_built_from(key, get_jp(*b_other_days, "stop1")));
+    // the validity patterns are only compared on the days of the cache
+    const CachedNextStopTimeKey later_key(5, nt::RTLevel::Base, {});
+    BOOST_CHECK(JpCachedNextStopTime::Source(later_key, get_jp(*b, "stop1"))
+                == JpCachedNextStopTime::Source(later_key, get_jp(*b_other_days, "stop1")));
+    // the delayed journey pattern will be rebuilt on demand
+    BOOST_CHECK(get_jp_cache(*b_delayed, *new_cache, "stop3") == nullptr);
+    BOOST_CHECK_EQUAL(new_cache->get_jp_caches()->nb_built(), 1);
+
+    // the shared cache gives the stop times of the new generation
+    const auto jpp1 = get_first_jpp_idx(*b_delayed, "stop1");
+    const type::StopTime* st;
+    DateTime dt;
+    std::tie(st, dt) = new_cache->next_stop_time(StopEvent::pick_up, jpp1, DateTimeUtils::set(0, 7000), true);
+    BOOST_REQUIRE(st != nullptr);
+    BOOST_CHECK_EQUAL(dt, DateTimeUtils::set(0, 8050));
+    BOOST_CHECK(st->vehicle_journey == b_delayed->data->pt_data->vehicle_journeys.front());
+
+    const auto jpp3 = get_first_jpp_idx(*b_delayed, "stop3");
+    std::tie(st, dt) = new_cache->next_stop_time(StopEvent::pick_up, jpp3, DateTimeUtils::set(0, 7000), true);
+    BOOST_REQUIRE(st != nullptr);
+    BOOST_CHECK_EQUAL(dt, DateTimeUtils::set(0, 9350));
+}
+
+BOOST_AUTO_TEST_CASE(cache_built_on_demand) {
+    ed::builder b("20120614");
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8100, 8150);
+    b.vj("B")("stop3", 9000, 9050)("stop4", 9100, 9150);
+    b.vj("C")("stop5", 10000, 10050)("stop6", 10100, 10150);
+    b.finish();
+    b.data->pt_data->sort_and_index();
+    b.data->build_uri();
+    b.data->build_raptor();
+
+    const auto cache =
+        b.data->dataRaptor->cached_next_st_manager->load(DateTimeUtils::set(0, 0), nt::RTLevel::Base, {});
+    const auto& jp_caches = *cache->get_jp_caches();
+    BOOST_CHECK_EQUAL(jp_caches.nb_jps(), 3);
+    BOOST_CHECK_EQUAL(jp_caches.nb_built(), 0);
+    BOOST_CHECK_EQUAL(jp_caches.memory_usage(), 0);
+
+    const auto jpp = get_first_jpp_idx(b, "stop3");
+    const auto res = cache->next_stop_time(StopEvent::pick_up, jpp, DateTimeUtils::set(0, 7000), true);
+    BOOST_REQUIRE(res.first != nullptr);
+    BOOST_CHECK_EQUAL(res.second, DateTimeUtils::set(0, 9050));
+    BOOST_CHECK_EQUAL(jp_caches.nb_built(), 1);
+    BOOST_CHECK(jp_caches.memory_usage() > 0);
+
+    // the journey pattern cache is built only once
+    cache->next_stop_time(StopEvent::drop_off, jpp, DateTimeUtils::set(0, 7000), true);
+    BOOST_CHECK_EQUAL(jp_caches.nb_built(), 1);
+    BOOST_CHECK_EQUAL(b.data->dataRaptor->cached_next_st_manager->memory_usage(), jp_caches.memory_usage());
+}
+
+BOOST_AUTO_TEST_CASE(cache_frequency_blocks) {
+    ed::builder b("20120614");
+    const DateTime start_time1 = 6000;
+    const DateTime end_time1 = 50000;
+    const DateTime start_time2 = 60000;
+    const DateTime end_time2 = DateTimeUtils::SECONDS_PER_DAY + 1000;
+    const uint32_t headway_sec = 500;
+    b.frequency_vj("A", start_time1, end_time1, headway_sec)("stop1", 8000)("stop2", 8100);
+    b.frequency_vj("A", start_time2, end_time2, headway_sec)("stop1", 8000)("stop2", 8100);
+    b.finish();
+    b.data->pt_data->sort_and_index();
+    b.data->build_uri();
+    b.data->build_raptor();
+
+    const auto cache =
+        b.data->dataRaptor->cached_next_st_manager->load(DateTimeUtils::set(0, 0), nt::RTLevel::Base, {});
+    const auto jpp1 = get_first_jpp_idx(b, "stop1");
+    const auto jpp2 = get_first_jpp_idx(b, "stop2");
+    const auto next = [&](const JppIdx& jpp, const StopEvent event, const DateTime dt, const bool clockwise) {
+        const auto res = cache->next_stop_time(event, jpp, dt, clockwise);
+        BOOST_REQUIRE(res.first != nullptr);
+        return res.second;
+    };
+
+    BOOST_CHECK_EQUAL(next(jpp1, StopEvent::pick_up, DateTimeUtils::set(0, start_time1 - 1), true),
+                      DateTimeUtils::set(0, start_time1));
+    BOOST_CHECK_EQUAL(next(jpp1, StopEvent::pick_up, DateTimeUtils::set(0, start_time1 + 1), true),
+                      DateTimeUtils::set(0, start_time1 + headway_sec));
+    BOOST_CHECK_EQUAL(next(jpp1, StopEvent::pick_up, DateTimeUtils::set(0, end_time1 + 1), true),
+                      DateTimeUtils::set(0, start_time2));
+    // the second vj of the day before is still running after midnight
+    BOOST_CHECK_EQUAL(next(jpp1, StopEvent::pick_up, DateTimeUtils::set(1, 500), true), DateTimeUtils::set(1, 600));
+    BOOST_CHECK_EQUAL(next(jpp1, StopEvent::pick_up, DateTimeUtils::set(1, 1001), true),
+                      DateTimeUtils::set(1, start_time1));
+
+    const auto second_arrival = start_time1 + 100 + headway_sec;
+    BOOST_CHECK_EQUAL(next(jpp2, StopEvent::drop_off, DateTimeUtils::set(0, second_arrival + 1), false),
+                      DateTimeUtils::set(0, second_arrival));
+    BOOST_CHECK_EQUAL(next(jpp2, StopEvent::drop_off, DateTimeUtils::set(0, start_time2 + 99), false),
+                      DateTimeUtils::set(0, end_time1 + 100));
+    BOOST_CHECK_EQUAL(next(jpp2, StopEvent::drop_off, DateTimeUtils::set(1, 5000), false),
+                      DateTimeUtils::set(1, 600 + 100));
+
+    // the occurrences are not enumerated, one block by vj and by day
+    const auto& jpp = b.data->dataRaptor->jp_container.get(jpp1);
+    const auto& jp_cache = cache->get_jp_caches()->get(*b.data->dataRaptor, jpp.jp_idx);
+    BOOST_CHECK(jp_cache.departure[jpp.order].empty());
+    BOOST_CHECK_LE(jp_cache.freq_departure[jpp.order].size(), 6);
+}
+
+/*
+ * A vj running all day keeps the max_last of the blocks above any requested
+ * datetime, the lookups then go back to the first block of the jpp and must
+ * still give the same occurrences as the uncached next stop times
+ */
+BOOST_AUTO_TEST_CASE(cache_frequency_blocks_with_a_vj_running_all_day) {
+    ed::builder b("20120614");
+    b.frequency_vj("A", 0, 86000, 3600)("stop1", 8000)("stop2", 8100);
+    b.frequency_vj("A", 36000, 40000, 500)("stop1", 8000)("stop2", 8100);
+    b.frequency_vj("A", 50000, 51000, 100)("stop1", 8000)("stop2", 8100);
+    b.finish();
+    b.data->pt_data->sort_and_index();
+    b.data->build_uri();
+    b.data->build_raptor();
+
+    const auto cache =
+        b.data->dataRaptor->cached_next_st_manager->load(DateTimeUtils::set(0, 0), nt::RTLevel::Base, {});
+    NextStopTime next_st(*b.data);
+    const auto jpp1 = get_first_jpp_idx(b, "stop1");
+    const auto jpp2 = get_first_jpp_idx(b, "stop2");
+
+    for (DateTime dt = 200; dt < 82000; dt += 250) {
+        const auto cached_dep = cache->next_stop_time(StopEvent::pick_up, jpp1, dt, true);
+        const auto dep = next_st.earliest_stop_time(StopEvent::pick_up, jpp1, dt, nt::RTLevel::Base, false);
+        BOOST_REQUIRE(cached_dep.first != nullptr);
+        BOOST_CHECK_EQUAL(cached_dep.second, dep.second);
+
+        const auto cached_arr = cache->next_stop_time(StopEvent::drop_off, jpp2, dt, false);
+        const auto arr = next_st.tardiest_stop_time(StopEvent::drop_off, jpp2, dt, nt::RTLevel::Base, false);
+        BOOST_REQUIRE(cached_arr.first != nullptr);
+        BOOST_CHECK_EQUAL(cached_arr.second, arr.second);
+    }
+}
+
+/*
+ * The frequency index of a jpp gives the same occurrences as a loop on every
+ * frequency vj of the journey pattern, with overlapping, overnight and not
+ * always valid vjs
+ */
+BOOST_AUTO_TEST_CASE(frequency_index_gives_the_same_occurrences_as_the_vjs) {
+    ed::builder b("20120614");
+    b.frequency_vj("A", 0, 86000, 3600)("stop1", 8000)("stop2", 8100);
+    b.frequency_vj("A", 36000, 40000, 500, "", "0110")("stop1", 8000)("stop2", 8100);
+    b.frequency_vj("A", 38000, 39000, 100, "", "1010")("stop1", 8000)("stop2", 8100);
+    b.frequency_vj("A", 50000, 51000, 100, "", "0101")("stop1", 8000)("stop2", 8100);
+    b.frequency_vj("A", 80000, DateTimeUtils::SECONDS_PER_DAY + 3000, 700, "", "0011")("stop1", 8000)(
+        "stop2", 8100);
+    b.finish();
+    b.data->pt_data->sort_and_index();
+    b.data->build_uri();
+    b.data->build_raptor();
+
+    const auto& jp_container = b.data->dataRaptor->jp_container;
+    NextStopTime next_st(*b.data);
+    const auto jpp1 = get_first_jpp_idx(b, "stop1");
+    const auto jpp2 = get_first_jpp_idx(b, "stop2");
+    const auto occurrences = [&](const JppIdx jpp_idx, const StopEvent event, const DateTime base_dt) {
+        const auto& jpp = jp_container.get(jpp_idx);
+        std::vector<std::pair<DateTime, DateTime>> res;
+        for (const auto* vj : jp_container.get(jpp.jp_idx).freq_vjs) {
+            const auto& st = get_corresponding_stop_time(*vj, jpp.order);
+            res.emplace_back(get_next_stop_time(event, base_dt, *vj, st, nt::RTLevel::Base),
+                             get_previous_stop_time(event, base_dt, *vj, st, nt::RTLevel::Base));
+        }
+        return res;
+    };
+
+    for (DateTime dt = DateTimeUtils::set(1, 0); dt < DateTimeUtils::set(3, 0); dt += 250) {
+        const auto next_bound = DateTimeUtils::set(DateTimeUtils::date(dt) + 2, 0) - 1;
+        DateTime expected_next = DateTimeUtils::inf;
+        for (auto base_dt = dt; expected_next == DateTimeUtils::inf && base_dt <= next_bound;
+             base_dt = DateTimeUtils::set(DateTimeUtils::date(base_dt) + 1, 0)) {
+            for (const auto& next_previous : occurrences(jpp1, StopEvent::pick_up, base_dt)) {
+                if (next_previous.first <= next_bound) {
+                    expected_next = std::min(expected_next, next_previous.first);
+                }
+            }
+        }
+        const auto next = next_st.earliest_stop_time(StopEvent::pick_up, jpp1, dt, nt::RTLevel::Base,
+                                                     nt::VehicleProperties(), true, next_bound);
+        BOOST_CHECK_EQUAL(next.second, expected_next);
+
+        const auto previous_bound = DateTimeUtils::set(DateTimeUtils::date(dt) - 1, 0);
+        DateTime expected_previous = DateTimeUtils::not_valid;
+        for (auto base_dt = dt; expected_previous == DateTimeUtils::not_valid && base_dt >= previous_bound;
+             base_dt = DateTimeUtils::set(DateTimeUtils::date(base_dt) - 1, DateTimeUtils::SECONDS_PER_DAY - 1)) {
+            for (const auto& next_previous : occurrences(jpp2, StopEvent::drop_off, base_dt)) {
+                if (next_previous.second != DateTimeUtils::not_valid && next_previous.second >= previous_bound
+                    && (expected_previous == DateTimeUtils::not_valid || next_previous.second > expected_previous)) {
+                    expected_previous = next_previous.second;
+                }
+            }
+        }
+        const auto previous = next_st.tardiest_stop_time(StopEvent::drop_off, jpp2, dt, nt::RTLevel::Base,
+                                                         nt::VehicleProperties(), true, previous_bound);
+        BOOST_CHECK_EQUAL(previous.second, expected_previous);
+    }
+}
@@ -3552,3 +3552,462 @@ BOOST_AUTO_TEST_CASE(forbidden_uri_in_stay_in) {
     BOOST_CHECK_EQUAL(j.items[1].stop_points.back()->uri, "Stalingrad_2");
     BOOST_CHECK_EQUAL(j.items[2].stop_points.front()->uri, "Stalingrad_2");
 }
+
+BOOST_AUTO_TEST_CASE(labels_clear_only_modified_stop_points) {
+    const std::vector<type::StopPoint*> stop_points(3, nullptr);
+    Labels clean, clean_reverse, labels;
+    clean.init_inf(stop_points);
+    clean_reverse.init_min(stop_points);
+
+    labels.clear(clean);
+    labels.set_dt_pt(SpIdx(1), 42);
+    labels.set_dt_transfer(SpIdx(1), 43);
+    labels.set_dt_transfer(SpIdx(2), 44);
+    BOOST_CHECK_EQUAL(labels.dt_pt(SpIdx(1)), 42);
+    BOOST_CHECK_EQUAL(labels.dt_transfer(SpIdx(1)), 43);
+    BOOST_CHECK(!labels.pt_is_initialized(SpIdx(0)));
+    BOOST_CHECK(labels.transfer_is_initialized(SpIdx(2)));
+
+    labels.clear(clean);
+    for (const auto sp_idx : {SpIdx(0), SpIdx(1), SpIdx(2)}) {
+        BOOST_CHECK_EQUAL(labels.dt_pt(sp_idx), DateTimeUtils::inf);
+        BOOST_CHECK_EQUAL(labels.dt_transfer(sp_idx), DateTimeUtils::inf);
+    }
+
+    // cleaning with another kind of Labels only resets the modified stop points too
+    labels.set_dt_pt(SpIdx(0), 42);
+    BOOST_CHECK_EQUAL(labels.clear(clean_reverse), 1);
+    for (const auto sp_idx : {SpIdx(0), SpIdx(1), SpIdx(2)}) {
+        BOOST_CHECK_EQUAL(labels.dt_pt(sp_idx), DateTimeUtils::min);
+        BOOST_CHECK_EQUAL(labels.dt_transfer(sp_idx), DateTimeUtils::min);
+    }
+    labels.set_dt_transfer(SpIdx(2), 44);
+    BOOST_CHECK_EQUAL(labels.dt_transfer(SpIdx(2)), 44);
+    BOOST_CHECK(!labels.pt_is_initialized(SpIdx(2)));
+    BOOST_CHECK_EQUAL(labels.clear(clean), 1);
+    for (const auto sp_idx : {SpIdx(0), SpIdx(1), SpIdx(2)}) {
+        BOOST_CHECK_EQUAL(labels.dt_pt(sp_idx), DateTimeUtils::inf);
+        BOOST_CHECK_EQUAL(labels.dt_transfer(sp_idx), DateTimeUtils::inf);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(rounds_follow_max_transfers) {
+    ed::builder b("20120614");
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8100, 8150);
+    b.vj("B")("stop2", 8200, 8250)("stop3", 8300, 8350);
+    b.connection("stop2", "stop2", 10);
+    b.data->pt_data->sort_and_index();
+    b.finish();
+    b.data->build_uri();
+    b.data->build_raptor();
+    RAPTOR raptor(*b.data);
+    BOOST_CHECK(raptor.labels.empty());
+
+    auto res = raptor.compute(b.data->pt_data->stop_areas_map.at("stop1"), b.data->pt_data->stop_areas_map.at("stop3"),
+                              7900, 0, DateTimeUtils::inf, type::RTLevel::Base, 2_min, true, {}, 1);
+    BOOST_REQUIRE_EQUAL(res.size(), 1);
+    BOOST_CHECK_LE(raptor.labels.size(), 3);
+
+    // the labels of the first request don't leak in the second one
+    res = raptor.compute(b.data->pt_data->stop_areas_map.at("stop2"), b.data->pt_data->stop_areas_map.at("stop3"),
+                         8000, 0, DateTimeUtils::inf, type::RTLevel::Base, 2_min, true, {}, 1);
+    BOOST_REQUIRE_EQUAL(res.size(), 1);
+    BOOST_CHECK_EQUAL(res[0].items[0].stop_points[0]->uri, "stop2");
+    BOOST_CHECK_EQUAL(res[0].items[0].departure.time_of_day().total_seconds(), 8250);
+    BOOST_CHECK(!raptor.labels[1].pt_is_initialized(SpIdx(*b.data->pt_data->stop_points_map.at("stop1"))));
+}
+
+/*
+ * The first pass and the second pass share the same labels, the next request
+ * only resets the stop points reached by the previous one
+ */
+BOOST_AUTO_TEST_CASE(labels_reset_lazily_between_requests) {
+    ed::builder b("20120614");
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8100, 8150)("stop3", 8200, 8250);
+    // never reached by the requests
+    b.vj("B")("stop4", 9000, 9050)("stop5", 9100, 9150)("stop6", 9200, 9250)("stop7", 9300, 9350);
+    b.data->pt_data->sort_and_index();
+    b.finish();
+    b.data->build_uri();
+    b.data->build_raptor();
+    RAPTOR raptor(*b.data);
+    const auto nb_stop_points = b.data->pt_data->stop_points.size();
+    const auto& dataRaptor = *b.data->dataRaptor;
+
+    const auto compute = [&] {
+        const auto res =
+            raptor.compute(b.data->pt_data->stop_areas_map.at("stop1"), b.data->pt_data->stop_areas_map.at("stop3"),
+                           7900, 0, DateTimeUtils::inf, type::RTLevel::Base, 2_min, true, {}, 1);
+        BOOST_REQUIRE_EQUAL(res.size(), 1);
+    };
+    // what the next request would reset
+    const auto nb_reset = [&](std::vector<Labels>& rounds, const Labels& clean) {
+        size_t res = 0;
+        for (auto& round : rounds) {
+            const auto nb = round.clear(clean);
+            BOOST_CHECK_LT(nb, nb_stop_points);
+            res += nb;
+        }
+        return res;
+    };
+
+    compute();
+    compute();
+    BOOST_REQUIRE(!raptor.labels.empty());
+    // at most stop1, stop2 and stop3 in each round, the last search being the anticlockwise second pass
+    BOOST_CHECK_LE(nb_reset(raptor.labels, dataRaptor.labels_const), 3 * raptor.labels.size());
+}
+
+BOOST_AUTO_TEST_CASE(jp_filters_by_network_mode_and_accessibility) {
+    ed::builder b("20120614");
+    b.vj_with_network("network1", "A")("stop1", 8000, 8050)("stop2", 8100, 8150);
+    b.vj_with_network("network2", "B")("stop3", 9000, 9050)("stop4", 9100, 9150);
+    b.data->pt_data->sort_and_index();
+    b.finish();
+    b.data->build_uri();
+    for (auto* sp : b.data->pt_data->stop_points) {
+        sp->set_properties(type::Properties());
+    }
+    b.data->pt_data->stop_points_map.at("stop1")->set_property(type::hasProperties::ELEVATOR);
+    b.data->pt_data->stop_points_map.at("stop2")->set_property(type::hasProperties::ELEVATOR);
+    b.data->build_raptor();
+    RAPTOR raptor(*b.data);
+    const auto& d = *b.data->pt_data;
+    const auto nb_jpps = [&](const std::string& sp) {
+        return (*raptor.jpps_from_sp)[SpIdx(*d.stop_points_map.at(sp))].size();
+    };
+
+    raptor.set_valid_jp_and_jpp(0, {}, {"network1"}, {}, type::RTLevel::Base);
+    BOOST_CHECK_EQUAL(raptor.valid_journey_patterns.count(), 1);
+    BOOST_CHECK_EQUAL(nb_jpps("stop1"), 0);
+    BOOST_CHECK_EQUAL(nb_jpps("stop3"), 1);
+
+    raptor.set_valid_jp_and_jpp(0, {}, {}, {"network1"}, type::RTLevel::Base);
+    BOOST_CHECK_EQUAL(raptor.valid_journey_patterns.count(), 1);
+    BOOST_CHECK_EQUAL(nb_jpps("stop1"), 1);
+    BOOST_CHECK_EQUAL(nb_jpps("stop3"), 0);
+
+    std::vector<std::string> physical_modes;
+    for (const auto& jp : b.data->dataRaptor->jp_container.get_jps_values()) {
+        physical_modes.push_back(d.physical_modes[jp.phy_mode_idx.val]->uri);
+    }
+    raptor.set_valid_jp_and_jpp(0, {}, physical_modes, {}, type::RTLevel::Base);
+    BOOST_CHECK_EQUAL(raptor.valid_journey_patterns.count(), 0);
+
+    type::AccessibiliteParams accessibilite_params;
+    accessibilite_params.properties.set(type::hasProperties::ELEVATOR);
+    raptor.set_valid_jp_and_jpp(0, accessibilite_params, {}, {}, type::RTLevel::Base);
+    BOOST_CHECK_EQUAL(raptor.valid_journey_patterns.count(), 2);
+    BOOST_CHECK(raptor.valid_stop_points[d.stop_points_map.at("stop2")->idx]);
+    BOOST_CHECK(!raptor.valid_stop_points[d.stop_points_map.at("stop3")->idx]);
+    BOOST_CHECK_EQUAL(nb_jpps("stop1"), 1);
+    BOOST_CHECK_EQUAL(nb_jpps("stop4"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_second_pass_gives_the_same_journeys) {
+    ed::builder b("20120614");
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8100, 8150)("stop3", 8200, 8250);
+    b.vj("B")("stop1", 8300, 8350)("stop2", 8400, 8450)("stop3", 8500, 8550);
+    b.vj("C")("stop2", 8200, 8250)("stop4", 8600, 8650);
+    b.vj("D")("stop3", 8300, 8350)("stop4", 8500, 8550);
+    b.vj("E")("stop1", 8100, 8150)("stop4", 9500, 9550);
+    b.connection("stop2", "stop2", 10);
+    b.connection("stop3", "stop3", 10);
+    b.data->pt_data->sort_and_index();
+    b.finish();
+    b.data->build_uri();
+    b.data->build_raptor();
+    const auto& d = *b.data->pt_data;
+
+    const auto compute = [&](RAPTOR& raptor) {
+        map_stop_point_duration departures, arrivals;
+        departures[SpIdx(*d.stop_points_map.at("stop1"))] = 0_s;
+        arrivals[SpIdx(*d.stop_points_map.at("stop4"))] = 0_s;
+        return raptor.compute_all(departures, arrivals, DateTimeUtils::set(0, 7900), type::RTLevel::Base, 2_min,
+                                  DateTimeUtils::inf, 10, {}, {}, {}, true, boost::none, 10);
+    };
+    RAPTOR sequential_raptor(*b.data);
+    RAPTOR parallel_raptor(*b.data, 4);
+    const auto expected = compute(sequential_raptor);
+    BOOST_REQUIRE(!expected.empty());
+    // run twice to reuse the second pass workers
+    for (int i = 0; i < 2; ++i) {
+        const auto res = compute(parallel_raptor);
+        BOOST_REQUIRE_EQUAL(res.size(), expected.size());
+        for (size_t j = 0; j < res.size(); ++j) {
+            BOOST_CHECK_EQUAL(res[j].items.size(), expected[j].items.size());
+            BOOST_CHECK_EQUAL(res[j].items.front().departure, expected[j].items.front().departure);
+            BOOST_CHECK_EQUAL(res[j].items.back().arrival, expected[j].items.back().arrival);
+        }
+    }
+    BOOST_CHECK_EQUAL(parallel_raptor.snd_pass_workers.size(), 3);
+}
+
+/*
+ * sp5 gives the best journey, its starting point is the first one of the second pass.
+ * The starting points of sp3 and sp2 are made useless by this journey: the sequential
+ * second pass skips them, the parallel one computes them with sp5 and discards them.
+ */
+BOOST_AUTO_TEST_CASE(parallel_second_pass_with_pruning_gives_the_same_journeys) {
+    ed::builder b("20120614");
+    b.vj("A")("sp1", 8000, 8050)("sp2", 8100, 8150)("sp3", 8200, 8250)("sp4", 8300, 8350)("sp5", 8400, 8450);
+    b.data->pt_data->sort_and_index();
+    b.finish();
+    b.data->build_uri();
+    b.data->build_raptor();
+    const auto& d = *b.data->pt_data;
+    const auto sp = [&](const std::string& uri) { return SpIdx(*d.stop_points_map.at(uri)); };
+
+    const auto compute = [&](RAPTOR& raptor, const size_t max_extra_second_pass) {
+        map_stop_point_duration departures, arrivals;
+        departures[sp("sp1")] = 0_s;
+        arrivals[sp("sp2")] = 600_s;
+        arrivals[sp("sp3")] = 400_s;
+        arrivals[sp("sp4")] = 200_s;
+        arrivals[sp("sp5")] = 100_s;
+        return raptor.compute_all(departures, arrivals, DateTimeUtils::set(0, 7900), type::RTLevel::Base, 0_s,
+                                  DateTimeUtils::inf, 10, {}, {}, {}, true, boost::none, max_extra_second_pass);
+    };
+    RAPTOR sequential_raptor(*b.data);
+    RAPTOR parallel_raptor2(*b.data, 2);
+    RAPTOR parallel_raptor4(*b.data, 4);
+    for (const size_t max_extra_second_pass : {0, 1, 10}) {
+        const auto expected = compute(sequential_raptor, max_extra_second_pass);
+        BOOST_REQUIRE(!expected.empty());
+        const auto expected_stats = sequential_raptor.snd_pass_stats;
+        BOOST_CHECK_EQUAL(expected_stats.nb_starting_points, 4);
+        BOOST_CHECK_LT(expected_stats.nb_snd_pass, expected_stats.nb_starting_points);
+        BOOST_CHECK_EQUAL(expected_stats.nb_discarded, 0);
+
+        for (auto* raptor : {&parallel_raptor2, &parallel_raptor4}) {
+            const auto res = compute(*raptor, max_extra_second_pass);
+            BOOST_REQUIRE_EQUAL(res.size(), expected.size());
+            for (size_t j = 0; j < res.size(); ++j) {
+                BOOST_CHECK_EQUAL(res[j].items.size(), expected[j].items.size());
+                BOOST_CHECK_EQUAL(res[j].items.front().departure, expected[j].items.front().departure);
+                BOOST_CHECK_EQUAL(res[j].items.back().arrival, expected[j].items.back().arrival);
+                BOOST_CHECK_EQUAL(res[j].items.back().stop_points.back()->uri,
+                                  expected[j].items.back().stop_points.back()->uri);
+            }
+            BOOST_CHECK_EQUAL(raptor->snd_pass_stats.nb_snd_pass, expected_stats.nb_snd_pass);
+        }
+    }
+    // the whole second pass is a single batch with 4 threads
+    BOOST_CHECK_GT(parallel_raptor4.snd_pass_stats.nb_discarded, 0);
+}
+
+BOOST_AUTO_TEST_CASE(target_pruning_gives_the_same_journeys) {
+    ed::builder b("20120614");
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8100, 8150)("stop3", 8200, 8250);
+    b.vj("B")("stop1", 8300, 8350)("stop2", 8400, 8450)("stop3", 8500, 8550);
+    b.vj("C")("stop2", 8200, 8250)("stop4", 8600, 8650);
+    b.vj("D")("stop3", 8300, 8350)("stop4", 8500, 8550);
+    b.vj("E")("stop1", 8100, 8150)("stop4", 9500, 9550);
+    // a branch that can't lead to stop4
+    b.vj("F")("stop1", 8000, 8050)("stop5", 8100, 8150)("stop6", 8200, 8250);
+    // a branch that leads to stop4 too late
+    b.vj("G")("stop2", 8300, 8350)("stop7", 8400, 8450);
+    b.vj("H")("stop7", 8500, 8550)("stop4", 9900, 9950);
+    // a stop point that can't be reached from stop1
+    b.vj("I")("stop8", 7000, 7050)("stop9", 7100, 7150);
+    b.connection("stop2", "stop2", 10);
+    b.connection("stop3", "stop3", 10);
+    b.data->pt_data->sort_and_index();
+    b.finish();
+    b.data->build_uri();
+    b.data->build_raptor();
+    const auto& d = *b.data->pt_data;
+    const auto sp = [&](const std::string& uri) { return SpIdx(*d.stop_points_map.at(uri)); };
+
+    IdxMap<type::StopPoint, DateTime> lower_bounds(d.stop_points);
+    const auto& min_durations = b.data->dataRaptor->min_durations;
+    min_durations.lower_bounds({sp("stop4")}, true, lower_bounds);
+    BOOST_CHECK_EQUAL(lower_bounds[sp("stop4")], 0);
+    BOOST_CHECK_EQUAL(lower_bounds[sp("stop3")], 150);
+    BOOST_CHECK_EQUAL(lower_bounds[sp("stop2")], 200);
+    BOOST_CHECK_EQUAL(lower_bounds[sp("stop1")], 250);
+    BOOST_CHECK_EQUAL(lower_bounds[sp("stop5")], DateTimeUtils::inf);
+    min_durations.lower_bounds({sp("stop1")}, false, lower_bounds);
+    BOOST_CHECK_EQUAL(lower_bounds[sp("stop4")], 250);
+    BOOST_CHECK_EQUAL(lower_bounds[sp("stop6")], 100);
+
+    for (const bool clockwise : {true, false}) {
+        const auto compute = [&](RAPTOR& raptor) {
+            map_stop_point_duration departures, arrivals;
+            departures[sp("stop1")] = 0_s;
+            arrivals[sp("stop4")] = 0_s;
+            const auto dt = clockwise ? DateTimeUtils::set(0, 7900) : DateTimeUtils::set(0, 9600);
+            return raptor.compute_all(departures, arrivals, dt, type::RTLevel::Base, 2_min, DateTimeUtils::inf, 10,
+                                      {}, {}, {}, clockwise, boost::none, 10);
+        };
+        RAPTOR raptor(*b.data);
+        RAPTOR pruned_raptor(*b.data, 1, true);
+        const auto expected = compute(raptor);
+        BOOST_REQUIRE(!expected.empty());
+        const auto res = compute(pruned_raptor);
+        BOOST_REQUIRE_EQUAL(res.size(), expected.size());
+        for (size_t j = 0; j < res.size(); ++j) {
+            BOOST_CHECK_EQUAL(res[j].items.size(), expected[j].items.size());
+            BOOST_CHECK_EQUAL(res[j].items.front().departure, expected[j].items.front().departure);
+            BOOST_CHECK_EQUAL(res[j].items.back().arrival, expected[j].items.back().arrival);
+        }
+    }
+
+    // the dead branch isn't explored
+    RAPTOR pruned_raptor(*b.data, 1, true);
+    map_stop_point_duration departures, arrivals;
+    departures[sp("stop1")] = 0_s;
+    arrivals[sp("stop4")] = 0_s;
+    pruned_raptor.set_valid_jp_and_jpp(0, {}, {}, {}, type::RTLevel::Base);
+    pruned_raptor.first_raptor_loop(departures, DateTimeUtils::set(0, 7900), type::RTLevel::Base, DateTimeUtils::inf,
+                                    10, {}, true, arrivals);
+    BOOST_CHECK_EQUAL(pruned_raptor.best_labels_pts[sp("stop4")], DateTimeUtils::set(0, 8500));
+    BOOST_CHECK_EQUAL(pruned_raptor.best_labels_pts[sp("stop5")], DateTimeUtils::inf);
+    // stop4 is reached at 9500 by the first round, the second one can't improve it through stop7
+    BOOST_CHECK_EQUAL(pruned_raptor.best_labels_pts[sp("stop7")], DateTimeUtils::inf);
+    BOOST_CHECK(pruned_raptor.pruning_targets.empty());
+
+    // a target that isn't reached doesn't keep the others from pruning
+    arrivals[sp("stop8")] = 0_s;
+    pruned_raptor.first_raptor_loop(departures, DateTimeUtils::set(0, 7900), type::RTLevel::Base, DateTimeUtils::inf,
+                                    10, {}, true, arrivals);
+    BOOST_CHECK_EQUAL(pruned_raptor.best_labels_pts[sp("stop4")], DateTimeUtils::set(0, 8500));
+    BOOST_CHECK_EQUAL(pruned_raptor.best_labels_pts[sp("stop8")], DateTimeUtils::inf);
+    BOOST_CHECK_EQUAL(pruned_raptor.best_labels_pts[sp("stop7")], DateTimeUtils::inf);
+    BOOST_CHECK_EQUAL(pruned_raptor.target_bound, DateTimeUtils::set(0, 8500));
+
+    // the bound is the arrival with its fallback duration
+    arrivals[sp("stop4")] = 1000_s;
+    pruned_raptor.first_raptor_loop(departures, DateTimeUtils::set(0, 7900), type::RTLevel::Base, DateTimeUtils::inf,
+                                    10, {}, true, arrivals);
+    BOOST_CHECK_EQUAL(pruned_raptor.target_bound, DateTimeUtils::set(0, 9500));
+}
+
+BOOST_AUTO_TEST_CASE(isochrone_profile_gives_the_same_durations) {
+    ed::builder b("20120614");
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8100, 8150)("stop3", 8200, 8250);
+    b.vj("B")("stop1", 8300, 8350)("stop2", 8400, 8450)("stop3", 8500, 8550);
+    b.vj("C")("stop2", 8200, 8250)("stop4", 8600, 8650);
+    b.vj("D")("stop3", 8300, 8350)("stop4", 8500, 8550);
+    b.vj("E")("stop1", 8100, 8150)("stop4", 9500, 9550);
+    b.connection("stop2", "stop2", 10);
+    b.connection("stop3", "stop3", 10);
+    b.data->pt_data->sort_and_index();
+    b.finish();
+    b.data->build_uri();
+    b.data->build_raptor();
+    const auto& d = *b.data->pt_data;
+
+    map_stop_point_duration departures;
+    departures[SpIdx(*d.stop_points_map.at("stop1"))] = 0_s;
+    const std::vector<DateTime> departure_datetimes = {DateTimeUtils::set(0, 8000), DateTimeUtils::set(0, 7900),
+                                                       DateTimeUtils::set(0, 8200), DateTimeUtils::set(0, 8100),
+                                                       DateTimeUtils::set(0, 8400)};
+    RAPTOR raptor(*b.data);
+    const auto profile = raptor.isochrone_profile(departures, departure_datetimes, DateTimeUtils::inf);
+
+    RAPTOR isochrone_raptor(*b.data);
+    for (size_t i = 0; i < departure_datetimes.size(); ++i) {
+        isochrone_raptor.isochrone(departures, departure_datetimes[i], DateTimeUtils::inf);
+        for (const auto* sp : d.stop_points) {
+            const auto lbl = isochrone_raptor.best_labels_pts[SpIdx(*sp)];
+            const auto bound = limit_bound(true, departure_datetimes[i], DateTimeUtils::inf);
+            const auto expected = lbl < bound ? lbl - departure_datetimes[i] : DateTimeUtils::inf;
+            BOOST_CHECK_EQUAL(profile[SpIdx(*sp)][i], expected);
+        }
+    }
+    const auto& stop4 = profile[SpIdx(*d.stop_points_map.at("stop4"))];
+    BOOST_CHECK_EQUAL(stop4[1], 8500 - 7900);
+    BOOST_CHECK_EQUAL(stop4[4], DateTimeUtils::inf);
+    BOOST_CHECK_EQUAL(stop4[3], 9500 - 8100);
+    // reached the next day: within a day of this departure datetime, but not of the earliest one
+    const auto& stop2 = profile[SpIdx(*d.stop_points_map.at("stop2"))];
+    BOOST_CHECK_EQUAL(stop2[4], DateTimeUtils::SECONDS_PER_DAY + 8100 - 8400);
+    BOOST_CHECK_EQUAL(duration_percentile(stop4, 50), 9500 - 8100);
+    BOOST_CHECK_EQUAL(duration_percentile(stop4, 0), 8500 - 8000);
+    BOOST_CHECK_EQUAL(duration_percentile(stop4, 100), DateTimeUtils::inf);
+}
+
+// The later departure datetime reaches stop3 with one more transfer than the earlier one: range raptor
+// must keep the labels of each round, else stop4 is pruned for the earlier departure with max_transfers = 1
+BOOST_AUTO_TEST_CASE(isochrone_profile_keeps_the_labels_of_each_round) {
+    ed::builder b("20120614");
+    b.vj("A")("stop1", 8100, 8150)("stop2", 8200, 8250);
+    b.vj("B")("stop2", 8300, 8350)("stop3", 9000, 9050);
+    b.vj("C")("stop1", 8000, 8050)("stop3", 9000, 9050);
+    b.vj("D")("stop3", 9100, 9150)("stop4", 9200, 9250);
+    b.connection("stop2", "stop2", 10);
+    b.connection("stop3", "stop3", 10);
+    b.data->pt_data->sort_and_index();
+    b.finish();
+    b.data->build_uri();
+    b.data->build_raptor();
+    const auto& d = *b.data->pt_data;
+
+    map_stop_point_duration departures;
+    departures[SpIdx(*d.stop_points_map.at("stop1"))] = 0_s;
+    const std::vector<DateTime> departure_datetimes = {DateTimeUtils::set(0, 8000), DateTimeUtils::set(0, 8100)};
+    RAPTOR raptor(*b.data);
+    RAPTOR isochrone_raptor(*b.data);
+    for (const uint32_t max_transfers : {1, 10}) {
+        const auto profile =
+            raptor.isochrone_profile(departures, departure_datetimes, DateTimeUtils::inf, max_transfers);
+        for (size_t i = 0; i < departure_datetimes.size(); ++i) {
+            isochrone_raptor.isochrone(departures, departure_datetimes[i], DateTimeUtils::inf, max_transfers);
+            for (const auto* sp : d.stop_points) {
+                const auto lbl = isochrone_raptor.best_labels_pts[SpIdx(*sp)];
+                const auto bound = limit_bound(true, departure_datetimes[i], DateTimeUtils::inf);
+                const auto expected = lbl < bound ? lbl - departure_datetimes[i] : DateTimeUtils::inf;
+                BOOST_CHECK_EQUAL(profile[SpIdx(*sp)][i], expected);
+            }
+        }
+    }
+    const auto profile = raptor.isochrone_profile(departures, departure_datetimes, DateTimeUtils::inf, 1);
+    const auto& stop4 = profile[SpIdx(*d.stop_points_map.at("stop4"))];
+    BOOST_CHECK_EQUAL(stop4[0], 9200 - 8000);
+    BOOST_CHECK_EQUAL(stop4[1], DateTimeUtils::inf);
+}
+
+BOOST_AUTO_TEST_CASE(pt_matrix) {
+    ed::builder b("20120614");
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8100, 8150)("stop3", 8200, 8250);
+    b.vj("B")("stop3", 9000, 9050)("stop4", 9500, 9550);
+    b.connection("stop3", "stop3", 10);
+    b.data->pt_data->sort_and_index();
+    b.finish();
+    b.data->build_uri();
+    b.data->build_raptor();
+    const auto& d = *b.data->pt_data;
+    const auto sp = [&](const std::string& uri) { return SpIdx(*d.stop_points_map.at(uri)); };
+
+    const std::vector<map_stop_point_duration> origins = {{{sp("stop1"), 0_s}}, {{sp("stop2"), 10_s}},
+                                                          {{sp("stop4"), 0_s}}};
+    const std::vector<map_stop_point_duration> destinations = {{{sp("stop3"), 0_s}},
+                                                               {{sp("stop4"), 20_s}, {sp("stop3"), 5000_s}}};
+    const auto secs = [](const boost::optional<navitia::time_duration>& dur) {
+        BOOST_REQUIRE(dur);
+        return dur->total_seconds();
+    };
+    for (const size_t nb_threads : {1, 2, 4}) {
+        // the matrix threads don't depend on the threads of the second pass
+        RAPTOR raptor(*b.data, 1, false, std::make_shared<ThreadPool>(nb_threads));
+        const auto matrix = raptor.compute_matrix(origins, destinations, DateTimeUtils::set(0, 7900),
+                                                  nt::RTLevel::Base, DateTimeUtils::inf, 10, {}, {}, {}, nb_threads);
+        BOOST_REQUIRE_EQUAL(matrix.size(), 3);
+        BOOST_REQUIRE_EQUAL(matrix[0].size(), 2);
+        BOOST_CHECK_EQUAL(secs(matrix[0][0]), 8200 - 7900);
+        BOOST_CHECK_EQUAL(secs(matrix[0][1]), 9500 + 20 - 7900);
+        BOOST_CHECK_EQUAL(secs(matrix[1][0]), 8200 - 7900);
+        BOOST_CHECK_EQUAL(secs(matrix[1][1]), 9500 + 20 - 7900);
+        // nothing leaves stop4
+        BOOST_CHECK(!matrix[2][0]);
+        BOOST_CHECK_EQUAL(secs(matrix[2][1]), 20);
+    }
+    // with the bound of a request, the stop points that aren't reached keep that bound as label
+    RAPTOR raptor(*b.data);
+    const auto matrix = raptor.compute_matrix(origins, destinations, DateTimeUtils::set(0, 7900), nt::RTLevel::Base,
+                                              DateTimeUtils::set(1, 7900), 10);
+    BOOST_CHECK_EQUAL(secs(matrix[0][1]), 9500 + 20 - 7900);
+    BOOST_CHECK(!matrix[2][0]);
+    BOOST_CHECK_EQUAL(secs(matrix[2][1]), 20);
+}
@@ -1867,7 +1867,7 @@ BOOST_AUTO_TEST_CASE(use_crow_fly) {
     BOOST_CHECK(nr::use_crow_fly(ep, sp2, empty_sn_path, data));
     BOOST_CHECK(!nr::use_crow_fly(ep, sp2, filled_sn_path, data));
 
-    admin->main_stop_areas.push_back(&sa2);
+    data.pt_data->admin_main_stop_areas[admin->idx].push_back(&sa2);
     BOOST_CHECK(nr::use_crow_fly(ep, sp2, empty_sn_path, data));
     BOOST_CHECK(nr::use_crow_fly(ep, sp2, filled_sn_path, data));
 }
@@ -524,7 +524,7 @@ struct routing_api_data {
         b.data->pt_data->codes.add(sa, "UIC8", "80142281");
 
         // Add a main stop area to our admin
-        admin->main_stop_areas.push_back(b.data->pt_data->stop_areas_map["stopC"]);
+        b.data->pt_data->admin_main_stop_areas[admin->idx].push_back(b.data->pt_data->stop_areas_map["stopC"]);
 
         // Add a fare_zone in stop point A
         b.sps.begin()->second->fare_zone = "2";
@@ -0,0 +1,92 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE thread_pool_test
+
+#include "routing/thread_pool.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using namespace navitia::routing;
+
+BOOST_AUTO_TEST_CASE(every_task_runs_once) {
+    ThreadPool pool(4);
+    BOOST_CHECK_EQUAL(pool.size(), 4);
+    // the threads are reused from one run to another
+    for (int run = 0; run < 100; ++run) {
+        for (const size_t nb_threads : {1, 2, 4, 8}) {
+            std::vector<std::atomic<int>> nb_calls(37);
+            std::vector<size_t> ranks(nb_calls.size());
+            pool.run(nb_threads, nb_calls.size(), [&](size_t rank, size_t i) {
+                ++nb_calls[i];
+                ranks[i] = rank;
+            });
+            for (size_t i = 0; i < nb_calls.size(); ++i) {
+                BOOST_REQUIRE_EQUAL(nb_calls[i], 1);
+                BOOST_REQUIRE_LT(ranks[i], std::min<size_t>(nb_threads, pool.size()));
+            }
+        }
+    }
+    pool.run(4, 0, [](size_t, size_t) { BOOST_FAIL("no task to run"); });
+}
+
+BOOST_AUTO_TEST_CASE(one_thread_runs_on_the_caller) {
+    ThreadPool pool(1);
+    BOOST_CHECK_EQUAL(pool.size(), 1);
+    std::set<size_t> ranks;
+    std::vector<size_t> order;
+    pool.run(4, 5, [&](size_t rank, size_t i) {
+        ranks.insert(rank);
+        order.push_back(i);
+    });
+    BOOST_CHECK(ranks == std::set<size_t>{0});
+    BOOST_CHECK((order == std::vector<size_t>{0, 1, 2, 3, 4}));
+}
+
+BOOST_AUTO_TEST_CASE(errors_are_rethrown_by_run) {
+    ThreadPool pool(3);
+    BOOST_CHECK_THROW(pool.run(3, 10,
+                               [](size_t, size_t i) {
+                                   if (i == 4) {
+                                       throw std::runtime_error("task error");
+                                   }
+                               }),
+                      std::runtime_error);
+    // the pool is still usable
+    std::atomic<size_t> nb_calls{0};
+    pool.run(3, 10, [&](size_t, size_t) { ++nb_calls; });
+    BOOST_CHECK_EQUAL(nb_calls, 10);
+}
@@ -0,0 +1,130 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "routing/thread_pool.h"
+
+#include <algorithm>
+
+namespace navitia {
+namespace routing {
+
+ThreadPool::ThreadPool(const size_t nb_threads) {
+    for (size_t rank = 1; rank < nb_threads; ++rank) {
+        threads.emplace_back([this, rank]() { work(rank); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    start_cv.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::run(const size_t nb_threads, const size_t nb_tasks, const Task& task) {
+    if (nb_tasks == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->task = &task;
+        this->nb_tasks = nb_tasks;
+        next_task = 0;
+        max_thread_rank = std::min({std::max<size_t>(nb_threads, 1), size(), nb_tasks}) - 1;
+        nb_running = max_thread_rank;
+        error = nullptr;
+        ++run_id;
+    }
+    start_cv.notify_all();
+    run_tasks(0);
+
+    std::exception_ptr res;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done_cv.wait(lock, [&]() { return nb_running == 0; });
+        this->task = nullptr;
+        std::swap(res, error);
+    }
+    if (res) {
+        std::rethrow_exception(res);
+    }
+}
+
+void ThreadPool::work(const size_t thread_rank) {
+    uint64_t last_run_id = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            start_cv.wait(lock, [&]() { return stopped || run_id != last_run_id; });
+            if (stopped) {
+                return;
+            }
+            last_run_id = run_id;
+            if (thread_rank > max_thread_rank) {
+                // not needed by this run
+                continue;
+            }
+        }
+        run_tasks(thread_rank);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --nb_running;
+        }
+        done_cv.notify_one();
+    }
+}
+
+void ThreadPool::run_tasks(const size_t thread_rank) {
+    while (true) {
+        size_t i;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (error || next_task == nb_tasks) {
+                return;
+            }
+            i = next_task++;
+        }
+        try {
+            (*task)(thread_rank, i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+}
+
+}  // namespace routing
+}  // namespace navitia
@@ -0,0 +1,91 @@
+/* Copyright © 2001-2020, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace navitia {
+namespace routing {
+
+/*
+ * Threads kept alive between the requests of a kraken worker, to run the
+ * parallel parts of a request (the backward searches of the raptor second
+ * pass...) without creating threads for each of them.
+ *
+ * run() is blocking and the calling thread takes part in the tasks: a pool
+ * of n threads only creates n - 1 threads.  run() must not be called by
+ * several threads at once, nor from a task.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void(size_t thread_rank, size_t task)>;
+
+    explicit ThreadPool(size_t nb_threads);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // number of threads, the calling thread included
+    size_t size() const { return threads.size() + 1; }
+
+    // Run task(thread_rank, i) for every i in [0, nb_tasks) on at most nb_threads threads of the pool.
+    // thread_rank is in [0, nb_threads), 0 being the calling thread, so that a task can use the
+    // resources of its thread.  The first exception thrown by a task is rethrown once every thread
+    // is done, the tasks not started yet are then skipped.
+    void run(size_t nb_threads, size_t nb_tasks, const Task& task);
+
+private:
+    void work(size_t thread_rank);
+    void run_tasks(size_t thread_rank);
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    // the current run, protected by mutex
+    const Task* task = nullptr;
+    size_t nb_tasks = 0;
+    size_t next_task = 0;
+    size_t max_thread_rank = 0;
+    size_t nb_running = 0;  // threads of the pool still working on the run
+    uint64_t run_id = 0;
+    std::exception_ptr error;
+    bool stopped = false;
+};
+
+}  // namespace routing
+}  // namespace navitia
@@ -0,0 +1,22 @@
+"""Add parameter georef_version
+
+Revision ID: 3e1e4b0b5c2d
+Revises: 844a9fa86ad2
+Create Date: 2026-10-19 10:12:41.000000
+
+"""
+
+# revision identifiers, used by Alembic.
+revision = '3e1e4b0b5c2d'
+down_revision = '844a9fa86ad2'
+
+from alembic import op
+import sqlalchemy as sa
+
+
+def upgrade():
+    op.add_column('parameters', sa.Column('georef_version', sa.TEXT(), nullable=True), schema='navitia')
+
+
+def downgrade():
+    op.drop_column('parameters', 'georef_version', schema='navitia')
@@ -32,6 +32,7 @@ www.navitia.io
 #include "type/data.h"
 #include "kraken/data_manager.h"
 #include "kraken/kraken_zmq.h"
+#include "kraken/load_balancer.h"
 
 #include "ed/build_helper.h"
 #include <zmq.hpp>
@@ -64,9 +65,9 @@ struct mock_kraken {
                                                      boost::optional<bool>(true));  // not used
         auto other_options = conf.load_from_command_line(desc, argc, argv);
 
-        LoadBalancer lb(context);
-        lb.bind(conf.zmq_socket_path(), "inproc://workers");
         navitia::Metrics metric(boost::none, "mock");
+        navitia::kraken::PriorityLoadBalancer lb(context, conf, metric);
+        lb.bind(conf.zmq_socket_path(), "inproc://workers");
 
         // this option is not parsed by get_options_description because it is used only here
         if (std::find(other_options.begin(), other_options.end(), "spawn_maintenance_worker") != other_options.end()) {
@@ -72,7 +72,7 @@ namespace pt = boost::posix_time;
 namespace navitia {
 namespace type {
 
-const unsigned int Data::data_version = 3;  //< *INCREMENT* every time serialized data are modified
+const unsigned int Data::data_version = 6;  //< *INCREMENT* every time serialized data are modified
 
 Data::Data(size_t data_identifier)
     : _last_rt_data_loaded(boost::posix_time::not_a_date_time),
@@ -80,7 +80,7 @@ Data::Data(size_t data_identifier)
       data_identifier(data_identifier),
       meta(std::make_unique<MetaData>()),
       pt_data(std::make_unique<PT_Data>()),
-      geo_ref(std::make_unique<navitia::georef::GeoRef>()),
+      geo_ref(std::make_shared<navitia::georef::GeoRef>()),
       dataRaptor(std::make_unique<navitia::routing::dataRAPTOR>()),
       fare(std::make_unique<navitia::fare::Fare>()),
       find_admins([&](const GeographicalCoord& c, georef::AdminRtree& admin_tree) {
@@ -94,10 +94,12 @@ Data::Data(size_t data_identifier)
 
 Data::~Data() = default;
 
+// The georef isn't in the archive: save(std::ostream&) writes it in its own section and clone_from() shares it
 template <class Archive>
 void Data::save(Archive& ar, const unsigned int /*unused*/) const {
-    ar& pt_data& geo_ref& meta& fare& last_load_at& loaded& last_load_succeeded& is_connected_to_rabbitmq&
-        is_realtime_loaded;
+    const auto admin_indexes = get_pt_admin_indexes();
+    ar& pt_data& meta& fare& last_load_at& loaded& last_load_succeeded& is_connected_to_rabbitmq& is_realtime_loaded&
+        admin_indexes;
 }
 template <class Archive>
 void Data::load(Archive& ar, const unsigned int version) {
@@ -109,11 +111,55 @@ void Data::load(Archive& ar, const unsigned int version) {
             % version % v;
         throw navitia::data::wrong_version(msg.str());
     }
-    ar& pt_data& geo_ref& meta& fare& last_load_at& loaded& last_load_succeeded& is_connected_to_rabbitmq&
-        is_realtime_loaded;
+    ar& pt_data& meta& fare& last_load_at& loaded& last_load_succeeded& is_connected_to_rabbitmq& is_realtime_loaded&
+        pt_admin_indexes;
 }
 SPLIT_SERIALIZABLE(Data)
 
+std::vector<std::vector<idx_t>> Data::get_pt_admin_indexes() const {
+    // the admins of the stop points, then the ones of the stop areas
+    std::vector<std::vector<idx_t>> admin_indexes;
+    admin_indexes.reserve(pt_data->stop_points.size() + pt_data->stop_areas.size());
+    const auto add_admins = [&](const std::vector<georef::Admin*>& admins) {
+        admin_indexes.emplace_back();
+        for (const auto* admin : admins) {
+            admin_indexes.back().push_back(admin->idx);
+        }
+    };
+    for (const auto* stop_point : pt_data->stop_points) {
+        add_admins(stop_point->admin_list);
+    }
+    for (const auto* stop_area : pt_data->stop_areas) {
+        add_admins(stop_area->admin_list);
+    }
+    return admin_indexes;
+}
+
+void Data::link_pt_admins() {
+    if (pt_admin_indexes.size() != pt_data->stop_points.size() + pt_data->stop_areas.size()) {
+        throw navitia::data::data_loading_error("the admins of the stop points and stop areas don't match them");
+    }
+    auto admin_indexes = pt_admin_indexes.begin();
+    const auto link_admins = [&](std::vector<georef::Admin*>& admins) {
+        admins.clear();
+        for (const auto admin_idx : *admin_indexes++) {
+            admins.push_back(geo_ref->admins.at(admin_idx));
+        }
+    };
+    for (auto* stop_point : pt_data->stop_points) {
+        link_admins(stop_point->admin_list);
+    }
+    for (auto* stop_area : pt_data->stop_areas) {
+        link_admins(stop_area->admin_list);
+    }
+    pt_admin_indexes = {};
+}
+
+void Data::share_geo_ref(const Data& other) {
+    geo_ref = other.geo_ref;
+    geo_ref_shared = true;
+}
+
 /**
  * @brief Load data (in nav.lz4).
  * 1. Uncompress lz4 file
@@ -122,7 +168,7 @@ SPLIT_SERIALIZABLE(Data)
  *
  * @param filename Lz4 data File name (file.nav.lz4)
  */
-void Data::load_nav(const std::string& filename) {
+void Data::load_nav(const std::string& filename, const Data* previous) {
     // Add logger
     log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
     LOG4CPLUS_DEBUG(logger, "Start to load nav");
@@ -135,7 +181,7 @@ void Data::load_nav(const std::string& filename) {
     try {
         std::ifstream ifs(filename.c_str(), std::ios::in | std::ios::binary);
         ifs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        this->load(ifs);
+        this->load(ifs, previous);
         loaded = true;
         last_load_at = pt::microsec_clock::universal_time();
         last_load_succeeded = true;
@@ -152,12 +198,24 @@ void Data::load_nav(const std::string& filename) {
     LOG4CPLUS_DEBUG(logger, "Finished to load nav");
 }
 
-void Data::load(std::istream& ifs) {
+void Data::load(std::istream& ifs, const Data* previous) {
     boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
     in.push(LZ4Decompressor(2048 * 500), 8192 * 500, 8192 * 500);
     in.push(ifs);
-    eos::portable_iarchive ia(in);
-    ia >> *this;
+    {
+        eos::portable_iarchive ia(in);
+        ia >> *this;
+    }
+    // the georef is only read (and decompressed) when it changed
+    if (previous && !meta->georef_version.empty() && meta->georef_version == previous->meta->georef_version) {
+        log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
+        LOG4CPLUS_INFO(logger, "the georef " << meta->georef_version << " didn't change, it is kept");
+        share_geo_ref(*previous);
+    } else {
+        eos::portable_iarchive ia(in);
+        ia >> *geo_ref;
+    }
+    link_pt_admins();
 }
 
 /**
@@ -257,8 +315,13 @@ void Data::save(std::ostream& ofs) const {
     boost::iostreams::filtering_streambuf<boost::iostreams::output> out;
     out.push(LZ4Compressor(2048 * 500), 1024 * 500, 1024 * 500);
     out.push(ofs);
+    {
+        eos::portable_oarchive oa(out);
+        oa << *this;
+    }
+    // the georef is in its own section, after the pt data, so that kraken can skip it when it already has it
     eos::portable_oarchive oa(out);
-    oa << *this;
+    oa << static_cast<const georef::GeoRef&>(*geo_ref);
 }
 
 void Data::build_uri() {
@@ -272,10 +335,25 @@ void Data::build_uri() {
 
 void Data::build_proximity_list() {
     this->pt_data->build_proximity_list();
+    if (geo_ref_shared) {
+        // the projections of the stop points are the only part of the georef depending on the pt data
+        if (geo_ref->has_same_projections(pt_data->stop_points)) {
+            return;
+        }
+        copy_geo_ref();
+    }
     this->geo_ref->build_proximity_list();
     this->geo_ref->project_stop_points(this->pt_data->stop_points);
 }
 
+void Data::build_fallback_cache(size_t max_size) {
+    // a shared georef keeps its cache: the stop points are still projected the same way on it
+    if (geo_ref_shared) {
+        return;
+    }
+    this->geo_ref->init_fallback_cache(max_size);
+}
+
 void Data::build_administrative_regions() {
     auto log = log4cplus::Logger::getInstance("ed::Data");
     georef::AdminRtree admin_tree = georef::build_admins_tree(geo_ref->admins);
@@ -325,7 +403,7 @@ void Data::build_administrative_regions() {
     for (const auto* sa : pt_data->stop_areas) {
         for (auto admin : sa->admin_list) {
             if (!admin->from_original_dataset) {
-                admin->main_stop_areas.push_back(sa);
+                pt_data->admin_main_stop_areas[admin->idx].push_back(sa);
             }
         }
     }
@@ -479,7 +557,7 @@ void Data::aggregate_odt() {
     // we first store the stops in a set not to have duplicates
     for (const auto& p : odt_stops_by_admin) {
         for (const auto& sp : p.second) {
-            p.first->odt_stop_points.push_back(sp);
+            pt_data->admin_odt_stop_points[p.first->idx].push_back(sp);
         }
     }
 }
@@ -831,6 +909,7 @@ struct Pipe {
 // in our object.  To avoid having the whole binary_oarchive in
 // memory, we construct a pipe between 2 threads.
 void Data::clone_from(const Data& from) {
+    share_geo_ref(from);
     Pipe p;
     std::thread write([&]() {
         boost::archive::binary_oarchive oa(p.out);
@@ -841,6 +920,26 @@ void Data::clone_from(const Data& from) {
         ia >> *this;
     }
     write.join();
+    link_pt_admins();
+}
+
+// The georef is copied like clone_from() does for the data
+void Data::copy_geo_ref() {
+    pt_admin_indexes = get_pt_admin_indexes();
+    auto copy = std::make_shared<georef::GeoRef>();
+    Pipe p;
+    std::thread write([&]() {
+        boost::archive::binary_oarchive oa(p.out);
+        oa << static_cast<const georef::GeoRef&>(*geo_ref);
+    });
+    {
+        boost::archive::binary_iarchive ia(p.in);
+        ia >> *copy;
+    }
+    write.join();
+    geo_ref = std::move(copy);
+    geo_ref_shared = false;
+    link_pt_admins();
 }
 
 void Data::set_last_rt_data_loaded(const boost::posix_time::ptime& p) const {
@@ -130,7 +130,10 @@ public:
     // public transport (PT) referential
     std::unique_ptr<PT_Data> pt_data;
 
-    std::unique_ptr<navitia::georef::GeoRef> geo_ref;
+    // The georef is shared with the previous data when it didn't change: by the realtime updates and by the reloads
+    // of a .nav built with the same georef. A shared georef is never modified
+    std::shared_ptr<navitia::georef::GeoRef> geo_ref;
+    bool geo_ref_shared = false;
 
     // precomputed data for raptor (public transport routing algorithm)
     std::unique_ptr<navitia::routing::dataRAPTOR> dataRaptor;
@@ -201,7 +204,8 @@ public:
     BOOST_SERIALIZATION_SPLIT_MEMBER()
 
     // Loading methods
-    void load_nav(const std::string& filename);
+    // the georef of previous is kept if the .nav was built with the same one
+    void load_nav(const std::string& filename, const Data* previous = nullptr);
     void load_disruptions(const std::string& database, const std::vector<std::string>& contributors = {});
     void build_raptor(size_t cache_size = 10);
 
@@ -219,6 +223,8 @@ public:
 
     /** Build ProximityList index */
     void build_proximity_list();
+    /** Create the cache of the street network fallbacks, 0 to disable it */
+    void build_fallback_cache(size_t max_size);
     /** Set admins*/
     void build_administrative_regions();
 
@@ -239,19 +245,30 @@ public:
      *
      * LZ4 compression is super fast but its efficiency is average
      * The goal is to achieve the same read performance with and without compression
+     * The georef is the last section of the file, it is not read when the georef of previous is kept
      */
-    void load(std::istream& ifs);
+    void load(std::istream& ifs, const Data* previous = nullptr);
 
     /** Save data in a compressed binary file using LZ4*/
     void save(std::ostream& ofs) const;
 
-    // Deep clone from the given Data.
+    // Deep clone from the given Data, except the georef which is shared
     void clone_from(const Data&);
 
     void set_last_rt_data_loaded(const boost::posix_time::ptime&) const;
     const boost::posix_time::ptime last_rt_data_loaded() const;
 
 private:
+    // The pt objects and the georef are serialized separately, the admins of the stop points and of the stop areas
+    // are serialized by index and linked to the georef once it's there
+    std::vector<std::vector<idx_t>> pt_admin_indexes;
+    std::vector<std::vector<idx_t>> get_pt_admin_indexes() const;
+    void link_pt_admins();
+
+    void share_geo_ref(const Data& other);
+    // Replace a shared georef by a copy that this data can modify
+    void copy_geo_ref();
+
     /** Get similar validitypattern **/
     ValidityPattern* get_similar_validity_pattern(ValidityPattern* vp) const;
 };
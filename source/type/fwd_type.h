@@ -31,8 +31,6 @@ www.navitia.io
 
 // forward declare
 //
-template <class DATATYPE, class ELEMTYPE, int NUMDIMS, class ELEMTYPEREAL, int TMAXNODES, int TMINNODES>
-class RTree;
 namespace navitia {
 template <typename T>
 struct Rank;
@@ -41,7 +39,7 @@ struct GeoRef;
 struct POI;
 struct POIType;
 struct Admin;
-using AdminRtree = class RTree<Admin*, double, 2, double, 8, 4>;
+class AdminRtree;
 }  // namespace georef
 namespace fare {
 struct Fare;
@@ -54,6 +54,8 @@ struct MetaData {
     boost::posix_time::ptime dataset_created_at;
     std::string poi_source;
     std::string street_network_source;
+    // version of the georef the data was built with, kraken keeps its georef on reload when it doesn't change
+    std::string georef_version;
 
     MetaData() : production_date(boost::gregorian::date(), boost::gregorian::date()) {}
 
@@ -64,7 +66,7 @@ struct MetaData {
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
         ar& production_date& publication_date& shape& publisher_name& publisher_url& license& instance_name&
-            dataset_created_at& poi_source& street_network_source;
+            dataset_created_at& poi_source& street_network_source& georef_version;
     }
     boost::posix_time::time_period production_period() const {
         namespace pt = boost::posix_time;
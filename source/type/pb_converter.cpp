@@ -551,7 +551,7 @@ void PbCreator::Filler::fill_pb_object(const ng::Admin* adm, pbnavitia::Administ
     if (depth > 1) {
         // for the admin we add the main stop area, but with the minimum vital information
         auto minimum_filler = Filler(0, {DumpMessage::No, DumpLineSectionMessage::No}, pb_creator);
-        for (const auto& sa : adm->main_stop_areas) {
+        for (const auto& sa : pb_creator.data->pt_data->get_main_stop_areas(*adm)) {
             auto* pb_sa = admin->add_main_stop_areas();
 
             minimum_filler.fill_pb_object(sa, pb_sa);
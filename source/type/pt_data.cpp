@@ -55,10 +55,23 @@ void PT_Data::serialize(Archive& ar, const unsigned int /*unused*/) {
             ITERATE_NAVITIA_PT_TYPES(SERIALIZE_ELEMENTS)
         & stop_area_autocomplete& stop_point_autocomplete& line_autocomplete& network_autocomplete& mode_autocomplete&
               route_autocomplete& stop_area_proximity_list& stop_point_proximity_list& stop_point_connections&
-                  disruption_holder& meta_vjs& stop_points_by_area& comments& codes& headsign_handler& tz_manager;
+                  disruption_holder& meta_vjs& stop_points_by_area& comments& codes& headsign_handler& tz_manager&
+                      admin_main_stop_areas& admin_odt_stop_points& admin_autocomplete_scores;
 }
 SERIALIZABLE(PT_Data)
 
+const std::vector<const StopArea*>& PT_Data::get_main_stop_areas(const navitia::georef::Admin& admin) const {
+    static const std::vector<const StopArea*> no_stop_area;
+    const auto it = admin_main_stop_areas.find(admin.idx);
+    return it == admin_main_stop_areas.end() ? no_stop_area : it->second;
+}
+
+const std::vector<const StopPoint*>& PT_Data::get_odt_stop_points(const navitia::georef::Admin& admin) const {
+    static const std::vector<const StopPoint*> no_stop_point;
+    const auto it = admin_odt_stop_points.find(admin.idx);
+    return it == admin_odt_stop_points.end() ? no_stop_point : it->second;
+}
+
 size_t PT_Data::nb_stop_times() const {
     size_t nb = 0;
     for (const auto* route : routes) {
@@ -300,12 +313,10 @@ void PT_Data::build_autocomplete(const navitia::georef::GeoRef& georef) {
     this->route_autocomplete.build();
 }
 
-void PT_Data::compute_score_autocomplete(navitia::georef::GeoRef& georef) {
+void PT_Data::compute_score_autocomplete(const navitia::georef::GeoRef& georef) {
     // Compute admin score using stop_point count in each admin
     georef.fl_admin.compute_score((*this), georef, type::Type_e::Admin);
-    // use the score of each admin for it's objects like "POI", "way" and "stop_point"
-    georef.fl_way.compute_score((*this), georef, type::Type_e::Way);
-    georef.fl_poi.compute_score((*this), georef, type::Type_e::POI);
+    // use the score of each admin for it's objects like "stop_point", the ways and the pois get it at lookup
     this->stop_point_autocomplete.compute_score((*this), georef, type::Type_e::StopPoint);
     // Compute stop_area score using it's stop_point count
     this->stop_area_autocomplete.compute_score((*this), georef, type::Type_e::StopArea);
@@ -109,6 +109,17 @@ struct PT_Data : boost::noncopyable {
     // timezone manager
     TimeZoneManager tz_manager;
 
+    // main stop areas of the admins, by admin idx. They are not in the admins so that the georef doesn't point to
+    // pt objects and can be shared between data
+    std::map<idx_t, std::vector<const StopArea*>> admin_main_stop_areas;
+    // TODO ODT NTFSv0.3: remove that when we stop to support NTFSv0.1
+    // zone odt stop points of the admins, by admin idx
+    std::map<idx_t, std::vector<const StopPoint*>> admin_odt_stop_points;
+    // autocomplete scores of the admins of the georef, by idx. They depend on the stop points, so they are computed
+    // for each data instead of being stored in the autocompletes of a georef that can be shared. The scores of the
+    // ways and the pois are the ones of their admin (see autocomplete::admin_list_score)
+    std::map<idx_t, int> admin_autocomplete_scores;
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int);
     /** Construit l'indexe ExternelCode */
@@ -117,12 +128,17 @@ struct PT_Data : boost::noncopyable {
     /** Construit l'indexe Autocomplete */
     void build_autocomplete(const navitia::georef::GeoRef&);
 
-    /** Calcul le score des objectTC */
-    void compute_score_autocomplete(navitia::georef::GeoRef&);
+    /** Calcul le score des objectTC
+     *
+     * The scores of the admins are computed in admin_autocomplete_scores, the georef is not modified
+     */
+    void compute_score_autocomplete(const navitia::georef::GeoRef&);
 
     /** Construit l'indexe ProximityList */
     void build_proximity_list();
     void build_admins_stop_areas();
+    const std::vector<const StopArea*>& get_main_stop_areas(const navitia::georef::Admin& admin) const;
+    const std::vector<const StopPoint*>& get_odt_stop_points(const navitia::georef::Admin& admin) const;
     /// sort the collections and set the corresponding idx field
     void sort_and_index();
 
@@ -41,8 +41,8 @@ namespace type {
 
 template <class Archive>
 void StopArea::serialize(Archive& ar, const unsigned int /*unused*/) {
-    ar& idx& label& uri& name& coord& stop_point_list& admin_list& _properties& wheelchair_boarding& impacts& visible&
-        timezone;
+    // admin_list is serialized by Data, the admins are in the georef section
+    ar& idx& label& uri& name& coord& stop_point_list& _properties& wheelchair_boarding& impacts& visible& timezone;
 }
 SERIALIZABLE(StopArea)
 